@@ -12,6 +12,16 @@ All StateMachines must have a "default" state.  This is their initial state.
 States transition by returning a string of the new State's name.
 States that do not return new state names will stay in the same state.
 
+To look around, ship:Perceive(radius [,limit]) returns everything nearby from
+one search, nearest first:
+	local seen = cur_ship:Perceive(1000)
+	for i=1,seen.hostiles.count do
+		local id, dist = seen.hostiles.id[i], seen.hostiles.distance[i]
+	end
+The categories are hostiles, friendlies, planets and gates.  Each has the
+arrays id, x, y, vx, vy, hull, alliance and distance.  The same tables are
+reused by every call, so copy anything that must be kept.
+
 --]]
 
 AIData = {}
@@ -96,16 +106,12 @@ GateTraveler = {
 		if AIData[id].Autopilot == nil then
 			AIData[id].Autopilot = APInit( "AI", id )
 		end
-		if AIData[id].Autopilot.spcr == nil then
-			AIData[id].Autopilot:compute( AIData[id].destinationName )
-		else
-			local finished = AIData[id].Autopilot.spcrTick()
-			if finished then 
-				return "GateTravelling"
-			else
-				return "ComputingRoute"
-			end
+		if AIData[id].Autopilot:compute( AIData[id].destinationName ) then
+			return "GateTravelling"
 		end
+		AIData[id].destination = -1
+		AIData[id].destinationName = nil
+		return "Travelling" -- There is no route, so travel normally instead
 	end,
 	GateTravelling = function(id,x,y,angle,speed,vector)
 		local cur_ship = Epiar.getSprite(id)
@@ -142,19 +148,17 @@ Hunter = {
 	Hunting = function(id,x,y,angle,speed,vector)
 		-- Approach the target
 		local cur_ship = Epiar.getSprite(id)
-		local tx,ty,dist
 		local target = Epiar.getSprite( AIData[id].target )
-		if target~=nil then
-			tx,ty = target:GetPosition()
-			dist = distfrom(tx,ty,x,y)
-		else
+		if target==nil then
 			AIData[id].hostile = 0
 			return "default"
 		end
 
-		cur_ship:Rotate( cur_ship:directionTowards(tx,ty) )
+		-- Aim where the target will be, not where it is
+		local direction, dist = cur_ship:LeadTarget(target)
+		cur_ship:Rotate( direction )
 
-		if math.abs(cur_ship:directionTowards(tx,ty)) == 0 then
+		if cur_ship:LeadTarget(target) == 0 then
 			cur_ship:Accelerate()
 		end
 
@@ -170,15 +174,11 @@ Hunter = {
 	Killing = function(id,x,y,angle,speed,vector)
 		-- Attack the target
 		local cur_ship = Epiar.getSprite(id)
-		local tx,ty,dist
 		local target = Epiar.getSprite( AIData[id].target )
 		if target==nil or target:GetHull()==0 then
 			--The AI has destroyed the enemy.
 			--HUD.newAlert(string.format("%s #%d:Victory is Mine!",cur_ship:GetModelName(),id))
 			return "default"
-		else
-			tx,ty = target:GetPosition()
-			dist = distfrom(tx,ty,x,y)
 		end
 
 		if AIData[id].hostile == 1 and AIData[id].foundTarget == 0 then
@@ -187,7 +187,8 @@ Hunter = {
 			--HUD.newAlert(string.format("%s %s: Die, %s!", machine, cur_ship:GetModelName(), target:GetName()))
 		end
 
-		cur_ship:Rotate( cur_ship:directionTowards(tx,ty) )
+		local direction, dist = cur_ship:LeadTarget(target)
+		cur_ship:Rotate( direction )
 		local fireResult = cur_ship:FirePrimary( AIData[id].target )
 
 		-- if this firing group isn't doing anything, switch
@@ -196,7 +197,7 @@ Hunter = {
 		end
 		
 		if dist>200 then
-			if cur_ship:directionTowards(tx,ty) == 0 then
+			if cur_ship:LeadTarget(target) == 0 then
 				cur_ship:Accelerate()
 			end
 		end
@@ -75,7 +75,9 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 	local model = choose(models)
 	local engine = choose(engines)
 	local plans = nil
-	if (PLAYER:GetCredits() > 10000) then
+	-- Headless Simulations have no PLAYER
+	local veteran = (PLAYER ~= nil) and (PLAYER:GetCredits() > 10000)
+	if veteran then
 		plans = {"Hunter", "Trader", "Patrol", "Bully" }
 	else
 		plans = {"Trader", "Patrol", "Bully" }
@@ -86,7 +88,7 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 	local p = choose(plans)
 
 	-- Turn some Hunters into anti-player Pirates if the player is far enough along
-	if (PLAYER:GetCredits() > 10000)
+	if veteran
 		and (p == "Hunter")
 		and (math.random(20) == 1)
 	then
@@ -9,13 +9,54 @@
 #include "includes.h"
 #include "Audio/audio.h"
 #include "Audio/sound.h"
+#include "Utilities/loader.h"
 #include "Utilities/log.h"
 #include "Utilities/resource.h"
 
 /**\class Sound
  * \brief This represents a sound object.
+ * \details Sounds are decoded by the Loader in the background.  Playing a
+ *          Sound that is still Loading does nothing.
  */
 
+/**\class SoundLoad
+ * \brief Decodes a Sound file on a loader thread.
+ */
+class SoundLoad : public LoadTask {
+	public:
+		SoundLoad( Sound* _sound, const string& _path ):
+			LoadTask( _sound ),
+			sound( _sound ),
+			path( _path ),
+			chunk( NULL ),
+			error( "" )
+		{
+		}
+
+		void Decode() {
+			chunk = Mix_LoadWAV( path.c_str() );
+			if( chunk == NULL ) {
+				error = Mix_GetError();
+			}
+		}
+
+		bool Finish() {
+			if( chunk == NULL ) {
+				LogMsg(ERR, "Could not load sound file: '%s', Mixer error: %s",
+						sound->GetPath().c_str(), error.c_str() );
+				return false;
+			}
+			sound->sound = chunk;
+			return true;
+		}
+
+	private:
+		Sound* sound;
+		string path;
+		Mix_Chunk* chunk;
+		string error; // Logged by Finish, since Decode may not use the Log
+};
+
 /**\brief Gets the sound or loads it.
  * \param filename Sound file
  */
@@ -39,7 +80,7 @@ Sound *Sound::Get( const string& filename ){
 	return value;
 }
 
-/**\brief Loads the sound based on filename
+/**\brief Starts loading the sound based on filename
  * \param filename Sound file
  */
 Sound::Sound( const string& filename ):
@@ -52,20 +93,18 @@ Sound::Sound( const string& filename ):
 	if( pathName.OpenRead( filename ) == false ) {
 		LogMsg(ERR, "Could not load sound file: '%s'", filename.c_str() );
 		sound = NULL;
+		FinishLoading( false );
 		return;
 	}
 
-	this->sound = Mix_LoadWAV( pathName.GetAbsolutePath().c_str() );
-	if( this->sound == NULL ) {
-		LogMsg(ERR, "Could not load sound file: '%s', Mixer error: %s",
-				filename.c_str(), Mix_GetError() );
-		sound = NULL;
-	}
+	StartLoading( new SoundLoad( this, pathName.GetAbsolutePath() ) );
 }
 
 /**\brief Destructor to free the sound file.
  */
 Sound::~Sound(){
+	Wait();
+
 	// Halts any channel this sound is playing on
 	for ( int i = 0; i < Audio::Instance().GetTotalChannels(); i++ ){
 		if ( Mix_GetChunk( i ) == this->sound)
@@ -157,7 +196,8 @@ bool Sound::PlayNoRestart( Coordinate offset ){
 /**\brief Sets the volume for this sound only (for next time it is played).
  */
 bool Sound::SetVolume( float volume ){
-	if ( this->sound == NULL )
+	// The volume may be set before the Sound is done Loading
+	if ( GetState() == RESOURCE_FAILED )
 		return false;
 
 	this->volume = static_cast<int>( volume * 128.f );
@@ -26,6 +26,8 @@ class Sound : public Resource {
 		string GetPath( void ) { return pathName.GetRelativePath(); }
 
 	private:
+		friend class SoundLoad;
+
 		Mix_Chunk *sound;
 		File pathName;
 		int channel;		/* Last channel the sound is playing on. */
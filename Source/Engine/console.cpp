@@ -141,7 +141,8 @@ void Console::RunCommand() {
 	const char* returnval;
 
 	// Run the Command
-	returnvals = Lua::Run( command, true);
+	// Each line is typed once, so it is not worth keeping compiled.
+	returnvals = Lua::Run( command, true );
 
 	// Save this command
 	InsertResult(string(PROMPT) + command);
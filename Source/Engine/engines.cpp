@@ -99,7 +99,7 @@ bool Engine::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
+		Image* pic = Image::GetAsync( NodeToString(doc,attr) );
 		// This image can be accessed by either the path or the Engine Name
 		Image::Store(name, pic);
 		SetPicture(pic);
@@ -12,11 +12,13 @@
 #include "Engine/simulation.h"
 #include "Graphics/video.h"
 #include "Graphics/font.h"
+#include "Graphics/glstate.h"
 #include "Sprites/player.h"
 #include "Sprites/gate.h"
 #include "Sprites/spritemanager.h"
 #include "UI/ui_map.h"
 #include "Utilities/log.h"
+#include "Utilities/lua.h"
 #include "Utilities/timer.h"
 #include "Engine/camera.h"
 
@@ -305,12 +307,12 @@ void Hud::HandleInput( list<InputEvent> & events, Camera* camera, SpriteManager*
 			{
 				Coordinate screenPos(i->mx, i->my), worldPos;
 				camera->TranslateScreenToWorld( screenPos, worldPos );
-				// Target any clicked Sprite
-				list<Sprite*> *impacts = sprites->GetSpritesNear( worldPos, 5 );
-				if( impacts->size() > 0) {
-					Target( (*(impacts->begin()))->GetID());
+				// Target the closest clicked Sprite
+				vector<Sprite*> impacts;
+				sprites->GetSpritesNear( worldPos, 5, &impacts, DRAW_ORDER_ALL, true, 1 );
+				if( impacts.size() > 0) {
+					Target( impacts[0]->GetID());
 				}
-				delete impacts;
 			}
 		}
 	}
@@ -342,7 +344,7 @@ void Hud::DrawMessages() {
 /**\brief Draw the current framerate (calculated in simulation.cpp).
  */
 void Hud::DrawFPS( float fps, SpriteManager* sprites ) {
-	char frameRate[16];
+	char frameRate[32];
 	BitType->SetColor( WHITE );
 	snprintf(frameRate, sizeof(frameRate), "%f fps", fps );
 	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 15, frameRate );
@@ -352,6 +354,28 @@ void Hud::DrawFPS( float fps, SpriteManager* sprites ) {
 
 	snprintf(frameRate, sizeof(frameRate), "%d Sprites", sprites->GetNumSprites());
 	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 45, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%u Relocated", sprites->GetRelocations());
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 60, frameRate );
+
+	const LuaCollectorStats& gc = Lua::GetCollectorStats();
+	snprintf(frameRate, sizeof(frameRate), "%d KB Lua", gc.memory);
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 75, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%.2f ms GC", gc.time / 1000000.0 );
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 90, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%.2f ms Pause", gc.longestPause / 1000000.0 );
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 105, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%u GL Draws", GLState::GetDraws() );
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 120, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%u GL Changes", GLState::GetChanges() );
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 135, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate), "%u GL Skipped", GLState::GetSkipped() );
+	BitType->Render( Video::GetWidth()-100, Video::GetHeight() - 150, frameRate );
 }
 
 /**\brief Draws the status bar.
@@ -719,8 +743,11 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 		return;
 	}
 
-	list<Sprite*> *spriteList = sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility);
-	for( list<Sprite*>::const_iterator iter = spriteList->begin(); iter != spriteList->end(); iter++)
+	// The radar is drawn every frame, so keep the buffer around.
+	static vector<Sprite*> spriteList;
+	spriteList.clear();
+	sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility, &spriteList);
+	for( vector<Sprite*>::const_iterator iter = spriteList.begin(); iter != spriteList.end(); iter++)
 	{
 		Coordinate blip;
 		Sprite *sprite = *iter;
@@ -751,7 +778,6 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 				Video::DrawPoint( blip, sprite->GetRadarColor() );
 		}
 	}
-	delete spriteList;
 }
 
 /**\brief Gets the radar position based on world coordinate
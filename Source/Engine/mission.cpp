@@ -287,6 +287,7 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 	lua_rawgeti(L, LUA_REGISTRYINDEX, tableReference);
 	
 	// Call the function
+	LuaProfileScope profile( "Mission::RunFunction", type.c_str(), functionName.c_str() );
 	if( lua_pcall(L, 1, LUA_MULTRET, 0) != 0)
 	{
 		LogMsg(ERR,"Failed to run %s.%s: %s\n", type.c_str(), functionName.c_str(), lua_tostring(L, -1));
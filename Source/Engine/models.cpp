@@ -125,7 +125,16 @@ bool Model::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	string value;
 
 	if( (attr = FirstChildNamed(node,"image")) ){
-		image = Image::Get( NodeToString(doc,attr) );
+		// With its size, the image can load in the background without changing the Ship sizes
+		int imageWidth = 0, imageHeight = 0;
+		xmlNodePtr size;
+		if( (size = FirstChildNamed(node,"imageWidth")) ){
+			imageWidth = atoi( NodeToString(doc,size).c_str() );
+		}
+		if( (size = FirstChildNamed(node,"imageHeight")) ){
+			imageHeight = atoi( NodeToString(doc,size).c_str() );
+		}
+		image = Image::GetAsync( NodeToString(doc,attr), imageWidth, imageHeight );
 		Image::Store(name, image);
 		SetPicture(image);
 	} else return false;
@@ -200,6 +209,10 @@ xmlNodePtr Model::ToXMLNode(string componentName) {
 	xmlNewChild(section, NULL, BAD_CAST "name", BAD_CAST this->GetName().c_str() );
 	xmlNewChild(section, NULL, BAD_CAST "description", BAD_CAST this->GetDescription().c_str() );
 	xmlNewChild(section, NULL, BAD_CAST "image", BAD_CAST this->GetImage()->GetPath().c_str() );
+	snprintf(buff, sizeof(buff), "%d", this->GetImage()->GetWidth() );
+	xmlNewChild(section, NULL, BAD_CAST "imageWidth", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", this->GetImage()->GetHeight() );
+	xmlNewChild(section, NULL, BAD_CAST "imageHeight", BAD_CAST buff );
 	xmlNewChild(section, NULL, BAD_CAST "engine", BAD_CAST this->GetDefaultEngine()->GetName().c_str() );
 	snprintf(buff, sizeof(buff), "%1.2f", this->GetMass() );
 	xmlNewChild(section, NULL, BAD_CAST "mass", BAD_CAST buff );
@@ -9,6 +9,7 @@
 #include "includes.h"
 #include "common.h"
 #include "Audio/music.h"
+#include "Audio/sound.h"
 #include "Audio/audio_lua.h"
 #include "Engine/hud.h"
 #include "Engine/simulation.h"
@@ -29,8 +30,10 @@
 #include "Sprites/spritemanager.h"
 #include "UI/ui.h"
 #include "UI/widgets.h"
+#include "Utilities/coordinate_lua.h"
 #include "Utilities/file.h"
 #include "Utilities/log.h"
+#include "Utilities/random.h"
 #include "Utilities/timer.h"
 #include "Utilities/lua.h"
 
@@ -40,9 +43,11 @@
 /**\brief Loads an empty Simulation.
  */
 Simulation::Simulation( void ) {
-	// Start the Lua Universe
+	// Start the Lua Universe, unless another Simulation already has
 	// Register these functions to their own lua namespaces
-	Lua::Init();
+	if( Lua::CurrentState() == NULL ) {
+		Lua::Init();
+	}
 	L = Lua::CurrentState();
 	Simulation_Lua::StoreSimulation(L,this);
 
@@ -69,6 +74,7 @@ Simulation::Simulation( void ) {
 	paused = false;
 	loaded = false;
 	quit = false;
+	headless = false;
 
 	mapScale = -1.0f;
 }
@@ -200,6 +206,8 @@ bool Simulation::SetupToRun(){
 	if( OPTION(int, "options/simulation/random-universe") ) {
 		if( OPTION(int, "options/simulation/random-seed") ) {
 			Lua::Call("createSystems", "i", OPTION(int, "options/simulation/random-seed") );
+		} else if( headless ) {
+			Lua::Call("createSystems", "i", static_cast<int>( Random::GetSeed() ) );
 		} else {
 			Lua::Call("createSystems");
 		}
@@ -218,7 +226,7 @@ bool Simulation::SetupToRun(){
 			for( a = 0; a < 100; a++ ){
 				Effect* asteroid = new Effect( p->GetWorldPosition() + GaussianCoordinate() * p->GetInfluence(), "Resources/Animations/asteroid.ani", 1.0 );
 				asteroid->SetMomentum( GaussianCoordinate() *2 );
-				asteroid->SetAngle( float( rand() %360 ) );
+				asteroid->SetAngle( float( Random::Int(360) ) );
 				sprites->Add( asteroid );
 			}
 #endif
@@ -233,12 +241,18 @@ bool Simulation::SetupToRun(){
 		
 	}
 
-	// Preloading this animation prevents an FPS
-	// drop the first time that a ship explodes.
-	Ani::Get("Resources/Animations/explosion1.ani");
+	// Decode the explosion in the background now to prevent an
+	// FPS drop the first time that a ship explodes.
+	Ani::GetAsync("Resources/Animations/explosion1.ani");
+	if( !headless ) {
+		Sound::Get("Resources/Audio/Effects/18384__inferno__largex.wav.ogg");
+	}
 
 	// Randomize the Lua Seed
-	Lua::Call("randomizeseed");
+	// Headless Simulations must stay on the seed that they were given.
+	if( !headless ) {
+		Lua::Call("randomizeseed");
+	}
 
 	LogMsg(INFO, "Simulation Setup Complete");
 
@@ -306,10 +320,15 @@ bool Simulation::Run() {
 	if(bgmusic && OPTION(int, "options/sound/background"))
 		bgmusic->Play();
 
+	// Collect Lua's garbage between frames
+	Lua::PaceCollector( OPTION(int, "options/lua/gc-paced") != 0 );
+	const Uint64 frameLength = 1000000000 / max( 1, OPTION(int, "options/video/fps") );
+
 	// main game loop
 	bool lowFps = false;
 	int lowFpsFrameCount = 0;
 	while( !quit ) {
+		Uint64 frameStart = Timer::GetNanoseconds();
 		HandleInput();
 
 		//_ASSERTE(_CrtCheckMemory());
@@ -354,6 +373,10 @@ bool Simulation::Run() {
 		Video::PostDraw();
 		Video::Update();
 
+		// Spend the rest of the frame collecting garbage
+		Uint64 frameUsed = Timer::GetNanoseconds() - frameStart;
+		Lua::StepCollector( (frameUsed < frameLength) ? (frameLength - frameUsed) : 0 );
+
 		// Don't kill the CPU (play nice)
 		if( paused ) {
 			Timer::Delay(50);
@@ -432,6 +455,7 @@ bool Simulation::Run() {
 		}
 	}
 	
+	Lua::PaceCollector( false );
 	Hud::Close();
 
 	LogMsg(INFO,"Simulation Stopped: Average Framerate: %f Frames/Second", 1000.0 *((float)fpsTotal / Timer::GetTicks() ) );
@@ -439,6 +463,34 @@ bool Simulation::Run() {
 	return (player->GetHullIntegrityPct() > 0);
 }
 
+/**\brief Game loop for a headless Simulation
+ * \details There is no Player, and nothing is drawn, played or read from the
+ *          keyboard.  Each tick moves the virtual clock forward by exactly one
+ *          logical frame, so that the same seed always gives the same result.
+ * \param ticks The number of logical frames to run.
+ * \return The state hash of the Sprites after the last tick.
+ * \see Timer::UseVirtualClock, SpriteManager::GetStateHash
+ */
+Uint32 Simulation::RunHeadless( Uint32 ticks ) {
+	const Uint32 ticksPerFrame = static_cast<Uint32>( 1000 / LOGIC_FPS );
+
+	LogMsg(INFO, "Headless Simulation Started for %u ticks", ticks );
+
+	for( Uint32 tick = 0; tick < ticks; ++tick ) {
+		Timer::AdvanceVirtualClock( ticksPerFrame );
+		Timer::Update();
+		Timer::IncrementFrameCount();
+		sprites->Update( L, false );
+		calendar->Update();
+	}
+
+	Uint32 stateHash = sprites->GetStateHash();
+
+	LogMsg(INFO, "Headless Simulation Stopped with %d Sprites", sprites->GetNumSprites() );
+
+	return stateHash;
+}
+
 bool Simulation::SetupToEdit() {
 	bool luaLoad = true;
 
@@ -528,6 +580,7 @@ void Simulation::LuaRegisters(lua_State *L) {
 	UI_Lua::RegisterUI(L);
 	Audio_Lua::RegisterAudio(L);
 	Planets_Lua::RegisterPlanets(L);
+	Coordinate_Lua::RegisterCoordinate(L);
 	Hud::RegisterHud(L);
 	Video::RegisterVideo(L);
 }
@@ -673,7 +726,7 @@ void Simulation::HandleInput() {
 	{
 		list<string>* names = planets->GetNames();
 		int i = 0;
-		int x = rand() % names->size();
+		int x = Random::Int( names->size() );
 		list<string>::iterator pName = names->begin();
 		while( i++ < x ){ pName++; }
 		Planet* p = planets->GetPlanet(*pName);
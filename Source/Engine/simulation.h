@@ -35,6 +35,7 @@ class Simulation : public XMLFile {
 		bool SetupToEdit();
 
 		bool Run();
+		Uint32 RunHeadless( Uint32 ticks );
 		bool Edit();
 
 		void CreateDefaultPlayer(string name);
@@ -75,6 +76,7 @@ class Simulation : public XMLFile {
 		void SetMapScale( float scale ) { mapScale = scale; }
 
 		void SetQuit( bool val ) { quit = val; }
+		void SetHeadless( bool val ) { headless = val; }
 
 	private:
 		bool Parse( void );
@@ -112,6 +114,7 @@ class Simulation : public XMLFile {
 		bool paused;
 		bool loaded;
 		bool quit;
+		bool headless; ///< Run without Video, Audio, UI or a Player.
 		float mapScale;
 };
 
@@ -30,6 +30,7 @@
 #include "Sprites/planets.h"
 #include "Sprites/planets_lua.h"
 #include "Sprites/gate.h"
+#include "Sprites/gateroutes.h"
 #include "Engine/camera.h"
 #include "Input/input.h"
 #include "Utilities/file.h"
@@ -41,6 +42,10 @@
  *  \brief Lua bridge for interacting with the Epiar engine.
  */
 
+int Simulation_Lua::spriteCache = LUA_NOREF;
+int Simulation_Lua::shipMetatable = LUA_NOREF;
+int Simulation_Lua::planetMetatable = LUA_NOREF;
+
 void Simulation_Lua::RegisterSimulation(lua_State *L) {
 	Lua::RegisterGlobal("WIDTH", Video::GetWidth() );
 	Lua::RegisterGlobal("HEIGHT", Video::GetHeight() );
@@ -104,6 +109,7 @@ void Simulation_Lua::RegisterSimulation(lua_State *L) {
 		{"gates", &Simulation_Lua::GetGates},
 		{"nearestShip", &Simulation_Lua::GetNearestShip},
 		{"nearestPlanet", &Simulation_Lua::GetNearestPlanet},
+		{"gateRoute", &Simulation_Lua::GetGateRoute},
 
 		// Keyboard Command Functions
 		{"RegisterKey", &Simulation_Lua::RegisterKey},
@@ -130,6 +136,20 @@ void Simulation_Lua::RegisterSimulation(lua_State *L) {
 	};
 	luaL_register(L,"Epiar",EngineFunctions);
 
+	// The userdata of each Sprite is kept for as long as Lua holds it.
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushstring(L, "v");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	spriteCache = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	// The metatables are looked up when they are first needed.
+	shipMetatable = LUA_NOREF;
+	planetMetatable = LUA_NOREF;
+
+	// The routes belong to the previous Simulation's Gates.
+	GateRoutes::Reset();
 }
 
 /** \brief Register functions specific to the editor
@@ -373,6 +393,7 @@ int Simulation_Lua::NewGatePair(lua_State *L){
 
 	GetSimulation(L)->GetGates()->Add( gate_1 );
 	GetSimulation(L)->GetGates()->Add( gate_2 );
+	GateRoutes::AddGatePair( gate_1, gate_2 );
 
 	return 0;
 }
@@ -533,28 +554,63 @@ int Simulation_Lua::GetGateNames(lua_State *L){
 }
 
 /** \brief Pushes a Sprite reference onto the Lua Stack.
- *  \note Sprites are referenced by their ID.
+ *  \note Sprites are referenced by their ID, so a reference to a deleted
+ *        Sprite is never mistaken for a newer Sprite.
+ *  \details Each Sprite has one userdata, which is reused for as long as
+ *           Lua holds on to it.  The cache has weak values, so the userdata is
+ *           still collected once Lua drops it.
  */
 void Simulation_Lua::PushSprite(lua_State *L,Sprite* s){
-	int* id = (int*)lua_newuserdata(L, sizeof(int*));
-	*id = s->GetID();
+	SpriteHandle handle = s->GetID();
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, spriteCache);
+	lua_rawgeti(L, -1, handle);
+	if( !lua_isnil(L, -1) ) {
+		lua_remove(L, -2); // Pop the cache
+		return;
+	}
+	lua_pop(L, 1);
+
+	SpriteHandle* id = (SpriteHandle*)lua_newuserdata(L, sizeof(SpriteHandle));
+	*id = handle;
 	switch(s->GetDrawOrder()){
 	case DRAW_ORDER_SHIP:
 	case DRAW_ORDER_PLAYER:
-		luaL_getmetatable(L, EPIAR_SHIP);
+		PushMetatable(L, EPIAR_SHIP, &shipMetatable);
 		lua_setmetatable(L, -2);
 		break;
 	case DRAW_ORDER_PLANET:
-		luaL_getmetatable(L, EPIAR_PLANET);
+		PushMetatable(L, EPIAR_PLANET, &planetMetatable);
 		lua_setmetatable(L, -2);
 		break;
 	default:
 		LogMsg(ERR,"Accidentally pushing sprite #%d with invalid kind: %d",s->GetID(),s->GetDrawOrder());
 		//assert(s->GetDrawOrder() & (DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET) );
-		luaL_getmetatable(L, EPIAR_SHIP);
+		PushMetatable(L, EPIAR_SHIP, &shipMetatable);
 		lua_setmetatable(L, -2);
 		assert( 0 );
 	}
+
+	// cache[handle] = userdata
+	lua_pushvalue(L, -1);
+	lua_rawseti(L, -3, handle);
+	lua_remove(L, -2); // Pop the cache
+}
+
+/** \brief Pushes a metatable, remembering it in the registry by reference.
+ *  \param [in,out] ref The reference, or LUA_NOREF if it hasn't been looked up yet.
+ *  \details Pushes nil if the metatable hasn't been registered yet.
+ */
+void Simulation_Lua::PushMetatable(lua_State *L, const char* name, int *ref){
+	if( *ref != LUA_NOREF ) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, *ref);
+		return;
+	}
+	luaL_getmetatable(L, name);
+	if( !lua_isnil(L, -1) ) {
+		lua_pushvalue(L, -1);
+		*ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
 }
 
 /** \brief Push a list of names for a component list.
@@ -582,7 +638,7 @@ int Simulation_Lua::GetSpriteByID(lua_State *L){
 		return luaL_error(L, "Got %d arguments expected 1 (SpriteID)", n);
 
 	// Get the Sprite using the ID
-	int id = (int)(luaL_checkint(L,1));
+	SpriteHandle id = (SpriteHandle)(luaL_checkint(L,1));
 	Sprite* sprite = GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id);
 
 	// Return nil if the sprite no longer exists
@@ -601,29 +657,32 @@ int Simulation_Lua::GetSpriteByID(lua_State *L){
 int Simulation_Lua::GetSprites(lua_State *L, int kind){
 	int n = lua_gettop(L);  // Number of arguments
 
-	list<Sprite *> *sprites = NULL;
+	// Scripts expect the nearby Sprites ordered by distance.
+	static vector<Sprite *> sprites;
+	sprites.clear();
 	if( n==3 ){
 		double x = luaL_checknumber (L, 1);
 		double y = luaL_checknumber (L, 2);
 		double r = luaL_checknumber (L, 3);
-		sprites = GetSimulation(L)->GetSpriteManager()->GetSpritesNear(Coordinate(x,y),static_cast<float>(r),kind);
+		GetSimulation(L)->GetSpriteManager()->GetSpritesNear(Coordinate(x,y),static_cast<float>(r),&sprites,kind,true);
 	} else {
-		sprites = GetSimulation(L)->GetSpriteManager()->GetSprites(kind);
+		list<Sprite *> *all = GetSimulation(L)->GetSpriteManager()->GetSprites(kind);
+		sprites.assign( all->begin(), all->end() );
+		delete all;
 	}
 
 	// Populate a Lua table with Sprites
-	lua_createtable(L, sprites->size(), 0);
+	lua_createtable(L, sprites.size(), 0);
 	int newTable = lua_gettop(L);
 	int index = 1;
-	list<Sprite *>::const_iterator iter = sprites->begin();
-	while(iter != sprites->end()) {
+	vector<Sprite *>::const_iterator iter = sprites.begin();
+	while(iter != sprites.end()) {
 		// push userdata
 		PushSprite(L,(*iter));
 		lua_rawseti(L, newTable, index);
 		++iter;
 		++index;
 	}
-	delete sprites;
 	return 1;
 }
 
@@ -764,6 +823,36 @@ int Simulation_Lua::GetNearestPlanet(lua_State *L) {
 	return Simulation_Lua::GetNearestSprite(L,DRAW_ORDER_PLANET);
 }
 
+/** \brief Get the shortest route through the Gates to a Planet or Gate
+ * \details
+ * This takes 3 lua arguments:
+ *  - X, Y: where the route starts.
+ *  - A Name: the Planet or Gate at the end of the route.
+ *  \returns A list of the names of the Gates and Planets to fly to, ending
+ *           with the destination, or nil if there is no such destination.
+ *  \see GateRoutes::GetRoute
+ */
+int Simulation_Lua::GetGateRoute(lua_State *L) {
+	int n = lua_gettop(L);  // Number of arguments
+	if( n!=3 )
+		return luaL_error(L, "Got %d arguments expected 3 (x, y, destinationName)", n);
+	Coordinate from( luaL_checknumber(L,1), luaL_checknumber(L,2) );
+	string destination = luaL_checkstring(L,3);
+
+	static vector<string> route; // Reusable buffer for the route.
+	if( !GateRoutes::GetRoute( GetSimulation(L)->GetGates(), GetSimulation(L)->GetPlanets(), from, destination, &route ) ) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_createtable(L, route.size(), 0);
+	for( unsigned int i = 0; i < route.size(); ++i ) {
+		lua_pushstring(L, route[i].c_str());
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
 /** \brief Get Information about the Simulation
  *  \returns Lua table of Information
  */
@@ -913,8 +1002,8 @@ int Simulation_Lua::GetPlanetInfo(lua_State *L) {
 	Planet* p = NULL;
 	if( lua_isnumber(L,1)){
 		int id = luaL_checkinteger(L,1);
-		Sprite* sprite = GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id);
-		if( sprite->GetDrawOrder() != DRAW_ORDER_PLANET)
+		Sprite* sprite = GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id, DRAW_ORDER_PLANET);
+		if( sprite == NULL )
 			return luaL_error(L, "ID #%d does not point to a Planet", id);
 		p = (Planet*)(sprite);
 	} else if( lua_isstring(L,1)){
@@ -961,8 +1050,8 @@ int Simulation_Lua::GetGateInfo(lua_State *L) {
 	Gate* g = NULL;
 	if( lua_isnumber(L,1)){
 		int id = luaL_checkinteger(L,1);
-		Sprite* sprite = GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id);
-		if( ! (sprite->GetDrawOrder() & (DRAW_ORDER_GATE_TOP|DRAW_ORDER_GATE_BOTTOM)) )
+		Sprite* sprite = GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id, DRAW_ORDER_GATE_TOP|DRAW_ORDER_GATE_BOTTOM);
+		if( sprite == NULL )
 			return luaL_error(L, "ID #%d does not point to a Gate", id);
 		g = (Gate*)(sprite);
 	} else if( lua_isstring(L,1)){
@@ -58,6 +58,7 @@ class Simulation_Lua{
 		static int GetShips(lua_State *L);
 		static int GetPlanets(lua_State *L);
 		static int GetGates(lua_State *L);
+		static int GetGateRoute(lua_State *L);
 
 		// Game Components
 		static int GetCommodityNames(lua_State *L);
@@ -96,6 +97,11 @@ class Simulation_Lua{
 		static void PushSprite(lua_State *L,Sprite* sprite);
 		static void PushComponents(lua_State *L, list<Component*> *components);
 	private:
+		static void PushMetatable(lua_State *L, const char* name, int *ref);
+
+		static int spriteCache;      ///< Registry reference to the userdata of each Sprite, by ID.
+		static int shipMetatable;    ///< Registry reference to the EPIAR_SHIP metatable.
+		static int planetMetatable;  ///< Registry reference to the EPIAR_PLANET metatable.
 };
 
 #endif // __H_SIMULATION_LUA__
@@ -1,44 +1,74 @@
 /**\file			starfield.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified : Saturday, January 5, 2008
+ * \date			Modified : Saturday, October 17, 2026
  * \brief
  * \details
  */
 
 #include "includes.h"
 #include "Engine/starfield.h"
+#include "Graphics/glstate.h"
+#include "Graphics/spritebatch.h"
 #include "Graphics/video.h"
 #include "Engine/camera.h"
+#include "Utilities/options.h"
 
 /**\class Starfield
- * \brief Controls the starfield. */
-
-/**\struct Starfield::_stars
- * \brief Contains x,y coordinate as well as the color
+ * \brief Controls the starfield.
+ *
+ * The stars are split into layers by brightness, and brighter layers scroll
+ * faster, as if they were closer.  Rather than moving every star, each layer
+ * keeps how far it has scrolled, and the stars are placed relative to that
+ * when they are drawn.  Every star is written into one array of points in a
+ * single pass, and the whole field is drawn with one call.
+ *
+ * The number of layers is set by "options/simulation/starfield-layers".
  */
 
 /**\brief Initializes the starfield.
  * \param num Number of stars to initialize
  */
 Starfield::Starfield( int num ) {
-	int i;
-	
+	int layers = OPTION( int, "options/simulation/starfield-layers" );
+	if( layers < 1 ) {
+		layers = 1;
+	}
+
 	// seed the random number generator
 	srand(static_cast<unsigned int>( time(NULL) ));
 
-	// allocate space for stars
-	stars = (struct _stars *)malloc( sizeof(struct _stars) * num );
-
-	// randomly assign position and color
-	for( i = 0; i < num; i++ ) {
-		int c;
+	w = static_cast<float>(1.3 * Video::GetWidth());
+	h = static_cast<float>(1.4 * Video::GetHeight());
 
-		stars[i].x = (float)(rand() % (int)(1.3 * Video::GetWidth()));
-		stars[i].y = (float)(rand() % (int)(1.4 * Video::GetHeight()));
-		c = rand() % 225; // generate greys between 0 and 225
-		stars[i].clr = static_cast<float>( c / 256. );
+	x.resize( num );
+	y.resize( num );
+	brightness.resize( num );
+	layerStart.resize( layers + 1 );
+	layerDepth.resize( layers );
+	layerX.assign( layers, 0. );
+	layerY.assign( layers, 0. );
+	vertices.resize( num * 4 );
+
+	// randomly assign position and color, giving each layer an even share of the greys
+	int i = 0;
+	for( int l = 0; l < layers; l++ ) {
+		int low = 225 * l / layers;
+		int high = 225 * (l + 1) / layers;
+		int count = num * (l + 1) / layers - num * l / layers;
+
+		layerStart[l] = i;
+		layerDepth[l] = static_cast<float>( (low + high) / 2. / 256. );
+		for( ; count > 0; --count, ++i ) {
+			int c;
+
+			x[i] = (float)(rand() % (int)w);
+			y[i] = (float)(rand() % (int)h);
+			c = low + rand() % (high - low > 0 ? high - low : 1); // generate greys between 0 and 225
+			brightness[i] = static_cast<float>( c / 256. );
+		}
 	}
+	layerStart[layers] = num;
 
 	this->num = num;
 }
@@ -46,84 +76,76 @@ Starfield::Starfield( int num ) {
 /**\brief Destroys Starfield
  */
 Starfield::~Starfield( void ) {
-	free( stars );
 }
 
 /**\brief Draws the Starfield
+ * \details Each star is spread over the 2x2 pixels nearest it, so that it
+ *          moves smoothly.
  */
 void Starfield::Draw( void ) {
-	int i;
+	if( num <= 0 ) {
+		return;
+	}
 
-	for( i = 0; i < num; i++ ) {
-		drawStar(stars[i].x, stars[i].y, stars[i].clr);
+	Vertex *v = &vertices[0];
+	for( unsigned int l = 0; l < layerDepth.size(); l++ ) {
+		float ox = static_cast<float>( layerX[l] );
+		float oy = static_cast<float>( layerY[l] );
+		for( int i = layerStart[l]; i < layerStart[l+1]; i++ ) {
+			// Both the star and the scroll are within w and h, so one wrap is enough
+			float sx = x[i] - ox;
+			float sy = y[i] - oy;
+			sx += (sx < 0.f) ? w : 0.f;
+			sy += (sy < 0.f) ? h : 0.f;
+
+			int px = (int)sx;
+			int py = (int)sy;
+			float fx = (sx - px) * .5f;
+			float fy = (sy - py) * .5f;
+
+			// The brightness of each pixel is the sum of its x and y components
+			GLubyte near_x_near_y = static_cast<GLubyte>( (fx + fy) * brightness[i] * 255.f );
+			GLubyte far_x_near_y = static_cast<GLubyte>( (.5f - fx + fy) * brightness[i] * 255.f );
+			GLubyte near_x_far_y = static_cast<GLubyte>( (fx + .5f - fy) * brightness[i] * 255.f );
+			GLubyte far_x_far_y = static_cast<GLubyte>( (1.f - fx - fy) * brightness[i] * 255.f );
+
+			v[0].x = px + .5f;      v[0].y = py + .5f;
+			v[0].r = v[0].g = v[0].b = near_x_near_y;
+			v[1].x = px - .5f;      v[1].y = py + .5f;
+			v[1].r = v[1].g = v[1].b = far_x_near_y;
+			v[2].x = px + .5f;      v[2].y = py - .5f;
+			v[2].r = v[2].g = v[2].b = near_x_far_y;
+			v[3].x = px - .5f;      v[3].y = py - .5f;
+			v[3].r = v[3].g = v[3].b = far_x_far_y;
+			v[0].a = v[1].a = v[2].a = v[3].a = 255;
+			v += 4;
+		}
 	}
+
+	SpriteBatch::Flush();
+	GLState::Disable(GL_TEXTURE_2D);
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glVertexPointer( 2, GL_FLOAT, sizeof(Vertex), &vertices[0].x );
+	glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices[0].r );
+	glDrawArrays( GL_POINTS, 0, num * 4 );
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+	GLState::ForgetColor();
+	GLState::CountDraw();
 }
 
 /**\brief Updates the Starfield
  */
 void Starfield::Update( Camera *camera ) {
-	int i;
 	double dx, dy;
-	float w, h;
 
 	camera->GetDelta( &dx, &dy );
-	
-	w = static_cast<float>(1.3 * Video::GetWidth());
-	h = static_cast<float>(1.4 * Video::GetHeight());
-	
-	for( i = 0; i < num; i++ ) {
-		stars[i].x -= (float)dx * stars[i].clr;
-		stars[i].y -= (float)dy * stars[i].clr;
-
-		// handle wrapping the stars around if they go offscreen top/left
-		while( stars[i].x < 0.0f )
-			stars[i].x += w;
-		while( stars[i].y < 0.0f )
-			stars[i].y += h;
-
-		// handle wrapping the stars around if they go offscreen bottom/right
-		while( stars[i].x > w )
-			stars[i].x -= w;
-		while( stars[i].y > h )
-			stars[i].y -= h;
-	}
-}
 
-/**\brief Draws the stars
- */
-void Starfield::drawStar(float x, float y, float  brightness) 
-{	
-	float drawBrightness;  
-	float xcomponent; 
-	float ycomponent; 
-
-	//Loop between both X columns 
-	for (int xcnt = 0; xcnt <= 1; xcnt++) 
-	{ 
-		//Check for clipping in the X direction (make sure it fits horizontally) 
-		if (((int)x - xcnt)>= 0 && ((int)y - xcnt) < Video::GetWidth()) 
-		{ 
-			//Loop between both Y rows 
-			for (int ycnt = 0; ycnt <= 1; ycnt++) 
-			{ 
-				//Check for clipping in the Y direction (make sure it fits vertically) 
-				if ((int)y - ycnt >= 0 && (int)y - ycnt < Video::GetHeight()) 
-				{ 
-					//Get the x component of the brightness and divide it by 2 
-					xcomponent = (((float)(xcnt - (x - (int)x)) * .5f)); 
-					
-					//Get the y component of the brightness and divide it by 2 
-					ycomponent = (((float)(ycnt - (y - (int)y)) * .5f)); 
-
-					if (ycomponent<0) ycomponent=ycomponent*(-1);
-					if (xcomponent<0) xcomponent=xcomponent*(-1);
-					
-					//Add the x anid y components of the brightness to get the total brightness at that particular location 
-					drawBrightness = ((xcomponent + ycomponent) * brightness); 
-
-					Video::DrawPoint((int)x - xcnt, (int)y - ycnt, drawBrightness, drawBrightness, drawBrightness); 
-				} 
-			} 
-		} 
-	} 
+	for( unsigned int l = 0; l < layerDepth.size(); l++ ) {
+		layerX[l] = fmod( layerX[l] + dx * layerDepth[l], (double)w );
+		layerY[l] = fmod( layerY[l] + dy * layerDepth[l], (double)h );
+		if( layerX[l] < 0. ) layerX[l] += w;
+		if( layerY[l] < 0. ) layerY[l] += h;
+	}
 }
@@ -1,11 +1,12 @@
 /**\file			starfield.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified : Saturday, January 5, 2008
+ * \date			Modified : Saturday, October 17, 2026
  * \brief
  * \details
  */
 
+#include "includes.h"
 #include "Engine/camera.h"
 
 #ifndef __h_starfield__
@@ -18,16 +19,27 @@ class Starfield {
 
 		void Draw( void );
 		void Update( Camera *camera );
-		void drawStar( float x, float y, float brightness);
 
 	private:
-		struct _stars {
-			float x, y;
-			float clr;
-		} *stars;
+		/// One pixel of a star.
+		struct Vertex {
+			GLfloat x, y;
+			GLubyte r, g, b, a;
+		};
 
 		int num; // number of stars
+		float w, h; // size of the area that the stars wrap around in
+
+		// The stars never move within their layer, so they are set once.
+		vector<float> x, y;
+		vector<float> brightness;
+
+		// Each layer scrolls by its own depth.  The stars are sorted by layer.
+		vector<int> layerStart;   ///< The first star of each layer, and then num.
+		vector<float> layerDepth; ///< How far the layer scrolls as the camera moves.
+		vector<double> layerX, layerY; ///< How far the layer has scrolled, within w and h.
+
+		vector<Vertex> vertices; ///< Four pixels for every star.
 };
 
 #endif // __h_starfield__
-
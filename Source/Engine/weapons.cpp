@@ -137,7 +137,7 @@ bool Weapon::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	}
 
 	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
+		Image* pic = Image::GetAsync( NodeToString(doc,attr) );
 		// This image can be accessed by either the path or the Weapon Name
 		Image::Store(name, pic);
 		SetPicture(pic);
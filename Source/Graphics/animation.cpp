@@ -9,8 +9,10 @@
 #include "includes.h"
 #include "Graphics/animation.h"
 #include "Utilities/file.h"
+#include "Utilities/loader.h"
 #include "Utilities/log.h"
 #include "Utilities/resource.h"
+#include "Utilities/timer.h"
 
 
 #define ANI_VERSION 1
@@ -41,6 +43,146 @@
  *  \see Animation
  */
 
+/**\class AniLoad
+ * \brief Decodes the frames of an Ani file.
+ * \details This is done on a loader thread for Ani::GetAsync.  The file is
+ *          opened right away and closed by the destructor, so that both
+ *          happen on the main thread.
+ */
+class AniLoad : public LoadTask {
+	public:
+		AniLoad( Ani* _ani, const string& filename ):
+			LoadTask( _ani ),
+			ani( _ani ),
+			file( filename ),
+			delay( 0 ),
+			error( "" )
+		{
+		}
+
+		~AniLoad() {
+			for( unsigned int i = 0; i < surfaces.size(); i++ ) {
+				SDL_FreeSurface( surfaces[i] );
+			}
+		}
+
+		void Decode();
+		bool Finish();
+		int GetUploadSize();
+
+	private:
+		Ani* ani;
+		File file;
+		vector<SDL_Surface*> surfaces;
+		Uint32 delay;
+		string error; // Logged by Finish, since Decode may not use the Log
+};
+
+/**\brief Reads the frames of the Ani file and decodes them into surfaces.
+ * \details The whole file is read into memory first, since the File methods
+ *          that seek around in it use the Log.
+ */
+void AniLoad::Decode() {
+	char *buffer = file.Read( &error );
+	if( buffer == NULL ) {
+		return;
+	}
+	long length = file.GetLength();
+
+	if( length < 3 ) {
+		error = "Ani file is too short";
+		delete [] buffer;
+		return;
+	}
+
+	if( buffer[0] != ANI_VERSION ) {
+		error = "Incorrect ani version";
+		delete [] buffer;
+		return;
+	}
+
+	if( buffer[1] <= 0 ) {
+		error = "Cannot have zero or less frames";
+		delete [] buffer;
+		return;
+	}
+	int numFrames = buffer[1];
+
+	if( buffer[2] <= 0 ) {
+		error = "Cannot have zero or less for a delay";
+		delete [] buffer;
+		return;
+	}
+	delay = buffer[2];
+
+	long pos = 3;
+	for( int i = 0; i < numFrames; i++ ) {
+		int fs;
+
+		if( pos + static_cast<long>(sizeof(int)) > length ) {
+			error = "Ani file is missing an animation frame";
+			break;
+		}
+		memcpy( &fs, buffer + pos, sizeof(int) );
+		pos += sizeof(int);
+
+		// Big Endian Machines need to swap the bytes here.
+		if( IsBigEndian() ) {
+			fs = SDL_SwapLE32(fs);
+		}
+
+		if( fs <= 0 || pos + fs > length ) {
+			error = "Ani file is missing an animation frame";
+			break;
+		}
+
+		// On OS X 10.6 with SDL_image 1.2.8, the load from fp is broken, so SDL_image decodes
+		// each frame from our buffer instead.
+		SDL_Surface *s = Image::Decode( buffer + pos, fs );
+		if( s == NULL ) {
+			error = "Could not load an animation frame";
+			break;
+		}
+		surfaces.push_back( s );
+
+		pos += fs;
+	}
+
+	delete [] buffer;
+}
+
+/**\brief Turns the decoded surfaces into the frames of the Ani.
+ */
+bool AniLoad::Finish() {
+	if( error != "" ) {
+		LogMsg(ERR, "%s", error.c_str() );
+		return( false );
+	}
+
+	ani->numFrames = surfaces.size();
+	ani->delay = delay;
+	ani->frames = new Image[ surfaces.size() ];
+	for( unsigned int i = 0; i < surfaces.size(); i++ ) {
+		ani->frames[i].Load( surfaces[i] ); // This frees the surface
+	}
+	surfaces.clear();
+
+	ani->w = ani->frames[0].GetWidth();
+	ani->h = ani->frames[0].GetHeight();
+
+	return( true );
+}
+
+/**\brief The bytes of every frame.
+ */
+int AniLoad::GetUploadSize() {
+	int size = 0;
+	for( unsigned int i = 0; i < surfaces.size(); i++ ) {
+		size += surfaces[i]->w * surfaces[i]->h * 4;
+	}
+	return size;
+}
+
 /**\brief Gets the resource object.
  * \param filename string containing the animation
  */
@@ -50,6 +192,25 @@ Ani* Ani::Get( string filename ) {
 	if( value == NULL ) {
 		value = new Ani(filename);
 		Resource::Store(filename,(Resource*)value);
+	} else {
+		// It may have been requested with GetAsync
+		value->Wait();
+	}
+	return value;
+}
+
+/**\brief Gets the resource object, decoding it in the background if it isn't loaded yet.
+ * \param filename string containing the animation
+ * \details The Ani has no frames until it is Ready.
+ */
+Ani* Ani::GetAsync( string filename ) {
+	Ani* value;
+	value = (Ani*)Resource::Get(filename);
+	if( value == NULL ) {
+		LogMsg(INFO, "Loading animation '%s' in the background", filename.c_str() );
+		value = new Ani();
+		Resource::Store(filename,(Resource*)value);
+		value->StartLoading( new AniLoad( value, filename ) );
 	}
 	return value;
 }
@@ -80,71 +241,13 @@ Ani::Ani( string& filename ) {
  * \param filename File name of the animation
  */
 bool Ani::Load( string& filename ) {
-	char byte;
-	const char *cName = filename.c_str();
-	File file = File( cName );
+	LogMsg(INFO, "Loading animation '%s'", filename.c_str() );
 
-	LogMsg(INFO, "Loading animation '%s'", cName );
-
-	file.Read( 1, &byte );
-	if( byte != ANI_VERSION ) {
-		LogMsg(ERR, "Incorrect ani version" );
-		return( false );
-	}
-
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
-		LogMsg(ERR, "Cannot have zero or less frames" );
-		return( false );
-	}
-	numFrames = byte;
-	// Allocate space for frames
-	frames = new Image[byte];
-
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
-		LogMsg(ERR, "Cannot have zero or less for a delay" );
-		delete [] frames;
-		frames = NULL;
-		return( false );
-	}
-	delay = byte;
-
-	for( int i = 0; i < numFrames; i++ ) {
-		long pos;
-		int fs;
-
-		file.Read( sizeof(int), (char *) &fs );
-
-		// Big Endian Machines need to swap the bytes here.
-		if( IsBigEndian() ) {
-			LogMsg(ERR, "Swapping Bytes for Endianness");
-			fs = SDL_SwapLE32(fs);
-		}
-
-		pos = file.Tell();
-
-		// On OS X 10.6 with SDL_image 1.2.8, the load from fp is broken, so we load it into a buffer ourselves and SDL_image
-		// loads from that correctly. It's an extra step on our part, but performance/functionally they're identical. Hopefully
-		// this gets fixed in a future SDL_image
-		char *buf = new char [fs];
-		file.Read( fs, buf );
-
-		//frames[i].Load( fp, (int)fs );
-		frames[i].Load( buf, fs );
-
-		delete [] buf;
-		buf = NULL;
-
-		file.Seek( pos + fs );
-	}
-
-	w = frames[0].GetWidth();
-	h = frames[0].GetHeight();
-
-	//LogMsg(INFO, "Animation loading done." );
-
-	return( true );
+	AniLoad task( this, filename );
+	task.Decode();
+	bool success = task.Finish();
+	FinishLoading( success );
+	return success;
 }
 
 /** \brief Get the Image at a specific Frame
@@ -194,13 +297,14 @@ Animation::Animation() {
 
 /**\brief Constructor (based on file).
  * \param filename File to load.
- * \sa Ani::Get
+ * \details The Ani may still be loading.  The Animation doesn't start until it is Ready.
+ * \sa Ani::GetAsync
  */
 Animation::Animation( string filename ) {
 	fnum=0;
 	startTime = 0;
 	loopPercent = 0.0f;
-	ani = Ani::Get( filename );
+	ani = Ani::GetAsync( filename );
 }
 
 /**\brief Returns true while animation is still playing.
@@ -213,19 +317,24 @@ bool Animation::Update() {
 	Image *frame = NULL;
 	bool finished = false;
 
+	// Wait for the Loader, or give up if the Ani could not be loaded
+	if( !ani->IsReady() ) {
+		return( ani->GetState() == RESOURCE_FAILED );
+	}
+
 	if( startTime ) {
-		fnum = (SDL_GetTicks() - startTime) / ani->GetDelay();
+		fnum = (Timer::GetRealTicks() - startTime) / ani->GetDelay();
 
 		if( fnum > ani->GetNumFrames() - 1 ) {
 			fnum = TO_INT(ani->GetNumFrames() * (1.0f-loopPercent)); // Step back a few frames.
-			startTime = SDL_GetTicks() - ani->GetDelay()*fnum; // Pretend that we started fnum frames ago
+			startTime = Timer::GetRealTicks() - ani->GetDelay()*fnum; // Pretend that we started fnum frames ago
 			if( loopPercent <= 0.0f ) {
 				finished = true;
 			}
 		}
 
 	} else {
-		startTime = SDL_GetTicks();
+		startTime = Timer::GetRealTicks();
 		frame = ani->GetFrame(0);
 	}
 	return finished;
@@ -234,6 +343,9 @@ bool Animation::Update() {
 /**\brief Draws the animation at given coordinate.
  */
 void Animation::Draw( int x, int y, float ang ) {
+	if( !ani->IsReady() ) {
+		return;
+	}
 	Image* frame = ani->GetFrame( fnum );
 	frame->DrawCentered( x, y, ang );
 }
@@ -19,6 +19,7 @@ class Ani: public Resource {
 		Ani( string& filename );
 		bool Load( string& filename );
 		static Ani* Get(string filename);
+		static Ani* GetAsync(string filename);
 
 		Image* GetFrame(int frameNum);
 		int GetNumFrames() { return numFrames; }
@@ -27,6 +28,8 @@ class Ani: public Resource {
 		int GetHeight() { return h; }
 
 	private:
+		friend class AniLoad;
+
 		Image *frames;
 		int numFrames;
 		Uint32 delay;
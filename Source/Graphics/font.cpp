@@ -10,6 +10,8 @@
 #include "common.h"
 #include <FTGL/ftgl.h>
 #include "Graphics/font.h"
+#include "Graphics/glstate.h"
+#include "Graphics/spritebatch.h"
 #include "Graphics/video.h"
 #include "Utilities/log.h"
 #include "Utilities/file.h"
@@ -210,16 +212,17 @@ int Font::RenderInternal( int x, int y, const string& text, int h, XPos xpos, YP
 			assert(0);
 	}
 
-	glColor4f( r, g, b, a );
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	SpriteBatch::Flush();
+	GLState::Color( r, g, b, a );
+	GLState::Enable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glPushMatrix(); // to save the current matrix
 	glScalef(1, -1, 1);
 	FTPoint newpoint = this->font->Render( text.c_str(), -1, FTPoint( xn, yn, 1) );
 	glPopMatrix(); // restore the previous matrix
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
+	GLState::ForgetTexture(); // FTGL binds the textures of its glyphs
+	GLState::CountDraw();
 
 	return TO_INT(ceil(newpoint.Xf())) - x;
 }
@@ -0,0 +1,165 @@
+/**\file			glstate.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Remembers the OpenGL state to skip changes that change nothing.
+ * \details
+ */
+
+#include "includes.h"
+#include "Graphics/glstate.h"
+
+/**\class GLState
+ * \brief Remembers the OpenGL state to skip changes that change nothing.
+ *
+ * Every drawing function sets up the state that it needs.  Most of the time
+ * that state is already set, since frames are mostly Images drawn one after
+ * another, so those changes are skipped here rather than sent to the driver.
+ *
+ * Only the texture binding, the capabilities in GLState::caps, the blend
+ * function and the current color are remembered.  Code that changes these
+ * behind GLState's back, like FTGL, must call one of the Forget functions
+ * afterwards.
+ *
+ * The draws and state changes of each frame are counted, so that the Hud can
+ * show them.
+ */
+
+const GLenum GLState::caps[GLSTATE_CAPS] = { GL_TEXTURE_2D, GL_BLEND, GL_DEPTH_TEST, GL_SCISSOR_TEST };
+int GLState::capState[GLSTATE_CAPS] = { -1, -1, -1, -1 };
+bool GLState::textureKnown = false;
+GLuint GLState::texture = 0;
+bool GLState::blendKnown = false;
+GLenum GLState::blendSource = GL_ONE;
+GLenum GLState::blendDestination = GL_ZERO;
+bool GLState::colorKnown = false;
+float GLState::color[4] = { 1.f, 1.f, 1.f, 1.f };
+unsigned int GLState::draws = 0;
+unsigned int GLState::changes = 0;
+unsigned int GLState::skipped = 0;
+unsigned int GLState::lastDraws = 0;
+unsigned int GLState::lastChanges = 0;
+unsigned int GLState::lastSkipped = 0;
+
+/**\brief Forget everything, so that the next change of each kind is sent.
+ * \details Call this whenever there is a new OpenGL context.
+ */
+void GLState::Reset() {
+	for( int c = 0; c < GLSTATE_CAPS; ++c ) {
+		capState[c] = -1;
+	}
+	textureKnown = false;
+	blendKnown = false;
+	colorKnown = false;
+}
+
+/**\brief glEnable, unless the capability is already enabled.
+ */
+void GLState::Enable( GLenum cap ) {
+	SetCap( cap, true );
+}
+
+/**\brief glDisable, unless the capability is already disabled.
+ */
+void GLState::Disable( GLenum cap ) {
+	SetCap( cap, false );
+}
+
+/**\brief Turn a capability on or off.
+ * \details Capabilities that are not remembered are always changed.
+ */
+void GLState::SetCap( GLenum cap, bool on ) {
+	int c;
+	for( c = 0; c < GLSTATE_CAPS; ++c ) {
+		if( caps[c] == cap ) {
+			break;
+		}
+	}
+	if( (c < GLSTATE_CAPS) && (capState[c] == (on ? 1 : 0)) ) {
+		++skipped;
+		return;
+	}
+	if( on ) {
+		glEnable( cap );
+	} else {
+		glDisable( cap );
+	}
+	if( c < GLSTATE_CAPS ) {
+		capState[c] = on ? 1 : 0;
+	}
+	++changes;
+}
+
+/**\brief glBindTexture, unless the texture is already bound.
+ */
+void GLState::BindTexture( GLuint _texture ) {
+	if( textureKnown && (texture == _texture) ) {
+		++skipped;
+		return;
+	}
+	glBindTexture( GL_TEXTURE_2D, _texture );
+	texture = _texture;
+	textureKnown = true;
+	++changes;
+}
+
+/**\brief glBlendFunc, unless the blend function is already the same.
+ */
+void GLState::BlendFunc( GLenum sfactor, GLenum dfactor ) {
+	if( blendKnown && (blendSource == sfactor) && (blendDestination == dfactor) ) {
+		++skipped;
+		return;
+	}
+	glBlendFunc( sfactor, dfactor );
+	blendSource = sfactor;
+	blendDestination = dfactor;
+	blendKnown = true;
+	++changes;
+}
+
+/**\brief glColor4f, unless the color is already the same.
+ */
+void GLState::Color( float r, float g, float b, float a ) {
+	if( colorKnown && (color[0] == r) && (color[1] == g) && (color[2] == b) && (color[3] == a) ) {
+		++skipped;
+		return;
+	}
+	glColor4f( r, g, b, a );
+	color[0] = r;
+	color[1] = g;
+	color[2] = b;
+	color[3] = a;
+	colorKnown = true;
+	++changes;
+}
+
+/**\brief Forget which texture is bound.
+ */
+void GLState::ForgetTexture() {
+	textureKnown = false;
+}
+
+/**\brief Forget a texture that is being deleted.
+ * \details Deleting the bound texture binds texture 0 instead.
+ */
+void GLState::ForgetTexture( GLuint _texture ) {
+	if( textureKnown && (texture == _texture) ) {
+		texture = 0;
+	}
+}
+
+/**\brief Forget the current color.
+ * \details Drawing with a color array leaves the current color undefined.
+ */
+void GLState::ForgetColor() {
+	colorKnown = false;
+}
+
+/**\brief Keep the counts of the frame that was just drawn, and start over.
+ */
+void GLState::EndFrame() {
+	lastDraws = draws;
+	lastChanges = changes;
+	lastSkipped = skipped;
+	draws = changes = skipped = 0;
+}
@@ -0,0 +1,61 @@
+/**\file			glstate.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Remembers the OpenGL state to skip changes that change nothing.
+ * \details
+ */
+
+#ifndef __H_GLSTATE__
+#define __H_GLSTATE__
+
+#include "includes.h"
+
+/// The number of capabilities whose state is remembered.
+#define GLSTATE_CAPS 4
+
+class GLState {
+	public:
+		static void Reset();
+
+		static void Enable( GLenum cap );
+		static void Disable( GLenum cap );
+		static void BindTexture( GLuint texture );
+		static void BlendFunc( GLenum sfactor, GLenum dfactor );
+		static void Color( float r, float g, float b, float a = 1.f );
+
+		static void ForgetTexture();
+		static void ForgetTexture( GLuint texture );
+		static void ForgetColor();
+
+		static void CountDraw() { ++draws; }
+		static void EndFrame();
+
+		static unsigned int GetDraws() { return lastDraws; }
+		static unsigned int GetChanges() { return lastChanges; }
+		static unsigned int GetSkipped() { return lastSkipped; }
+
+	private:
+		static void SetCap( GLenum cap, bool on );
+
+		static const GLenum caps[GLSTATE_CAPS];
+		static int capState[GLSTATE_CAPS]; ///< 1 if enabled, 0 if disabled, -1 if unknown.
+		static bool textureKnown;
+		static GLuint texture;
+		static bool blendKnown;
+		static GLenum blendSource, blendDestination;
+		static bool colorKnown;
+		static float color[4];
+
+		// Counts for the frame being drawn
+		static unsigned int draws;   ///< Calls that draw something.
+		static unsigned int changes; ///< State changes sent to OpenGL.
+		static unsigned int skipped; ///< State changes skipped since nothing would change.
+
+		// Counts for the last whole frame
+		static unsigned int lastDraws;
+		static unsigned int lastChanges;
+		static unsigned int lastSkipped;
+};
+
+#endif // __H_GLSTATE__
@@ -10,21 +10,84 @@
  */
 
 #include "includes.h"
+#include "Graphics/glstate.h"
 #include "Graphics/image.h"
+#include "Graphics/spritebatch.h"
+#include "Graphics/textureatlas.h"
 #include "Graphics/video.h"
 #include "Utilities/file.h"
+#include "Utilities/loader.h"
 #include "Utilities/log.h"
 #include "Utilities/trig.h"
 
 /**\class Image
  * \brief Image handling. */
 
+/**\class ImageLoad
+ * \brief Decodes an Image file on a loader thread.
+ * \details The file is opened right away and closed by the destructor, so
+ *          that both happen on the main thread.  Decode may not use the Log,
+ *          so any read error is kept for Finish to log.
+ */
+class ImageLoad : public LoadTask {
+	public:
+		ImageLoad( Image* _image, const string& filename ):
+			LoadTask( _image ),
+			image( _image ),
+			surface( NULL ),
+			error( "" )
+		{
+			file.OpenRead( filename );
+		}
+
+		~ImageLoad() {
+			if( surface ) {
+				SDL_FreeSurface( surface );
+			}
+		}
+
+		void Decode() {
+			char* buffer = file.Read( &error );
+			if( buffer != NULL ) {
+				surface = Image::Decode( buffer, file.GetLength() );
+				delete [] buffer;
+			}
+		}
+
+		bool Finish() {
+			if( error != "" ) {
+				LogMsg(ERR, "%s", error.c_str() );
+			}
+			if( surface == NULL ) {
+				LogMsg(DEBUG1,"Couldn't Find Image '%s'",image->GetPath().c_str());
+				return false;
+			}
+			SDL_Surface* s = surface;
+			surface = NULL;
+			return image->Load( s );
+		}
+
+		int GetUploadSize() {
+			return surface ? (surface->w * surface->h * 4) : 0;
+		}
+
+	private:
+		Image* image;
+		File file;
+		SDL_Surface* surface;
+		string error; // Logged by Finish, since Decode may not use the Log
+};
+
+GLuint Image::placeholder = 0;
+
 /**\brief Constructor, initialize default values
  */
 Image::Image() {
 	// Initialize variables
 	w = h = real_w = real_h = image = 0;
 	scale_w = scale_h = 1.;
+	tex_x = tex_y = 0.;
+	atlased = false;
 	filepath="";
 }
 
@@ -34,6 +97,8 @@ Image::Image( const string& filename ) {
 	// Initialize variables
 	w = h = real_w = real_h = image = 0;
 	scale_w = scale_h = 1.;
+	tex_x = tex_y = 0.;
+	atlased = false;
 	filepath="";
 
 	Load(filename);
@@ -45,6 +110,8 @@ Image::Image( GLuint texture, int w, int h ) {
 	this->w = real_w = w;
 	this->h = real_h = h;
 	scale_w = scale_h = 1.;
+	tex_x = tex_y = 0.;
+	atlased = false;
 	filepath="";
 
 	image = texture;
@@ -53,8 +120,10 @@ Image::Image( GLuint texture, int w, int h ) {
 /**\brief Deallocate allocations
  */
 Image::~Image() {
-	if ( image ) {
+	Wait();
+	if ( image && !atlased ) {
 		glDeleteTextures( 1, &image );
+		GLState::ForgetTexture( image );
 		image = 0;
 	}
 }
@@ -73,6 +142,35 @@ Image* Image::Get( string filename ) {
 			delete value;
 			return NULL;
 		}
+	} else {
+		// It may have been requested with GetAsync
+		value->Wait();
+		if( value->GetState() == RESOURCE_FAILED ) {
+			return NULL;
+		}
+	}
+	return value;
+}
+
+/**\brief Fetch an Image, decoding it in the background if it isn't loaded yet
+ * \param w,h The size of the image, when the caller already knows it.
+ * \details Until it is Ready, the Image has the size it was requested with
+ *          and draws as a faint placeholder of that size.  Without a size it
+ *          draws nothing.
+ */
+Image* Image::GetAsync( string filename, int w, int h ) {
+	Image* value;
+	value = static_cast<Image*>(Resource::Get(filename));
+	if( value == NULL ) {
+		value = new Image();
+		value->filepath = filename;
+		value->w = w;
+		value->h = h;
+		Resource::Store(filename,(Resource*)value);
+		value->StartLoading( new ImageLoad( value, filename ) );
+	} else if( value->GetState() == RESOURCE_LOADING && value->w == 0 ) {
+		value->w = w;
+		value->h = h;
 	}
 	return value;
 }
@@ -109,23 +207,39 @@ bool Image::Load( const string& filename ) {
 /**\brief Load image from buffer
  */
 bool Image::Load( char *buf, int bufSize ) {
+	SDL_Surface *s = Decode( buf, bufSize );
+
+	if( !s ) {
+		LogMsg(WARN, "Image loading failed. Could not load image from RWops" );
+		return( false );
+	}
+
+	return Load( s );
+}
+
+/**\brief Decode an image file from a buffer
+ * \details This doesn't use OpenGL or the Log, so it may run on a loader thread.
+ * \returns The decoded surface or NULL.
+ */
+SDL_Surface *Image::Decode( char *buf, int bufSize ) {
 	SDL_RWops *rw;
 	SDL_Surface *s = NULL;
 
 	rw = SDL_RWFromMem( buf, bufSize );
 	if( !rw ) {
-		LogMsg(WARN, "Image loading failed. Could not create RWops" );
-		return( false );
+		return( NULL );
 	}
 
 	s = IMG_Load_RW( rw, 0 );
 	SDL_FreeRW(rw);
 
-	if( !s ) {
-		LogMsg(WARN, "Image loading failed. Could not load image from RWops" );
-		return( false );
-	}
+	return( s );
+}
 
+/**\brief Load image from a decoded surface
+ * \details This frees the surface.
+ */
+bool Image::Load( SDL_Surface *s ) {
 	w = s->w;
 	h = s->h;
 
@@ -154,78 +268,57 @@ void Image::DrawAlpha( int x, int y, float alpha ) {
 /**\brief Draw the image (angle is in degrees)
  */
 void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float angle, float resize_ratio_w, float resize_ratio_h) {
-	// the four rotated (if needed) corners of the image
-	float ulx, urx, llx, lrx, uly, ury, lly, lry;
+	GLuint texture = image;
+	float tx0 = tex_x, ty0 = tex_y;
+	float tx1 = tex_x + scale_w, ty1 = tex_y + scale_h;
+
+	// Until the Loader is done with this Image, draw the placeholder at the size it was requested with
+	if( !IsReady() ) {
+		if( GetState() != RESOURCE_LOADING || w == 0 || h == 0 ) {
+			return;
+		}
+		texture = Placeholder();
+		tx0 = ty0 = 0.f;
+		tx1 = ty1 = 1.f;
+	}
 
-	assert(image);
-	if( !image ) {
+	assert(texture);
+	if( !texture ) {
 		LogMsg(WARN, "Trying to draw without loading an image first." );
 		return;
 	}
 
-	glPushMatrix();
-
-	glClearColor(0.0f, 0.0f, 0.0f, 0.0f); // Clear The Background Color To Black
-	glClearDepth(1.0); // Enables Clearing Of The Depth Buffer
-	glShadeModel(GL_SMOOTH); // Enables Smooth Color Shading
-	glEnable(GL_TEXTURE_2D); // Enable 2D Texture Mapping
- 	glEnable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
+	// the resized width and height, e.g. a resize_ratio_w of 1.1 would be 10% wider than the
+	// original width of the image and 0.9 would be 10% narrower
+	float rw = w * resize_ratio_w;
+	float rh = h * resize_ratio_h;
 
-	// calculate the coordinates of the quad	
 	// avoid trig when you can
 	if( angle != 0.f ) {
-		Trig *trig = Trig::Instance();
-		float a = (float)trig->DegToRad( angle );
 		// ax/ay are the coordinate to rotate "about", hence "about points", "about x", "about y"
-		float ax = static_cast<float>(x + (w / 2.));
-		float ay = static_cast<float>(y + (h / 2.));
-
-		trig->RotatePoint( (float)x, (float)y + h, ax, ay, (float *)&ulx, (float *)&uly, a );
-		trig->RotatePoint( (float)x + w, (float)y + h, ax, ay, (float *)&urx, (float *)&ury, a );
-		trig->RotatePoint( (float)x, (float)y, ax, ay, (float *)&llx, (float *)&lly, a );
-		trig->RotatePoint( (float)x + w, (float)y, ax, ay, (float *)&lrx, (float *)&lry, a );
-	} else {
-		ulx = static_cast<float>(x);
-		urx = static_cast<float>(x + w);
-		llx = static_cast<float>(x);
-		lrx = static_cast<float>(x + w);
-		uly = static_cast<float>(y + h);
-		ury = static_cast<float>(y + h);
-		lly = static_cast<float>(y);
-		lry = static_cast<float>(y);
+		float ax = static_cast<float>(x) + rw / 2.f;
+		float ay = static_cast<float>(y) + rh / 2.f;
+		float a = (float)Trig::Instance()->DegToRad( angle );
+
+		// draw! (the SpriteBatch rotates the corners about the center, on the GPU when it can)
+		const float offsets[8] = {
+			-rw / 2.f, -rh / 2.f, // Lower Left
+			 rw / 2.f, -rh / 2.f, // Lower Right
+			 rw / 2.f,  rh / 2.f, // Upper Right
+			-rw / 2.f,  rh / 2.f  // Upper Left
+		};
+		SpriteBatch::AddRotatedQuad( texture, ax, ay, offsets, a, tx0, ty0, tx1, ty1, r, g, b, alpha );
+		return;
 	}
 
-	// draw!
-	glColor4f(r, g, b, alpha);
-	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture( GL_TEXTURE_2D, image );
-
-	//glPushMatrix();
-	
-	// the deltas are the differences needed in width, e.g. a resize_ratio_w of 1.1 would produce a value
-	// equal to the original width of the image but adding 10%. 0.9 would then be 10% smaller, etc.
-	float resize_w_delta = (w * resize_ratio_w) - w;
-	float resize_h_delta = (h * resize_ratio_h) - h;
-
-	glBegin( GL_QUADS );
-	glTexCoord2f( 0., 0. ); glVertex2f( llx, lly );
-	glTexCoord2f( scale_w, 0. ); glVertex2f( lrx + resize_w_delta, lry );
-	glTexCoord2f( scale_w, scale_h ); glVertex2f( urx + resize_w_delta, ury + resize_h_delta );
-	glTexCoord2f( 0., scale_h ); glVertex2f( ulx, uly + resize_h_delta );
-	glEnd();
-
-	//glPopMatrix();
-
-	glEnable(GL_DEPTH_TEST); // Enable Depth Testing
-	glDisable(GL_BLEND); // Disable Blending
-
-	glDisable(GL_TEXTURE_2D); // Disable 2D Texture Mapping
-	glBindTexture(GL_TEXTURE_2D,0); // Unbind The Blur Texture
-
-	glPopMatrix();
+	// draw! (the SpriteBatch draws this along with the other images)
+	const float corners[8] = {
+		static_cast<float>(x), static_cast<float>(y), // Lower Left
+		static_cast<float>(x) + rw, static_cast<float>(y), // Lower Right
+		static_cast<float>(x) + rw, static_cast<float>(y) + rh, // Upper Right
+		static_cast<float>(x), static_cast<float>(y) + rh // Upper Left
+	};
+	SpriteBatch::AddQuad( texture, corners, tx0, ty0, tx1, ty1, r, g, b, alpha );
 }
 
 /**\brief Draw the image centered on (x,y)
@@ -239,6 +332,7 @@ void Image::DrawCentered( int x, int y, float angle ) {
 void Image::DrawStretch( int x, int y, int box_w, int box_h, float angle ) {
 	if(!this) return;
 	assert(this);
+	if( !IsReady() && (w == 0 || h == 0) ) return; // Still loading, with no size to stretch
 	assert(this->w);
 	assert(this->h);
 
@@ -254,6 +348,7 @@ void Image::DrawStretch( int x, int y, int box_w, int box_h, float angle ) {
 /**\brief Draw the image within a box but not stretched
  */
 void Image::DrawFit( int x, int y, int box_w, int box_h, float angle ) {
+	if( !IsReady() && (w == 0 || h == 0) ) return; // Still loading, with no size to fit
 	float resize_ratio_w = (float)box_w / (float)this->w;
 	float resize_ratio_h = (float)box_h / (float)this->h;
 	// Use Minimum of the two ratios
@@ -280,14 +375,39 @@ int Image::PowerOfTwo(int num) {
 bool Image::ConvertToTexture( SDL_Surface *s ) {
 	assert(s);
 
+	// Headless Simulations have no OpenGL context, so only the size is kept.
+	if( !Video::IsInitialized() ) {
+		SDL_FreeSurface( s );
+		return( true );
+	}
+
 	// delete an old loaded image if one eixsts
 	if( image ) {
-		glDeleteTextures( 1, &image );
+		if( !atlased ) {
+			glDeleteTextures( 1, &image );
+			GLState::ForgetTexture( image );
+		}
 		image = 0;
+		atlased = false;
+		tex_x = tex_y = 0.;
+		scale_w = scale_h = 1.;
 
 		LogMsg(WARN, "Loading an image after another is loaded already. Deleting old ... " );
 	}
 
+	// Small images share a large texture, so that many can be drawn at once
+	int atlas_x, atlas_y;
+	if( TextureAtlas::Insert( s, &image, &atlas_x, &atlas_y ) ) {
+		real_w = real_h = TextureAtlas::GetSize();
+		tex_x = (float)atlas_x / (float)real_w;
+		tex_y = (float)atlas_y / (float)real_h;
+		scale_w = (float)s->w / (float)real_w;
+		scale_h = (float)s->h / (float)real_h;
+		atlased = true;
+		SDL_FreeSurface( s );
+		return( true );
+	}
+
 	// Check to see if we need to expand the image
 	int expanded_w = PowerOfTwo(s->w);
 	int expanded_h = PowerOfTwo(s->h);
@@ -338,7 +458,7 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 	glGenTextures( 1, &image );
 
 	// use the bitmap data stored in the SDL_Surface
-	glBindTexture( GL_TEXTURE_2D, (unsigned int)image );
+	GLState::BindTexture( image );
 
 	// upload the texture data, letting OpenGL do any required conversion.
 	glTexImage2D( GL_TEXTURE_2D, 0, internal_format, real_w, real_h, 0, img_format, img_type, s->pixels );
@@ -355,56 +475,48 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 /**\brief Draw the image tiled to fill a rectangle of w/h - will crop to meet w/h and won't overflow
  */
 void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
+	if( !IsReady() ) {
+		return;
+	}
 	if( !image ) {
 		LogMsg(WARN, "Trying to draw without loading an image first." );
 		return;
 	}
 
-	glPushMatrix();
-
-	glClearColor(0.0f, 0.0f, 0.0f, 0.0f); // Clear The Background Color To Black
-	glClearDepth(1.0); // Enables Clearing Of The Depth Buffer
-	glShadeModel(GL_SMOOTH); // Enables Smooth Color Shading
-	glEnable(GL_TEXTURE_2D); // Enable 2D Texture Mapping
- 	glEnable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
-
-	// draw it
-	glColor4f(1, 1, 1, alpha);
-	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture( GL_TEXTURE_2D, image );
-
-	//glPushMatrix();
-
 	Video::SetCropRect(x, y, fill_w, fill_h); // don't need to invert y here
 
-	glBegin( GL_QUADS );
 	for( int j = 0; j < fill_h; j += h) {
 		for( int i = 0; i < fill_w; i += w) {
-			glTexCoord2f( 0., 0. ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+j) ); // Lower Left
-			glTexCoord2f( scale_w, 0. ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+j)); // Lower Right
-			glTexCoord2f( scale_w, scale_h ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+h+j) ); // Upper Right
-			glTexCoord2f( 0., scale_h ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+h+j) ); // Upper Left
+			const float corners[8] = {
+				static_cast<float>(x+i), static_cast<float>(y+j), // Lower Left
+				static_cast<float>(x+w+i), static_cast<float>(y+j), // Lower Right
+				static_cast<float>(x+w+i), static_cast<float>(y+h+j), // Upper Right
+				static_cast<float>(x+i), static_cast<float>(y+h+j) // Upper Left
+			};
+			SpriteBatch::AddQuad( image, corners, tex_x, tex_y, tex_x + scale_w, tex_y + scale_h, 1.f, 1.f, 1.f, alpha );
 		}
 	}
-	glEnd();
-
-	Video::UnsetCropRect();
-
-	//glPopMatrix();
 
-	glEnable(GL_DEPTH_TEST); // Enable Depth Testing
-	glDisable(GL_BLEND); // Disable Blending
+	Video::UnsetCropRect(); // draws the tiles before the crop is removed
+}
 
-	glDisable(GL_TEXTURE_2D); // Disable 2D Texture Mapping
-	glBindTexture(GL_TEXTURE_2D,0); // Unbind The Blur Texture
 
-	glPopMatrix();
+/**\brief The texture drawn in place of Images that are still loading
+ * \details This is a single faint grey pixel, stretched to the size of the Image.
+ */
+GLuint Image::Placeholder() {
+	if( placeholder == 0 ) {
+		const unsigned char pixel[4] = { 128, 128, 128, 64 };
+
+		glGenTextures( 1, &placeholder );
+		GLState::BindTexture( placeholder );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+	}
+	return placeholder;
 }
 
-
 /**\brief Will destroy 's' so don't do anything with it after this and don't worry about freeing it (it's freed here)
  * e.g. proper usage: convert = ExpandCanvas( convert, w, h );
  */
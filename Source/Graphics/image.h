@@ -32,11 +32,17 @@ class Image : public Resource {
 		~Image();
 
 		static Image* Get(string filename);
+		static Image* GetAsync(string filename, int w = 0, int h = 0);
 
 		// Load image from file
 		bool Load( const string& filename );
 		// Load image from buffer
 		bool Load( char *buf, int bufSize );
+		// Load image from a decoded surface, which is freed
+		bool Load( SDL_Surface *s );
+
+		// Decode an image file from a buffer without touching OpenGL (safe on any thread)
+		static SDL_Surface *Decode( char *buf, int bufSize );
 
 		// Get information about image dimensions (always the virtual/effective size)
 		int GetWidth( void ) { return w; };
@@ -58,6 +64,7 @@ class Image : public Resource {
 		void DrawFit( int x, int y, int w, int h, float angle = 0. );
 
 		string GetPath(){return filepath;}
+		GLuint GetTexture(){return image;}
 
 	private:
 		// Draw the image (angle in degrees)
@@ -69,6 +76,8 @@ class Image : public Resource {
 		SDL_Surface *ExpandCanvas( SDL_Surface *s, int w, int h );
 		// Returns the next highest power of two if num is not a power of two
 		int PowerOfTwo(int num);
+		// The texture drawn in place of Images that are still loading
+		static GLuint Placeholder();
 
 		int w, h; // virtual w/h (effective, same as original file)
 		int real_w, real_h; // real w/h, size of expanded canvas (image) should expansion be needed
@@ -77,8 +86,13 @@ class Image : public Resource {
 		                        // the larger canvas actually contains the original image (<= 1.0)
 		                        // defaults = 1.0, this factor is always used, so non-expanded images are
 		                        // simply "scaled" at 1.0. THIS HAS NOTHING TO DO WITH RESIZE()
+		float tex_x, tex_y; // where the image starts within the texture (0.0 unless it is in the TextureAtlas)
+		bool atlased; // the texture is a TextureAtlas page shared with other images, so it is never deleted
 		GLuint image; // OpenGL pointer to texture
 		string filepath;
+
+		static GLuint placeholder; // 1x1 texture drawn while Loading
+
 };
 
 #endif // __H_IMAGE__
@@ -0,0 +1,364 @@
+/**\file			spritebatch.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Draws many textured quads with a few draw calls.
+ * \details
+ */
+
+#include "includes.h"
+#include "Graphics/glstate.h"
+#include "Graphics/spritebatch.h"
+#include "Utilities/log.h"
+#include "Utilities/options.h"
+#include "Utilities/trig.h"
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER_ARB
+#define GL_ARRAY_BUFFER_ARB 0x8892
+#endif
+#ifndef GL_STREAM_DRAW_ARB
+#define GL_STREAM_DRAW_ARB 0x88E0
+#endif
+
+// The vertex buffer functions are an extension to OpenGL 1.1, so they are
+// looked up when the batch is initialized.
+typedef void (APIENTRY *GenBuffersFunc)( GLsizei n, GLuint *buffers );
+typedef void (APIENTRY *DeleteBuffersFunc)( GLsizei n, const GLuint *buffers );
+typedef void (APIENTRY *BindBufferFunc)( GLenum target, GLuint buffer );
+typedef void (APIENTRY *BufferDataFunc)( GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage );
+
+static GenBuffersFunc genBuffers = NULL;
+static DeleteBuffersFunc deleteBuffers = NULL;
+static BindBufferFunc bindBuffer = NULL;
+static BufferDataFunc bufferData = NULL;
+
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+// The shader functions are part of OpenGL 2.0, so they are looked up too.
+typedef GLuint (APIENTRY *CreateShaderFunc)( GLenum type );
+typedef void (APIENTRY *ShaderSourceFunc)( GLuint shader, GLsizei count, const char **strings, const GLint *lengths );
+typedef void (APIENTRY *CompileShaderFunc)( GLuint shader );
+typedef void (APIENTRY *GetShaderivFunc)( GLuint shader, GLenum pname, GLint *params );
+typedef void (APIENTRY *DeleteShaderFunc)( GLuint shader );
+typedef GLuint (APIENTRY *CreateProgramFunc)( void );
+typedef void (APIENTRY *AttachShaderFunc)( GLuint program, GLuint shader );
+typedef void (APIENTRY *LinkProgramFunc)( GLuint program );
+typedef void (APIENTRY *GetProgramivFunc)( GLuint program, GLenum pname, GLint *params );
+typedef void (APIENTRY *DeleteProgramFunc)( GLuint program );
+typedef void (APIENTRY *UseProgramFunc)( GLuint program );
+typedef GLint (APIENTRY *GetAttribLocationFunc)( GLuint program, const char *name );
+typedef void (APIENTRY *VertexAttribPointerFunc)( GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer );
+typedef void (APIENTRY *VertexAttribArrayFunc)( GLuint index );
+
+static CreateShaderFunc createShader = NULL;
+static ShaderSourceFunc shaderSource = NULL;
+static CompileShaderFunc compileShader = NULL;
+static GetShaderivFunc getShaderiv = NULL;
+static DeleteShaderFunc deleteShader = NULL;
+static CreateProgramFunc createProgram = NULL;
+static AttachShaderFunc attachShader = NULL;
+static LinkProgramFunc linkProgram = NULL;
+static GetProgramivFunc getProgramiv = NULL;
+static DeleteProgramFunc deleteProgram = NULL;
+static UseProgramFunc useProgram = NULL;
+static GetAttribLocationFunc getAttribLocation = NULL;
+static VertexAttribPointerFunc vertexAttribPointer = NULL;
+static VertexAttribArrayFunc enableVertexAttribArray = NULL;
+static VertexAttribArrayFunc disableVertexAttribArray = NULL;
+
+// Rotates each corner about the center of its quad, mirrored in y like Trig::RotatePoint.
+// Quads that aren't rotated have no offset, so they are drawn where they are.
+static const char *rotateShaderSource =
+	"attribute vec3 rotation; // The offset from the center, and the angle\n"
+	"void main() {\n"
+	"	float s = sin( rotation.z );\n"
+	"	float c = cos( rotation.z );\n"
+	"	vec2 corner = gl_Vertex.xy + vec2( rotation.x * c - rotation.y * s, -(rotation.x * s + rotation.y * c) );\n"
+	"	gl_Position = gl_ModelViewProjectionMatrix * vec4( corner, 0.0, 1.0 );\n"
+	"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+	"	gl_FrontColor = gl_Color;\n"
+	"}\n";
+
+/**\class SpriteBatch
+ * \brief Draws many textured quads with a few draw calls.
+ *
+ * Image::Draw and the rest add their quads here rather than drawing them
+ * right away.  The quads are kept in the order that they were added, and
+ * every run of quads that share a texture is drawn with one call.  Since
+ * most Images are packed into the TextureAtlas, and the SpriteManager draws
+ * the Sprites of each draw order grouped by texture, a frame of Sprites
+ * takes only a handful of calls.
+ *
+ * The quads must be drawn before anything else touches OpenGL, or they would
+ * end up on top of whatever was drawn after them.  Video, Font and anything
+ * else that draws or changes the matrix calls Flush first.
+ *
+ * The vertices are streamed through a vertex buffer when the driver has
+ * them, and drawn from client memory otherwise.  Setting the
+ * "options/video/sprite-batch" option to 0 draws each quad as it is added.
+ *
+ * Rotated quads are given as their center, the offsets of their corners and
+ * their angle.  With OpenGL 2.0, a vertex shader rotates the corners, so
+ * that nothing is rotated on the CPU.  Otherwise, or when the
+ * "options/video/rotate-shader" option is 0, the corners are rotated here
+ * with the sine and cosine tables of Trig.
+ */
+
+vector<SpriteBatch::Vertex> SpriteBatch::vertices;
+vector<SpriteBatch::Run> SpriteBatch::runs;
+bool SpriteBatch::enabled = true;
+GLuint SpriteBatch::vertexBuffer = 0;
+GLuint SpriteBatch::program = 0;
+GLint SpriteBatch::rotationAttribute = -1;
+bool SpriteBatch::rotateShader = true;
+
+/**\brief Set up the vertex buffer.
+ * \details Call this once there is an OpenGL context.
+ */
+void SpriteBatch::Initialize() {
+	enabled = OPTION( bool, "options/video/sprite-batch" );
+	vertices.reserve( SPRITEBATCH_MAX_QUADS * 4 );
+
+	const char *extensions = (const char*)glGetString( GL_EXTENSIONS );
+	if( (vertexBuffer == 0) && (extensions != NULL) && (strstr( extensions, "GL_ARB_vertex_buffer_object" ) != NULL) ) {
+		genBuffers = (GenBuffersFunc)SDL_GL_GetProcAddress( "glGenBuffersARB" );
+		deleteBuffers = (DeleteBuffersFunc)SDL_GL_GetProcAddress( "glDeleteBuffersARB" );
+		bindBuffer = (BindBufferFunc)SDL_GL_GetProcAddress( "glBindBufferARB" );
+		bufferData = (BufferDataFunc)SDL_GL_GetProcAddress( "glBufferDataARB" );
+		if( genBuffers && deleteBuffers && bindBuffer && bufferData ) {
+			genBuffers( 1, &vertexBuffer );
+		}
+	}
+
+	rotateShader = OPTION( bool, "options/video/rotate-shader" );
+	if( program == 0 ) {
+		program = CreateRotateShader();
+	}
+
+	LogMsg(INFO, "Sprite batching is %s, drawing from %s.", enabled ? "on" : "off",
+		vertexBuffer ? "a vertex buffer" : "client memory" );
+	LogMsg(INFO, "Rotating Images with %s.", IsRotateShaderUsed() ? "a vertex shader" : "lookup tables" );
+}
+
+/**\brief Compile and link the rotation shader.
+ * \returns The shader program, or 0 if the driver doesn't have shaders.
+ */
+GLuint SpriteBatch::CreateRotateShader() {
+	const char *version = (const char*)glGetString( GL_VERSION );
+	if( (version == NULL) || (version[0] < '2') ) {
+		return 0;
+	}
+
+	createShader = (CreateShaderFunc)SDL_GL_GetProcAddress( "glCreateShader" );
+	shaderSource = (ShaderSourceFunc)SDL_GL_GetProcAddress( "glShaderSource" );
+	compileShader = (CompileShaderFunc)SDL_GL_GetProcAddress( "glCompileShader" );
+	getShaderiv = (GetShaderivFunc)SDL_GL_GetProcAddress( "glGetShaderiv" );
+	deleteShader = (DeleteShaderFunc)SDL_GL_GetProcAddress( "glDeleteShader" );
+	createProgram = (CreateProgramFunc)SDL_GL_GetProcAddress( "glCreateProgram" );
+	attachShader = (AttachShaderFunc)SDL_GL_GetProcAddress( "glAttachShader" );
+	linkProgram = (LinkProgramFunc)SDL_GL_GetProcAddress( "glLinkProgram" );
+	getProgramiv = (GetProgramivFunc)SDL_GL_GetProcAddress( "glGetProgramiv" );
+	deleteProgram = (DeleteProgramFunc)SDL_GL_GetProcAddress( "glDeleteProgram" );
+	useProgram = (UseProgramFunc)SDL_GL_GetProcAddress( "glUseProgram" );
+	getAttribLocation = (GetAttribLocationFunc)SDL_GL_GetProcAddress( "glGetAttribLocation" );
+	vertexAttribPointer = (VertexAttribPointerFunc)SDL_GL_GetProcAddress( "glVertexAttribPointer" );
+	enableVertexAttribArray = (VertexAttribArrayFunc)SDL_GL_GetProcAddress( "glEnableVertexAttribArray" );
+	disableVertexAttribArray = (VertexAttribArrayFunc)SDL_GL_GetProcAddress( "glDisableVertexAttribArray" );
+	if( !(createShader && shaderSource && compileShader && getShaderiv && deleteShader
+		&& createProgram && attachShader && linkProgram && getProgramiv && deleteProgram && useProgram
+		&& getAttribLocation && vertexAttribPointer && enableVertexAttribArray && disableVertexAttribArray) ) {
+		return 0;
+	}
+
+	GLint status = 0;
+	GLuint shader = createShader( GL_VERTEX_SHADER );
+	shaderSource( shader, 1, &rotateShaderSource, NULL );
+	compileShader( shader );
+	getShaderiv( shader, GL_COMPILE_STATUS, &status );
+	if( !status ) {
+		LogMsg(WARN, "Could not compile the rotation shader." );
+		deleteShader( shader );
+		return 0;
+	}
+
+	GLuint newProgram = createProgram();
+	attachShader( newProgram, shader );
+	linkProgram( newProgram );
+	deleteShader( shader ); // The program keeps it until the program is deleted
+	getProgramiv( newProgram, GL_LINK_STATUS, &status );
+	rotationAttribute = getAttribLocation( newProgram, "rotation" );
+	if( !status || (rotationAttribute < 0) ) {
+		LogMsg(WARN, "Could not link the rotation shader." );
+		deleteProgram( newProgram );
+		return 0;
+	}
+	return newProgram;
+}
+
+/**\brief Choose whether rotated quads are rotated by the shader or on the CPU.
+ * \details The shader is only used if the driver has it.
+ */
+void SpriteBatch::UseRotateShader( bool use ) {
+	Flush();
+	rotateShader = use;
+}
+
+/**\brief Draw anything left and release the vertex buffer.
+ */
+void SpriteBatch::Shutdown() {
+	Flush();
+	if( vertexBuffer ) {
+		deleteBuffers( 1, &vertexBuffer );
+		vertexBuffer = 0;
+	}
+	if( program ) {
+		deleteProgram( program );
+		program = 0;
+	}
+}
+
+/**\brief Add a textured quad.
+ * \param corners The screen position of each corner as x,y pairs, in the
+ *                order of the texture corners (u0,v0) (u1,v0) (u1,v1) (u0,v1).
+ * \param u0,v0,u1,v1 The part of the texture to draw.
+ */
+void SpriteBatch::AddQuad( GLuint texture, const float corners[8], float u0, float v0, float u1, float v1,
+	float r, float g, float b, float alpha ) {
+	Push( texture, corners, NULL, 0.f, u0, v0, u1, v1, r, g, b, alpha );
+}
+
+/**\brief Add a textured quad rotated about a point.
+ * \param x,y The screen position that the quad is rotated about.
+ * \param offsets The position of each corner relative to x,y before it is
+ *                rotated, in the same order as for AddQuad.
+ * \param angle The angle in radians.
+ * \param u0,v0,u1,v1 The part of the texture to draw.
+ */
+void SpriteBatch::AddRotatedQuad( GLuint texture, float x, float y, const float offsets[8], float angle,
+	float u0, float v0, float u1, float v1, float r, float g, float b, float alpha ) {
+	float corners[8];
+
+	if( IsRotateShaderUsed() ) {
+		for( int c = 0; c < 4; ++c ) {
+			corners[2*c] = x;
+			corners[2*c+1] = y;
+		}
+		Push( texture, corners, offsets, angle, u0, v0, u1, v1, r, g, b, alpha );
+		return;
+	}
+
+	float sine, cosine;
+	Trig::Instance()->GetSinCos( angle, &sine, &cosine );
+	for( int c = 0; c < 4; ++c ) {
+		corners[2*c] = x + (offsets[2*c] * cosine - offsets[2*c+1] * sine);
+		corners[2*c+1] = y - (offsets[2*c] * sine + offsets[2*c+1] * cosine);
+	}
+	Push( texture, corners, NULL, 0.f, u0, v0, u1, v1, r, g, b, alpha );
+}
+
+/**\brief Add the four vertices of a quad.
+ * \param offsets The corner offsets for the shader to rotate, or NULL.
+ */
+void SpriteBatch::Push( GLuint texture, const float corners[8], const float offsets[8], float angle,
+	float u0, float v0, float u1, float v1, float r, float g, float b, float alpha ) {
+	if( vertices.size() >= SPRITEBATCH_MAX_QUADS * 4 ) {
+		Flush();
+	}
+
+	if( runs.empty() || (runs.back().texture != texture) ) {
+		Run run;
+		run.texture = texture;
+		run.first = vertices.size();
+		run.count = 0;
+		runs.push_back( run );
+	}
+	runs.back().count += 4;
+
+	Vertex vertex;
+	vertex.r = static_cast<GLubyte>( r * 255.f + .5f );
+	vertex.g = static_cast<GLubyte>( g * 255.f + .5f );
+	vertex.b = static_cast<GLubyte>( b * 255.f + .5f );
+	vertex.a = static_cast<GLubyte>( alpha * 255.f + .5f );
+	vertex.ox = vertex.oy = 0.f;
+	vertex.angle = angle;
+	const float u[4] = { u0, u1, u1, u0 };
+	const float v[4] = { v0, v0, v1, v1 };
+	for( int c = 0; c < 4; ++c ) {
+		vertex.x = corners[2*c];
+		vertex.y = corners[2*c+1];
+		vertex.u = u[c];
+		vertex.v = v[c];
+		if( offsets ) {
+			vertex.ox = offsets[2*c];
+			vertex.oy = offsets[2*c+1];
+		}
+		vertices.push_back( vertex );
+	}
+
+	if( !enabled ) {
+		Flush();
+	}
+}
+
+/**\brief Draw every quad added since the last Flush.
+ */
+void SpriteBatch::Flush() {
+	if( vertices.empty() ) {
+		return;
+	}
+
+	GLState::Enable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	const GLvoid *base = &vertices[0];
+	if( vertexBuffer ) {
+		bindBuffer( GL_ARRAY_BUFFER_ARB, vertexBuffer );
+		// Giving the whole buffer new data lets the driver keep drawing from the old data.
+		bufferData( GL_ARRAY_BUFFER_ARB, vertices.size() * sizeof(Vertex), base, GL_STREAM_DRAW_ARB );
+		base = NULL; // Offsets are now into the buffer
+	}
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glVertexPointer( 2, GL_FLOAT, sizeof(Vertex), (const GLubyte*)base + offsetof(Vertex, x) );
+	glTexCoordPointer( 2, GL_FLOAT, sizeof(Vertex), (const GLubyte*)base + offsetof(Vertex, u) );
+	glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof(Vertex), (const GLubyte*)base + offsetof(Vertex, r) );
+	if( IsRotateShaderUsed() ) {
+		useProgram( program );
+		enableVertexAttribArray( rotationAttribute );
+		vertexAttribPointer( rotationAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLubyte*)base + offsetof(Vertex, ox) );
+	}
+
+	for( vector<Run>::iterator run = runs.begin(); run != runs.end(); ++run ) {
+		GLState::BindTexture( run->texture );
+		glDrawArrays( GL_QUADS, run->first, run->count );
+		GLState::CountDraw();
+	}
+	GLState::ForgetColor();
+
+	if( IsRotateShaderUsed() ) {
+		disableVertexAttribArray( rotationAttribute );
+		useProgram( 0 );
+	}
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+	if( vertexBuffer ) {
+		bindBuffer( GL_ARRAY_BUFFER_ARB, 0 );
+	}
+
+	vertices.clear();
+	runs.clear();
+}
@@ -0,0 +1,63 @@
+/**\file			spritebatch.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Draws many textured quads with a few draw calls.
+ * \details
+ */
+
+#ifndef __H_SPRITEBATCH__
+#define __H_SPRITEBATCH__
+
+#include "includes.h"
+
+/// The most quads held before they are drawn.
+#define SPRITEBATCH_MAX_QUADS 8192
+
+class SpriteBatch {
+	public:
+		static void Initialize();
+		static void Shutdown();
+
+		static void AddQuad( GLuint texture, const float corners[8], float u0, float v0, float u1, float v1,
+			float r, float g, float b, float alpha );
+		static void AddRotatedQuad( GLuint texture, float x, float y, const float offsets[8], float angle,
+			float u0, float v0, float u1, float v1, float r, float g, float b, float alpha );
+		static void Flush();
+
+		static bool IsEnabled() { return enabled; }
+		static bool HasVertexBuffer() { return vertexBuffer != 0; }
+		static bool HasRotateShader() { return program != 0; }
+		static void UseRotateShader( bool use );
+		static bool IsRotateShaderUsed() { return rotateShader && (program != 0); }
+
+	private:
+		static void Push( GLuint texture, const float corners[8], const float offsets[8], float angle,
+			float u0, float v0, float u1, float v1, float r, float g, float b, float alpha );
+		static GLuint CreateRotateShader();
+
+		/// One corner of a quad.
+		struct Vertex {
+			GLfloat x, y;
+			GLfloat u, v;
+			GLubyte r, g, b, a;
+			GLfloat ox, oy, angle; ///< Rotated by the shader: the corner offset from x,y and the angle in radians.
+		};
+
+		/// Consecutive quads that use the same texture.
+		struct Run {
+			GLuint texture;
+			GLint first;    ///< The first vertex.
+			GLsizei count;  ///< The number of vertices.
+		};
+
+		static vector<Vertex> vertices;
+		static vector<Run> runs;
+		static bool enabled;
+		static GLuint vertexBuffer; ///< The streaming buffer, or 0 to draw from client memory.
+		static GLuint program;      ///< The rotation shader, or 0 if the driver has none.
+		static GLint rotationAttribute;
+		static bool rotateShader;   ///< Rotate with the shader rather than on the CPU.
+};
+
+#endif // __H_SPRITEBATCH__
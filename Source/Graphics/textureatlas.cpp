@@ -0,0 +1,152 @@
+/**\file			textureatlas.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Packs many small Images into a few large textures.
+ * \details
+ */
+
+#include "includes.h"
+#include "Graphics/glstate.h"
+#include "Graphics/textureatlas.h"
+#include "Utilities/log.h"
+#include "Utilities/options.h"
+
+/**\class TextureAtlas
+ * \brief Packs many small Images into a few large textures.
+ *
+ * Ships, weapons and animation frames each used to be their own texture, so
+ * every Sprite drawn needed its own texture binding.  Instead, the Images
+ * that are small enough are copied into a few large Pages as they are loaded,
+ * so that the SpriteBatch can draw most of a frame from a single texture.
+ *
+ * Each Page is filled with Shelves: rows of Images no taller than the row.
+ * An Image goes on the lowest Shelf it fits on, or else on a new Shelf.
+ * Nothing is ever removed, since Images are kept until the game exits.
+ *
+ * The size of the Pages is set by the "options/video/texture-atlas" option.
+ * Setting it to 0 gives every Image its own texture again.
+ */
+
+vector<TextureAtlas::Page> TextureAtlas::pages;
+int TextureAtlas::size = 0;
+
+/**\brief Copy an Image into a Page.
+ * \param s The pixels of the Image.  They are not freed.
+ * \param texture [out] The Page that the Image was copied to.
+ * \param x,y [out] Where the upper-left pixel of the Image was copied to.
+ * \returns False if the Image should have its own texture instead.
+ */
+bool TextureAtlas::Insert( SDL_Surface *s, GLuint *texture, int *x, int *y ) {
+	if( size == 0 ) {
+		int maxSize = 0;
+		glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+		size = OPTION( int, "options/video/texture-atlas" );
+		if( size > maxSize ) {
+			size = maxSize;
+		}
+		if( size <= 0 ) {
+			size = -1; // Disabled
+		}
+	}
+	// Large Images would leave little room for anything else.
+	if( (size < 0) || (s->w > size / 4) || (s->h > size / 4) ) {
+		return false;
+	}
+
+	int w = s->w + 2 * ATLAS_PADDING;
+	int h = s->h + 2 * ATLAS_PADDING;
+	unsigned int p;
+	for( p = 0; p < pages.size(); ++p ) {
+		if( Place( &pages[p], w, h, x, y ) ) {
+			break;
+		}
+	}
+	if( p == pages.size() ) {
+		if( !AddPage() || !Place( &pages[p], w, h, x, y ) ) {
+			return false;
+		}
+	}
+	*x += ATLAS_PADDING;
+	*y += ATLAS_PADDING;
+	*texture = pages[p].texture;
+
+	// Convert the pixels to the same format as the Page.
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	SDL_Surface *rgba = SDL_CreateRGBSurface( SDL_SWSURFACE, s->w, s->h, 32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff );
+#else
+	SDL_Surface *rgba = SDL_CreateRGBSurface( SDL_SWSURFACE, s->w, s->h, 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 );
+#endif
+	if( rgba == NULL ) {
+		LogMsg(WARN, "Could not convert an Image for the texture atlas: %s", SDL_GetError() );
+		return false;
+	}
+	SDL_SetAlpha( s, 0, SDL_ALPHA_OPAQUE ); // Copy the alpha values rather than blending with them
+	SDL_BlitSurface( s, NULL, rgba, NULL );
+
+	GLState::BindTexture( *texture );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, *x, *y, s->w, s->h, GL_RGBA, GL_UNSIGNED_BYTE, rgba->pixels );
+
+	SDL_FreeSurface( rgba );
+	return true;
+}
+
+/**\brief Find room for a rectangle on a Page.
+ * \param x,y [out] The upper-left corner of the room found.
+ * \returns False if the Page is too full.
+ */
+bool TextureAtlas::Place( Page *page, int w, int h, int *x, int *y ) {
+	// Use the shortest Shelf that is tall enough and has room left.
+	Shelf *best = NULL;
+	for( vector<Shelf>::iterator shelf = page->shelves.begin(); shelf != page->shelves.end(); ++shelf ) {
+		if( (h <= shelf->height) && (shelf->x + w <= size) ) {
+			if( (best == NULL) || (shelf->height < best->height) ) {
+				best = &(*shelf);
+			}
+		}
+	}
+
+	// Otherwise start a new Shelf under the others.
+	if( best == NULL ) {
+		if( (page->top + h > size) || (w > size) ) {
+			return false;
+		}
+		Shelf shelf;
+		shelf.y = page->top;
+		shelf.height = h;
+		shelf.x = 0;
+		page->shelves.push_back( shelf );
+		page->top += h;
+		best = &page->shelves.back();
+	}
+
+	*x = best->x;
+	*y = best->y;
+	best->x += w;
+	return true;
+}
+
+/**\brief Create an empty Page.
+ */
+bool TextureAtlas::AddPage() {
+	Page page;
+	page.top = 0;
+
+	// Start with every pixel clear, so that the padding is invisible.
+	Uint8 *clear = (Uint8*)calloc( size * size, 4 );
+	if( clear == NULL ) {
+		LogMsg(ERR, "Could not allocate a %dx%d texture atlas.", size, size );
+		return false;
+	}
+	glGenTextures( 1, &page.texture );
+	GLState::BindTexture( page.texture );
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	free( clear );
+
+	pages.push_back( page );
+	LogMsg(INFO, "Created texture atlas page %d at %dx%d.", static_cast<int>(pages.size()), size, size );
+	return true;
+}
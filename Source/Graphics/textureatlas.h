@@ -0,0 +1,46 @@
+/**\file			textureatlas.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Packs many small Images into a few large textures.
+ * \details
+ */
+
+#ifndef __H_TEXTUREATLAS__
+#define __H_TEXTUREATLAS__
+
+#include "includes.h"
+
+/// Empty pixels kept around each Image so that filtering never samples a neighbor.
+#define ATLAS_PADDING 2
+
+class TextureAtlas {
+	public:
+		static bool Insert( SDL_Surface *s, GLuint *texture, int *x, int *y );
+
+		static int GetSize() { return size; }
+		static unsigned int GetNumPages() { return pages.size(); }
+
+	private:
+		/// A row of Images that are no taller than the row.
+		struct Shelf {
+			int y;      ///< The top of the row.
+			int height;
+			int x;      ///< Where the next Image in this row will go.
+		};
+
+		/// One of the large textures.
+		struct Page {
+			GLuint texture;
+			vector<Shelf> shelves;
+			int top;    ///< Where the next Shelf will go.
+		};
+
+		static bool Place( Page *page, int w, int h, int *x, int *y );
+		static bool AddPage();
+
+		static vector<Page> pages;
+		static int size; ///< The width and height of every Page, or 0 before the first Page.
+};
+
+#endif // __H_TEXTUREATLAS__
@@ -8,7 +8,10 @@
 #include "includes.h"
 #include "common.h"
 #include "Graphics/video.h"
+#include "Graphics/glstate.h"
+#include "Graphics/spritebatch.h"
 #include "Utilities/file.h"
+#include "Utilities/loader.h"
 #include "Utilities/log.h"
 #include "Utilities/xml.h"
 #include "Utilities/trig.h"
@@ -189,7 +192,8 @@ bool Video::Initialize( void ) {
 /**\brief Shuts down the Video display.
  */
 bool Video::Shutdown( void ) {
-	
+	SpriteBatch::Shutdown();
+
 	EnableMouse();
 
 	return( true );
@@ -267,15 +271,19 @@ bool Video::SetWindow( int w, int h, int bpp, bool fullscreen ) {
 	}
 
 	// set up some needed opengl facilities
-	glEnable( GL_TEXTURE_2D );
+	// Everything is drawn flat and in order, so these are set once here
+	// rather than before each drawing.
+	GLState::Reset();
+	GLState::Enable( GL_TEXTURE_2D );
 	glShadeModel( GL_SMOOTH );
 	glClearColor( 0.0f, 0.0f, 0.0f, 0.5f );
 	glClearDepth( 1.0f );
-	glEnable( GL_DEPTH_TEST );
+	GLState::Disable( GL_DEPTH_TEST );
 	glDepthFunc( GL_LEQUAL );
 	glHint( GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST );
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+	GLState::Enable(GL_BLEND);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// for motion blur
 	glClearAccum(0.0, 0.0, 0.0, 1.0);
@@ -298,6 +306,8 @@ bool Video::SetWindow( int w, int h, int bpp, bool fullscreen ) {
 
 	LogMsg(INFO, "Video mode initialized at %dx%dx%d\n", screen->w, screen->h, screen->format->BitsPerPixel );
 
+	SpriteBatch::Initialize();
+
 	return( true );
 }
 
@@ -332,10 +342,15 @@ int Video::lua_getHeight(lua_State *L) {
 /**\brief Video updates.
  */
 void Video::Update( void ) {
+	SpriteBatch::Flush();
+	GLState::EndFrame();
 	glFlush();
 	SDL_GL_SwapBuffers();
 	//glAccum(GL_ACCUM, 0.8f);
 	glFinish();
+
+	// Upload some of the Images that were decoded in the background
+	Loader::Update();
 }
 
 /**\brief Pre-draw commands.
@@ -351,6 +366,7 @@ void Video::PreDraw( void ) {
 	// Clear the accumulation buffer (don't worry, we re-grab the screen into the accumulation buffer after drawing our current frame!)
 	//glClear(GL_ACCUM_BUFFER_BIT);
  
+	SpriteBatch::Flush();
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 }
@@ -362,6 +378,8 @@ void Video::PostDraw( void ) {
 }
 
 void Video::Blur( void ) {
+	SpriteBatch::Flush();
+
 	float q = .6f;
 
 	glAccum(GL_MULT, q);
@@ -372,6 +390,8 @@ void Video::Blur( void ) {
 /**\brief Clears screen.
  */
 void Video::Erase( void ) {
+	SpriteBatch::Flush();
+
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 	//glLoadIdentity();
 }
@@ -391,9 +411,12 @@ int Video::GetHeight( void ) {
 /**\brief draws a point, a single pixel, on the screen
  */
 void Video::DrawPoint( int x, int y, float r, float g, float b ) {
-	glDisable(GL_TEXTURE_2D);
-	glColor3f( r, g, b );
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Color( r, g, b );
 	glRecti( x, y, x + 1, y + 1 );
+	GLState::CountDraw();
 }
 
 /**\brief Draw a point using Coordinate and Color.
@@ -417,21 +440,29 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, Color c, float a ) {
 /**\brief Draw a Line.
  */
 void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b, float a ) {
-	glColor4f( r, g, b, a );
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color( r, g, b, a );
 	glBegin(GL_LINES);
 	glVertex2d(x1,y1);
 	glVertex2d(x2,y2);
 	glEnd();
+	GLState::CountDraw();
 }
 
 
 /**\brief Draws a filled rectangle
  */
 void Video::DrawRect( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	glDisable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glColor4f( r, g, b, a );
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color( r, g, b, a );
 	glRecti( x, y, x + w, y + h );
+	GLState::CountDraw();
 }
 
 void Video::DrawRect( int x, int y, int w, int h, Color c, float a ) {
@@ -449,9 +480,11 @@ void Video::DrawBox( int x, int y, int w, int h, Color c, float a ) {
 /**\brief Draws an unfilled rectangle
  */
 void Video::DrawBox( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	glDisable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glColor4f( r, g, b, a );
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color( r, g, b, a );
 	glBegin(GL_LINE_STRIP);
 	glVertex2d(x,y);
 	glVertex2d(x+w,y);
@@ -459,6 +492,7 @@ void Video::DrawBox( int x, int y, int w, int h, float r, float g, float b, floa
 	glVertex2d(x,y+h);
 	glVertex2d(x,y);
 	glEnd();
+	GLState::CountDraw();
 
 }
 
@@ -477,8 +511,11 @@ void Video::DrawCircle( Coordinate c, int radius, float line_width, Color col, f
 /**\brief Draws a circle
  */
 void Video::DrawCircle( int x, int y, int radius, float line_width, float r, float g, float b, float a) {
-	glDisable(GL_TEXTURE_2D);
-	glColor4f( r, g, b, a );
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color( r, g, b, a );
 	glLineWidth(line_width);
 	glBegin(GL_LINE_STRIP);
 	Trig* t = Trig::Instance();
@@ -489,6 +526,7 @@ void Video::DrawCircle( int x, int y, int radius, float line_width, float r, flo
 	// One more point to finish the circle. (ang=0)
 	glVertex2d(radius + x, y);
 	glEnd();
+	GLState::CountDraw();
 	// Reset Line Width
 	glLineWidth(1);
 }
@@ -504,8 +542,11 @@ void Video::DrawFilledCircle( int x, int y, int radius, Color c, float a) {
 /**\brief Draw a filled circle.
  */
 void Video::DrawFilledCircle( int x, int y, int radius, float r, float g, float b, float a) {
-	glColor4f(r,g,b,a);
-	glEnable(GL_BLEND);
+	SpriteBatch::Flush();
+
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color(r,g,b,a);
 	glBegin(GL_TRIANGLE_STRIP);
 	Trig* t = Trig::Instance();
 	for(int angle = 0; angle < 360; angle += 5)
@@ -517,13 +558,18 @@ void Video::DrawFilledCircle( int x, int y, int radius, float r, float g, float
 	glVertex2d(x,y);
 	glVertex2d(radius + x, y);
 	glEnd();
+	GLState::CountDraw();
 }
 
 /**\brief Draws a targeting overlay.
  */
 void Video::DrawTarget( int x, int y, int w, int h, int d, float r, float g, float b, float a ) {
+	SpriteBatch::Flush();
+
 	// d is for 'depth' and is the number of crosshair pixels
-	glColor4f(r,g,b,a);
+	GLState::Disable(GL_TEXTURE_2D);
+	GLState::Enable(GL_BLEND);
+	GLState::Color(r,g,b,a);
 	glBegin(GL_LINES);
 		// Upper Left Corner
 		glVertex2d(x-w/2,y-h/2); glVertex2d(x-w/2,y-h/2+d);
@@ -538,6 +584,7 @@ void Video::DrawTarget( int x, int y, int w, int h, int d, float r, float g, flo
 		glVertex2d(x+w/2,y+h/2); glVertex2d(x+w/2,y+h/2-d);
 		glVertex2d(x+w/2,y+h/2); glVertex2d(x+w/2-d,y+h/2);
 	glEnd();
+	GLState::CountDraw();
 }
 
 /**\brief Enables the mouse
@@ -567,10 +614,12 @@ int Video::GetHalfHeight( void ) {
 /**\brief Set crop rectangle.
  */
 void Video::SetCropRect( int x, int y, int w, int h ){
+	SpriteBatch::Flush();
+
 	int xn, yn, wn, hn;
 
 	if (cropRects.empty()) {
-		glEnable(GL_SCISSOR_TEST);
+		GLState::Enable(GL_SCISSOR_TEST);
 
 		xn = x;
 		yn = y;
@@ -604,13 +653,15 @@ void Video::SetCropRect( int x, int y, int w, int h ){
 /**\brief Unset the previous crop rectangle after use.
  */
 void Video::UnsetCropRect( void ) {
+	SpriteBatch::Flush();
+
 	if (!cropRects.empty()) // Shouldn't be empty
 		cropRects.pop();
 	else
 		LogMsg(WARN,"You unset the crop rect too many times.");
 
 	if ( cropRects.empty() ) {
-		glDisable(GL_SCISSOR_TEST);
+		GLState::Disable(GL_SCISSOR_TEST);
 	} else {
 		// Set's the previous crop rectangle.
 		Rect prevrect = cropRects.top();
@@ -624,9 +675,11 @@ void Video::UnsetCropRect( void ) {
 Image *Video::CaptureScreen( void ) {
 	GLuint screenCapture;
 
+	SpriteBatch::Flush();
+
 	glGenTextures( 1, &screenCapture );
 
-	glBindTexture(GL_TEXTURE_2D, screenCapture);
+	GLState::BindTexture(screenCapture);
 
 	glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, 0, 0, w, h, 0);
 
@@ -638,6 +691,8 @@ Image *Video::CaptureScreen( void ) {
 /**\brief Takes a screenshot of the game and saves it to a file.
  */
 void Video::SaveScreenshot( string filename ) {
+	SpriteBatch::Flush();
+
 	unsigned int size = w * h * 4;
 	int *pixelData, *pixelDataOrig;
 
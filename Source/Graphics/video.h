@@ -63,6 +63,7 @@ class Video {
  	public:
 		static bool Initialize( void );
 		static bool Shutdown( void );
+		static bool IsInitialized( void ) { return screen != NULL; }
 		
   		static bool SetWindow( int w, int h, int bpp, bool fullscreen );
 
@@ -276,9 +276,9 @@ void Input::PushTypeEvent( list<InputEvent> & events, SDLKey key ) {
 void Input::HandleLuaCallBacks( list<InputEvent> & events ) {
 	list<InputEvent>::iterator i = events.begin();
 	while( i != events.end() ) {
-		map<InputEvent,string>::iterator val = eventMappings.find( *i );
+		map<InputEvent,int>::iterator val = eventMappings.find( *i );
 		if( val != eventMappings.end() ){
-			Lua::Run( val->second );
+			Lua::RunChunk( val->second );
 			i = events.erase( i );
 		}
 		else{
@@ -288,9 +288,10 @@ void Input::HandleLuaCallBacks( list<InputEvent> & events ) {
 }
 
 /**\brief Register Lua events.
+ * \details The command is compiled now rather than each time the event happens.
  */
 void Input::RegisterCallBack( InputEvent event, string command ) {
-	eventMappings.insert(make_pair(event, command));
+	eventMappings.insert(make_pair(event, Lua::Compile( command )));
 }
 
 /**\brief Unregister Lua events.
@@ -119,7 +119,7 @@ class Input {
 
 		bool heldKeys[SDLK_LAST]; // set to true as long as a key is held down
 		list<InputEvent> events; // a list of all the events that occurred for this loop. we pass this list around to various sub-input systems
-		map<InputEvent,string> eventMappings; // Lua callbacks mapped to a key
+		map<InputEvent,int> eventMappings; // Compiled Lua callbacks mapped to a key
 		Uint32 lastMouseMove;
 };
 
@@ -11,6 +11,10 @@
 #include "Sprites/ai.h"
 #include "Sprites/player.h"
 #include "Sprites/spritemanager.h"
+#include "Sprites/statemachines.h"
+#include "Sprites/aischeduler.h"
+#include "Utilities/timer.h"
+#include "Utilities/trig.h"
 #include "Utilities/lua.h"
 #include "Engine/simulation_lua.h"
 
@@ -34,41 +38,53 @@ AI::AI(string _name, string machine) :
 {
 	target = 0;
 	merciful = 0;
+	machineID = -1;
+	stateID = -1;
+	compiledGeneration = 0;
+	lastDecision = 0;
+	deciding = false;
+	steerAccelerate = false;
+	steerRotate = false;
+	steerHeading = 0;
 }
 
 /** \brief Run the Lua Statemachine to act and possibly change state.
+ * \details The State Machine and state are looked up by name only when they
+ *          change, or when the StateMachines are recompiled.
+ * \see StateMachines
  */
 
 void AI::Decide( lua_State *L ) {
-	string newstate;
 	// Decide
 	const int initialStackTop = lua_gettop(L);
 
 	// Get the current state machine
-	lua_getglobal(L, stateMachine.c_str() );
-	int machineIndex = lua_gettop(L);
-	if( ! lua_istable(L, machineIndex) )
-	{
-		LogMsg(ERR, "There is no State Machine named '%s'!", stateMachine.c_str() );
-		return; // This ship will just sit idle...
-	}
-
-	// Get the current state
-	lua_pushstring(L, state.c_str() );
-	lua_gettable(L, machineIndex);
-	if( ! lua_isfunction(L,lua_gettop(L)) )
-	{
-		LogMsg(WARN, "The State Machine '%s' has no state '%s'.", stateMachine.c_str(), state.c_str() );
-		lua_getglobal(L, stateMachine.c_str() );
-		lua_pushstring(L, "default" );
-		lua_gettable(L,machineIndex);
-		if( !lua_isfunction(L,lua_gettop(L)) )
+	StateMachines::Refresh( L );
+	if( compiledGeneration != StateMachines::GetGeneration() ) {
+		machineID = StateMachines::Find( L, stateMachine );
+		if( machineID < 0 )
 		{
-			LogMsg(ERR, "The State Machine '%s' has no default state.", stateMachine.c_str() );
-			lua_settop(L, initialStackTop);
+			LogMsg(ERR, "There is no State Machine named '%s'!", stateMachine.c_str() );
 			return; // This ship will just sit idle...
 		}
+
+		// Get the current state
+		stateID = StateMachines::FindState( machineID, state );
+		if( stateID < 0 )
+		{
+			LogMsg(WARN, "The State Machine '%s' has no state '%s'.", stateMachine.c_str(), state.c_str() );
+			stateID = StateMachines::FindState( machineID, "default" );
+			if( stateID < 0 )
+			{
+				LogMsg(ERR, "The State Machine '%s' has no default state.", stateMachine.c_str() );
+				return; // This ship will just sit idle...
+			}
+			state = "default";
+		}
+		compiledGeneration = StateMachines::GetGeneration();
 	}
+	LuaProfileScope profile( "AI::Decide", stateMachine.c_str(), state.c_str() );
+	StateMachines::PushState( L, machineID, stateID );
 
 	// Push Current AI Variables
 	lua_pushinteger( L, this->GetID() );
@@ -90,17 +106,18 @@ void AI::Decide( lua_State *L ) {
 
 	if( lua_isstring( L, lua_gettop(L) ) )
 	{
-		newstate = (string)luaL_checkstring(L, lua_gettop(L));
-
 		// Verify that this new state exists
-		lua_pushstring(L, newstate.c_str() );
-		lua_gettable(L,machineIndex);
-		if( lua_isfunction(L, lua_gettop(L) ))
+		int newStateID = StateMachines::ToState( L, machineID, lua_gettop(L) );
+		if( newStateID >= 0 )
 		{
-			state = newstate;
+			if( newStateID != stateID ) {
+				stateID = newStateID;
+				state = StateMachines::GetStateName( machineID, stateID );
+			}
 		} else {
-			LogMsg(ERR, "The State Machine '%s' has no state '%s'. Could not transition from '%s'. Resetting StateMachine.", stateMachine.c_str(), newstate.c_str(), state.c_str() );
+			LogMsg(ERR, "The State Machine '%s' has no state '%s'. Could not transition from '%s'. Resetting StateMachine.", stateMachine.c_str(), lua_tostring(L, lua_gettop(L)), state.c_str() );
 			state = "default"; // Reset the state
+			compiledGeneration = 0;
 		}
 		//printf("Changing State:"); Lua::stackDump(L); // DEBUG
 	}
@@ -111,6 +128,9 @@ void AI::Decide( lua_State *L ) {
 
 /**\brief Updates the AI controlled ship by first calling the Lua function
  * and then calling Ship::Update()
+ * \details The AIScheduler decides whether the Lua function runs this tick.
+ *          On the ticks that it doesn't, the Ship keeps steering the way
+ *          that it did the last time that it decided.
  */
 void AI::Update( lua_State *L ) {
 	//Update enemies
@@ -123,13 +143,58 @@ void AI::Update( lua_State *L ) {
 		}
 	}
 	if( !this->IsDisabled() ) {
-		this->Decide( L );
+		int tier;
+		if( AIScheduler::ShouldDecide( GetID(), GetWorldPosition(), !enemies.empty(), lastDecision, &tier ) ) {
+			Uint64 start = Timer::GetNanoseconds();
+			steerAccelerate = false;
+			steerRotate = false;
+			deciding = true;
+			this->Decide( L );
+			deciding = false;
+			lastDecision = Timer::GetLogicalFrameCount();
+			AIScheduler::Decided( tier, Timer::GetNanoseconds() - start );
+		} else {
+			this->Steer();
+		}
 	}
 
 	// Now act like a normal ship
 	this->Ship::Update( L );
 }
 
+/**\brief Remember that the State Machine accelerated.
+ * \details Accelerate and Rotate are scaled by the length of one tick, so
+ *          they have to be repeated on the ticks that the AI doesn't decide.
+ */
+void AI::RecordAccelerate() {
+	if( deciding ) {
+		steerAccelerate = true;
+	}
+}
+
+/**\brief Remember which way the State Machine rotated.
+ * \details Call this before rotating.  The heading is kept rather than the
+ *          relative direction, so that repeating it can't turn too far.
+ * \param direction Relative angle that the Ship is about to rotate by.
+ */
+void AI::RecordRotate( float direction ) {
+	if( deciding ) {
+		steerRotate = true;
+		steerHeading = normalizeAngle( GetAngle() + direction );
+	}
+}
+
+/**\brief Repeat the steering of the last Decide.
+ */
+void AI::Steer() {
+	if( steerRotate ) {
+		this->Rotate( normalizeAngle( steerHeading - GetAngle() ) );
+	}
+	if( steerAccelerate ) {
+		this->Accelerate();
+	}
+}
+
 /**\brief The last function call to the ship before it get's deleted
  *
  * At this point, the ship still exists. It has not been removed from the Universe
@@ -174,15 +239,19 @@ void AI::Draw(){
 int AI::ChooseTarget( lua_State *L ){
 	//printf("choosing target\n");
 	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
-	list<Sprite*> *nearbySprites = sprites->GetSpritesNear(this->GetWorldPosition(), COMBAT_RANGE, DRAW_ORDER_SHIP);
+	// The AI are only ever updated one at a time, so they can share this buffer.
+	static vector<Sprite*> nearbySprites;
+	nearbySprites.clear();
+	sprites->GetSpritesNear(this->GetWorldPosition(), COMBAT_RANGE, &nearbySprites, DRAW_ORDER_SHIP);
 	
-	nearbySprites->sort(CompareAI);
-	list<Sprite*>::iterator it;
+	sort(nearbySprites.begin(), nearbySprites.end(), CompareAI);
+	unsigned int it;
 	list<enemy>::iterator enemyIt=enemies.begin();
 	//printf("printing list of enemies\n");
 	//printf("the size of enemies = %d\n", enemies.size() );
 	for(enemyIt=enemies.begin(); enemyIt!=enemies.end();){
-		if(sprites->GetSpriteByID( enemyIt->id)==NULL){
+		// Enemies are cast to Ships below, so anything else is dropped too.
+		if(sprites->GetSpriteByID( enemyIt->id, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER )==NULL){
 			enemyIt=enemies.erase(enemyIt);
 		}
 		else {
@@ -191,30 +260,31 @@ int AI::ChooseTarget( lua_State *L ){
 	}
 	
 	//printf("printing list of nearby it->GetTarget()\n");
-	//int nearbySpritesSize=(*nearbySprites).size();
+	//int nearbySpritesSize=nearbySprites.size();
 	//printf("the size of nearbySprites = %d\n",nearbySpritesSize);
-	/*for(it=nearbySprites->begin(); it!=nearbySprites->end(); it++){
-		if( (*it)->GetDrawOrder() ==DRAW_ORDER_SHIP )
-			printf("it->GetTarget() = %d\n",((AI*)(*it))->GetTarget() );
-		printf("it->GetID() = %d\n",(*it)->GetID() );
+	/*for(it=0; it<nearbySprites.size(); it++){
+		if( nearbySprites[it]->GetDrawOrder() ==DRAW_ORDER_SHIP )
+			printf("it->GetTarget() = %d\n",((AI*)nearbySprites[it])->GetTarget() );
+		printf("it->GetID() = %d\n",nearbySprites[it]->GetID() );
 
 	}*/
-	it=nearbySprites->begin();
 	enemyIt=enemies.begin();
 	int max=0,currTarget=-1;
 	int threat=0;
 	//printf("starting sprite iteration\n");
 		
-	for(it= nearbySprites->begin(); it!=nearbySprites->end() && enemyIt!=enemies.end() ; it++){
-		if( (*it)->GetID()== this->GetID() )
+	// Note that 'it' is unsigned, so stepping back from 0 wraps around and the ++ brings it back to 0.
+	for(it=0; it<nearbySprites.size() && enemyIt!=enemies.end() ; it++){
+		Sprite* nearby = nearbySprites[it];
+		if( nearby->GetID()== this->GetID() )
 			continue;
 
 
-		if( (*it)->GetDrawOrder() ==DRAW_ORDER_SHIP){
+		if( nearby->GetDrawOrder() ==DRAW_ORDER_SHIP){
 
-			if( enemyIt->id < ((AI*) (*it))->GetTarget() ){
+			if( enemyIt->id < ((AI*) nearby)->GetTarget() ){
 				//printf("starting enemyIt iteration\n");
-				while ( enemyIt!=enemies.end() && enemyIt->id < ( (AI*) (*it) )->GetTarget() ) {
+				while ( enemyIt!=enemies.end() && enemyIt->id < ( (AI*) nearby )->GetTarget() ) {
 				//	printf("enemyIt = %d\n",enemyIt->id);
 				//	printf("it->GetTarget() = %d\n", ((AI*) (*it))->GetTarget() );
 					if ( !InRange( sprites->GetSpriteByID(enemyIt->id)->GetWorldPosition() , this->GetWorldPosition() ) ) {
@@ -234,11 +304,11 @@ int AI::ChooseTarget( lua_State *L ){
 				it--;
 				continue;
 			}
-			if( enemyIt->id == ((AI*) (*it))->GetTarget() )
-				threat-= ( (Ship*)(*it) )->GetTotalCost();
+			if( enemyIt->id == ((AI*) nearby)->GetTarget() )
+				threat-= ( (Ship*)nearby )->GetTotalCost();
 		}
 		else{
-			LogMsg( ERR, "Error Sprite %d is not an AI\n", (*it)->GetID() );
+			LogMsg( ERR, "Error Sprite %d is not an AI\n", nearby->GetID() );
 		}
 	
 	}
@@ -280,7 +350,7 @@ int AI::CalcCost( int threat, int damage){
 /**\brief sets the AI's target
  *
  */
-void AI::SetTarget(int t){
+void AI::SetTarget(SpriteHandle t){
 	AddEnemy(t,0);
 	target=t;
 }
@@ -288,7 +358,7 @@ void AI::SetTarget(int t){
 /**\brief Adds an enemy to the AI's list of enemies
  * \todo Remove the SpriteManager Instance access.
  */
-void AI::AddEnemy(int spriteID, int damage){
+void AI::AddEnemy(SpriteHandle spriteID, int damage){
 	//printf("Adding Enemy %d with damage %d\n",spriteID,damage);
 	Sprite *spr = SpriteManager::Instance()->GetSpriteByID(spriteID);
 	if(!spr){
@@ -332,7 +402,7 @@ void AI::AddEnemy(int spriteID, int damage){
 
 /**\brief Remove an enemy from the AI's list of enemies
  */
-void AI::RemoveEnemy(int spriteID){
+void AI::RemoveEnemy(SpriteHandle spriteID){
 	//printf("removing enemy %d\n",spriteID);
 	enemy newE;
 	newE.id=spriteID;
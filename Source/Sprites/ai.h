@@ -35,22 +35,27 @@ class AI : public Ship {
 		// State Machine Mechanics:
 
 		string GetStateMachine() { return stateMachine; }
-		void SetStateMachine(string _machine) { stateMachine = _machine; }
+		void SetStateMachine(string _machine) { stateMachine = _machine; compiledGeneration = 0; }
 
 		string GetState() { return state; }
-		void SetState(string _state)  { state = _state; }
+		void SetState(string _state)  { state = _state; compiledGeneration = 0; }
 
 		// Combat Mechanics:
 
-		void SetTarget(int t);
-		int GetTarget(){return target;}
+		void SetTarget(SpriteHandle t);
+		SpriteHandle GetTarget(){return target;}
 
-		void AddEnemy(int spriteID, int damage);
-		void RemoveEnemy(int spriteID);
+		void AddEnemy(SpriteHandle spriteID, int damage);
+		void RemoveEnemy(SpriteHandle spriteID);
 
 		void SetMerciful(int f) { merciful = (f == 1); }
 		int GetMerciful() { return (merciful ? 1 : 0 ); }
 
+		// Steering Mechanics:
+
+		void RecordAccelerate();
+		void RecordRotate( float direction );
+
 		void Killed( lua_State *L );
 
 	private:
@@ -61,16 +66,27 @@ class AI : public Ship {
 		// The state machine is essentially a flow chart
 		string stateMachine; ///< The name of the State Machine.
 		string state; ///< The current state of the state machine.
+		int machineID; ///< The compiled State Machine.
+		int stateID; ///< The current state within the compiled State Machine.
+		Uint32 compiledGeneration; ///< The StateMachines generation that the IDs belong to.
+		Uint32 lastDecision; ///< The logical frame of the last Decide.
 		void Decide( lua_State *L );
 
+		// The steering of the last Decide is repeated until the next one.
+		bool deciding; ///< Decide is running, so the steering is being recorded.
+		bool steerAccelerate; ///< The last Decide accelerated.
+		bool steerRotate; ///< The last Decide rotated.
+		float steerHeading; ///< The angle that the last Decide rotated towards.
+		void Steer();
+
 		// AI Combat Mechanics:
 
 		typedef struct{
 			int damage; ///< Damage received by this ship
-			int id; ///< The enemy ship's unique id
+			SpriteHandle id; ///< The enemy ship's unique id
 		}enemy; ///< Simple tracker for how much damage has been taken from other ships
 
-		int target; ///< The enemy that this AI is currently fighting
+		SpriteHandle target; ///< The enemy that this AI is currently fighting
 		bool merciful; ///< Is this ship merciful to the player?
 		list<enemy> enemies; ///< A list of combatants.  The AI should keep fighting until everything on this list is dead.
 
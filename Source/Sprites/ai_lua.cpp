@@ -14,9 +14,12 @@
 #include "Sprites/planets.h"
 #include "Sprites/planets_lua.h"
 #include "Sprites/ai_lua.h"
+#include "Sprites/statemachines.h"
+#include "Sprites/perception.h"
 #include "Audio/sound.h"
 #include "Engine/camera.h"
 #include "Utilities/trig.h"
+#include "Utilities/coordinate_lua.h"
 #include "Engine/commodities.h"
 #include "Engine/simulation_lua.h"
 
@@ -87,7 +90,11 @@ void AI_Lua::RegisterAI(lua_State *L){
 		{"GetPosition", &AI_Lua::ShipGetPosition},
 		{"GetMomentumAngle", &AI_Lua::ShipGetMomentumAngle},
 		{"GetMomentumSpeed", &AI_Lua::ShipGetMomentumSpeed},
+		{"GetCoordinate", &AI_Lua::ShipGetCoordinate},
+		{"GetVelocity", &AI_Lua::ShipGetVelocity},
 		{"directionTowards", &AI_Lua::ShipGetDirectionTowards},
+		{"LeadTarget", &AI_Lua::ShipLeadTarget},
+		{"Perceive", &AI_Lua::ShipPerceive},
 		{"SetMerciful", &AI_Lua::ShipSetMerciful},
 		{"GetMerciful", &AI_Lua::ShipGetMerciful},
 
@@ -139,15 +146,19 @@ void AI_Lua::RegisterAI(lua_State *L){
 	luaL_openlib(L, EPIAR_SHIP, shipFunctions, 0);
 
 	lua_pop(L,2);
+
+	// Any compiled State Machines belonged to an older lua_State.
+	StateMachines::Reset();
+	Perception::Reset();
 }
 
 /**\brief Validates Ship in Lua.
  */
 AI* AI_Lua::checkShip(lua_State *L, int index){
-	int* idptr = (int*)luaL_checkudata(L, index, EPIAR_SHIP);
+	SpriteHandle* idptr = (SpriteHandle*)luaL_checkudata(L, index, EPIAR_SHIP);
 	luaL_argcheck(L, idptr != NULL, index, "`EPIAR_SHIP' expected");
 	Sprite* s;
-	s = Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(*idptr);
+	s = Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(*idptr, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER);
 	/*
 	if ((s) == NULL) luaL_typerror(L, index, EPIAR_SHIP);
 	if (0==((s)->GetDrawOrder() & DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER)){
@@ -213,6 +224,9 @@ int AI_Lua::ShipAccelerate(lua_State* L){
 		AI* ai = checkShip(L,1);
 		if(ai==NULL) return 0;
 		luaL_argcheck(L, ai != NULL, 1, "`array' expected");
+		if( ai->GetDrawOrder() == DRAW_ORDER_SHIP ) {
+			ai->RecordAccelerate();
+		}
 		(ai)->Accelerate();
 	}
 	else
@@ -231,6 +245,9 @@ int AI_Lua::ShipRotate(lua_State* L){
 		AI* ai = checkShip(L,1);
 		if(ai==NULL) return 0;
 		float dir = static_cast<float>( luaL_checknumber(L, 2) );
+		if( ai->GetDrawOrder() == DRAW_ORDER_SHIP ) {
+			ai->RecordRotate(dir);
+		}
 		(ai)->Rotate(dir);
 	}
 	else
@@ -913,6 +930,57 @@ int AI_Lua::ShipGetPosition(lua_State* L){
 	return 2;
 }
 
+/**\brief Lua callable function to get the world position as a Coordinate.
+ * \sa Coordinate_Lua
+ */
+int AI_Lua::ShipGetCoordinate(lua_State* L){
+	int n = lua_gettop(L); // Number of arguments
+	if (n != 1) {
+		return luaL_error(L, "Got %d arguments expected 1 (self)", n);
+	}
+	AI* ai = checkShip(L,1);
+	Coordinate_Lua::pushCoordinate(L, (ai==NULL) ? Coordinate(0,0) : (ai)->GetWorldPosition() );
+	return 1;
+}
+
+/**\brief Lua callable function to get the momentum as a Coordinate.
+ * \sa Coordinate_Lua
+ */
+int AI_Lua::ShipGetVelocity(lua_State* L){
+	int n = lua_gettop(L); // Number of arguments
+	if (n != 1) {
+		return luaL_error(L, "Got %d arguments expected 1 (self)", n);
+	}
+	AI* ai = checkShip(L,1);
+	Coordinate_Lua::pushCoordinate(L, (ai==NULL) ? Coordinate(0,0) : (ai)->GetMomentum() );
+	return 1;
+}
+
+/**\brief Lua callable function to see everything near the ship at once.
+ * \details Takes the radius to search and optionally the most Sprites to
+ *          return of each kind.
+ * \sa Perception
+ */
+int AI_Lua::ShipPerceive(lua_State* L){
+	int n = lua_gettop(L); // Number of arguments
+
+	if (n == 2 || n == 3) {
+		AI* ai = checkShip(L,1);
+		if(ai==NULL){
+			lua_pushnil(L);
+			return 1;
+		}
+		float radius = static_cast<float>( luaL_checknumber(L,2) );
+		int limit = (n == 3) ? luaL_checkint(L,3) : PERCEPTION_DEFAULT_LIMIT;
+		luaL_argcheck(L, limit > 0, 3, "the limit must be positive");
+		Perception::Perceive( L, ai, radius, limit );
+	}
+	else {
+		luaL_error(L, "Got %d arguments expected 2 or 3 (self, radius, [limit])", n);
+	}
+	return 1;
+}
+
 /**\brief Lua callable function to get the ship's momentum angle.
  * \sa Sprite::GetMomentum()
  * \sa Sprite::GetAngle()
@@ -956,11 +1024,25 @@ int AI_Lua::ShipGetMomentumSpeed(lua_State* L){
 }
 
 /**\brief Lua callable function to get the ship's direction towards target.
+ * \details Takes an angle, an x and y, or a Coordinate.  Given a Coordinate,
+ *          the distance to it is returned as well.
  * \sa Ship::directionTowards
  */
 int AI_Lua::ShipGetDirectionTowards(lua_State* L){
 	int n = lua_gettop(L);  // Number of arguments
-	if (n == 2) { // Angle
+	if (n == 2 && Coordinate_Lua::isCoordinate(L,2)) { // Coordinate userdata
+		AI* ai = checkShip(L,1);
+		if(ai==NULL){
+			lua_pushnumber(L, 0 );
+			lua_pushnumber(L, 0 );
+		} else {
+			Coordinate target = *Coordinate_Lua::checkCoordinate(L,2);
+			lua_pushnumber(L, (double) (ai)->GetDirectionTowards(target) );
+			lua_pushnumber(L, (double) (target - (ai)->GetWorldPosition()).GetMagnitude() );
+		}
+		return 2;
+	}
+	else if (n == 2) { // Angle
 		AI* ai = checkShip(L,1);
 		if(ai==NULL){
 			lua_pushnumber(L, 0 );
@@ -984,6 +1066,45 @@ int AI_Lua::ShipGetDirectionTowards(lua_State* L){
 	return 1;
 }
 
+/**\brief Lua callable function to get the direction to fire at a moving target.
+ * \details Takes the target Ship and optionally the speed of the shots, which
+ *          defaults to the speed of the ship's first weapon.  Returns the
+ *          direction to turn and the distance to the target.  When the shots
+ *          can never catch the target, this aims straight at it.
+ * \sa Coordinate_Lua::Intercept
+ */
+int AI_Lua::ShipLeadTarget(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 2 && n != 3) {
+		return luaL_error(L, "Got %d arguments expected 2 or 3 (self, target, [speed])", n);
+	}
+	AI* ai = checkShip(L,1);
+	AI* target = checkShip(L,2);
+	if(ai==NULL || target==NULL){
+		lua_pushnumber(L, 0 );
+		lua_pushnumber(L, 0 );
+		return 2;
+	}
+
+	float speed = 0;
+	if (n == 3) {
+		speed = static_cast<float>( luaL_checknumber(L, 3) );
+	} else if( !(ai)->GetWeapons()->empty() ) {
+		speed = static_cast<float>( (ai)->GetWeapons()->front()->GetVelocity() );
+	}
+
+	Coordinate aim = target->GetWorldPosition();
+	float time;
+	if( speed > 0 ) {
+		Coordinate_Lua::Intercept( ai->GetWorldPosition(), ai->GetMomentum(),
+		                           target->GetWorldPosition(), target->GetMomentum(),
+		                           speed, &aim, &time );
+	}
+	lua_pushnumber(L, (double) (ai)->GetDirectionTowards(aim) );
+	lua_pushnumber(L, (double) (target->GetWorldPosition() - ai->GetWorldPosition()).GetMagnitude() );
+	return 2;
+}
+
 /**\brief Lua callable function to get the ship's weapons.
  * \sa Ship::getWeapons()
  */
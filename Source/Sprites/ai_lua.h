@@ -74,7 +74,11 @@ class AI_Lua{
 		//static int ShipSetPosition(lua_State* L);
 		static int ShipGetMomentumAngle(lua_State* L);
 		static int ShipGetMomentumSpeed(lua_State* L);
+		static int ShipGetCoordinate(lua_State* L);
+		static int ShipGetVelocity(lua_State* L);
 		static int ShipGetDirectionTowards(lua_State* L); // Accepts either Angles or Coordinates
+		static int ShipLeadTarget(lua_State* L);
+		static int ShipPerceive(lua_State* L);
 		//static int ShipGetCurrentWeapon(lua_State* L);
 		//static int ShipGetCurrentAmmo(lua_State* L);
 		static int ShipGetWeapons(lua_State* L);
@@ -0,0 +1,136 @@
+/**\file			aischeduler.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decides how often each AI runs its State Machine.
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/sprite.h"
+#include "Sprites/aischeduler.h"
+#include "Utilities/timer.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class AIScheduler
+ * \brief Level of detail for the AI.
+ *
+ * Running a State Machine is the most expensive part of an AI, but AI that
+ * are far from the camera and the player don't need to decide as often.  Each
+ * tick every AI is put in a tier:
+ *   - AI_TIER_ACTIVE: In combat, or within options/simulation/ai-active-distance
+ *     of the camera or player.  These decide every tick.
+ *   - AI_TIER_NEAR: Within options/simulation/ai-near-distance.  These decide
+ *     every options/simulation/ai-near-interval ticks.
+ *   - AI_TIER_FAR: Everything else.  These decide every
+ *     options/simulation/ai-far-interval ticks.
+ *
+ * The AI of a tier are spread over the ticks by their ID, so that only a
+ * fraction of them decide during any one tick.  Skipping a decision only skips
+ * the Lua; the Ship still moves every tick, and keeps accelerating and turning
+ * the way that it last decided to.
+ *
+ * There is also a budget of options/simulation/ai-budget microseconds per
+ * tick.  Once it is spent, the NEAR and FAR AI that are due are put off until
+ * the next tick.  ACTIVE AI always decide.  The budget is ignored while the
+ * Timer runs on its virtual clock, since wall-clock time would make headless
+ * runs unrepeatable.
+ *
+ * \see AI::Update
+ */
+
+Coordinate AIScheduler::camera;
+Coordinate AIScheduler::player;
+bool AIScheduler::hasPlayer = false;
+Uint32 AIScheduler::frame = 0;
+double AIScheduler::activeSquared = 0.;
+double AIScheduler::nearSquared = 0.;
+Uint32 AIScheduler::intervals[AI_TIERS] = { 1, 1, 1 };
+Uint64 AIScheduler::budget = 0;
+Uint64 AIScheduler::spent = 0;
+AITierStats AIScheduler::stats[AI_TIERS];
+
+/**\brief Get ready for the AI of a new tick.
+ * \param camera Where the camera is focused.
+ * \param player The Player, or NULL if there isn't one.
+ */
+void AIScheduler::BeginTick( Coordinate _camera, Sprite *_player ) {
+	camera = _camera;
+	hasPlayer = (_player != NULL);
+	if( hasPlayer ) {
+		player = _player->GetWorldPosition();
+	}
+	frame = Timer::GetLogicalFrameCount();
+
+	double active = OPTION(double, "options/simulation/ai-active-distance");
+	double near = OPTION(double, "options/simulation/ai-near-distance");
+	activeSquared = active * active;
+	nearSquared = near * near;
+	intervals[AI_TIER_ACTIVE] = 1;
+	intervals[AI_TIER_NEAR] = max( 1, OPTION(int, "options/simulation/ai-near-interval") );
+	intervals[AI_TIER_FAR] = max( 1, OPTION(int, "options/simulation/ai-far-interval") );
+	budget = Timer::IsVirtualClock() ? 0 : static_cast<Uint64>( max( 0, OPTION(int, "options/simulation/ai-budget") ) ) * 1000;
+
+	spent = 0;
+	memset( stats, 0, sizeof(stats) );
+}
+
+/**\brief Should an AI run its State Machine during this tick?
+ * \param id The AI's ID, which picks its turn within its tier.
+ * \param lastDecision The logical frame of the AI's last decision.
+ * \param tier [out] The AI's tier.  Pass it to Decided.
+ */
+bool AIScheduler::ShouldDecide( SpriteHandle id, Coordinate position, bool inCombat, Uint32 lastDecision, int *tier ) {
+	float distanceSquared = (position - camera).GetMagnitudeSquared();
+	if( hasPlayer ) {
+		distanceSquared = min( distanceSquared, (position - player).GetMagnitudeSquared() );
+	}
+
+	if( inCombat || distanceSquared <= activeSquared ) {
+		*tier = AI_TIER_ACTIVE;
+	} else if( distanceSquared <= nearSquared ) {
+		*tier = AI_TIER_NEAR;
+	} else {
+		*tier = AI_TIER_FAR;
+	}
+	stats[*tier].ships++;
+
+	// Decide on this AI's turn, or as soon as possible once it has missed one.
+	Uint32 interval = intervals[*tier];
+	Uint32 waited = frame - lastDecision;
+	bool due = ( (frame + static_cast<Uint32>(id)) % interval == 0 ) || ( waited > interval );
+	if( !due ) {
+		return false;
+	}
+
+	if( *tier != AI_TIER_ACTIVE && budget != 0 && spent >= budget ) {
+		stats[*tier].deferred++;
+		return false;
+	}
+	return true;
+}
+
+/**\brief Record how long an AI took to decide.
+ */
+void AIScheduler::Decided( int tier, Uint64 nanoseconds ) {
+	spent += nanoseconds;
+	stats[tier].decisions++;
+	stats[tier].time += nanoseconds;
+}
+
+/**\brief The name of a tier, for reports.
+ */
+const char* AIScheduler::GetTierName( int tier ) {
+	switch( tier ) {
+		case AI_TIER_ACTIVE: return "active";
+		case AI_TIER_NEAR: return "near";
+		case AI_TIER_FAR: return "far";
+	}
+	return "unknown";
+}
+
+/** @} */
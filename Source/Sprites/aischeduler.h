@@ -0,0 +1,53 @@
+/**\file			aischeduler.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decides how often each AI runs its State Machine.
+ * \details
+ */
+
+#ifndef __H_AISCHEDULER__
+#define __H_AISCHEDULER__
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+#include "Sprites/sprite.h"
+
+// Levels of detail, from the most to the least often updated.
+#define AI_TIER_ACTIVE 0 ///< In combat, or close to the camera or player.  Decides every tick.
+#define AI_TIER_NEAR   1 ///< Within the near distance.  Decides every few ticks.
+#define AI_TIER_FAR    2 ///< Everything else.  Decides rarely.
+#define AI_TIERS       3
+
+/**\brief What the AI of one tier did during the last tick.
+ */
+struct AITierStats {
+	Uint32 ships;      ///< AI in this tier.
+	Uint32 decisions;  ///< AI that ran their State Machine.
+	Uint32 deferred;   ///< AI that were due, but were put off because the budget ran out.
+	Uint64 time;       ///< Nanoseconds spent deciding.
+};
+
+class AIScheduler {
+	public:
+		static void BeginTick( Coordinate camera, Sprite *player );
+		static bool ShouldDecide( SpriteHandle id, Coordinate position, bool inCombat, Uint32 lastDecision, int *tier );
+		static void Decided( int tier, Uint64 nanoseconds );
+
+		static const AITierStats& GetStats( int tier ) { return stats[tier]; }
+		static const char* GetTierName( int tier );
+
+	private:
+		static Coordinate camera;
+		static Coordinate player;
+		static bool hasPlayer;
+		static Uint32 frame;                 ///< The logical frame of this tick.
+		static double activeSquared;         ///< Square of options/simulation/ai-active-distance.
+		static double nearSquared;           ///< Square of options/simulation/ai-near-distance.
+		static Uint32 intervals[AI_TIERS];   ///< Ticks between decisions, by tier.
+		static Uint64 budget;                ///< Nanoseconds of decisions allowed per tick, or 0 for no limit.
+		static Uint64 spent;                 ///< Nanoseconds of decisions so far during this tick.
+		static AITierStats stats[AI_TIERS];
+};
+
+#endif // __H_AISCHEDULER__
@@ -12,7 +12,6 @@
 #include "Sprites/spritemanager.h"
 #include "Sprites/sprite.h"
 #include "Sprites/effects.h"
-#include "Engine/simulation_lua.h"
 
 /** \addtogroup Sprites
  * @{
@@ -38,11 +37,10 @@ Effect::~Effect() {
 
 /**\brief Updates the Effect
  */
-void Effect::Update( lua_State *L ) {
-	Sprite::Update( L );
+void Effect::UpdatePhysics( void ) {
+	Sprite::UpdatePhysics();
 	if( visual->Update() == true ) {
-		SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
-		sprites->Delete( (Sprite*)this );
+		SpriteManager::Instance()->Delete( (Sprite*)this );
 	}
 }
 
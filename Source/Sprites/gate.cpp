@@ -14,6 +14,8 @@
 #include "Sprites/spritemanager.h"
 #include "Sprites/sprite.h"
 #include "Sprites/gate.h"
+#include "Sprites/gateroutes.h"
+#include "Utilities/random.h"
 #include "Utilities/trig.h"
 #include "Utilities/log.h"
 #include "Engine/simulation_lua.h"
@@ -42,7 +44,7 @@ Gate::Gate(Coordinate pos, string _name) {
 
 	// Set both Position and Angle at the same time
 	SetWorldPosition(pos);
-	SetAngle( float( rand() %360 ) );
+	SetAngle( float( Random::Int(360) ) );
 
 	if( _name == "" ) {
 		stringstream val_ss;
@@ -54,7 +56,7 @@ Gate::Gate(Coordinate pos, string _name) {
 
 /**\brief Creates a Bottom Gate
  */
-Gate::Gate(int topID) {
+Gate::Gate(SpriteHandle topID) {
 	top = false;
 	SetImage( Image::Get("Resources/Graphics/gate1_bottom.png") );
 	partnerID = topID;
@@ -127,13 +129,15 @@ void Gate::SetAngle(float angle) {
 void Gate::SetWorldPosition(Coordinate c) {
 	this->_SetWorldPosition(c);
 	GetPartner()->_SetWorldPosition(c);
+	GateRoutes::Moved( GetName() );
 }
 
 /**\brief Set the exit for this Gate
  */
 
-void Gate::SetExit(int spriteID) {
+void Gate::SetExit(SpriteHandle spriteID) {
 	exitID = spriteID;
+	GateRoutes::ExitChanged( this );
 }
 
 void Gate::SetPair(Gate* one, Gate* two) {
@@ -155,7 +159,7 @@ Gate* Gate::GetTop() {
 	if(top){
 		return this;
 	} else {
-		Sprite* top = SpriteManager::Instance()->GetSpriteByID(partnerID);
+		Sprite* top = SpriteManager::Instance()->GetSpriteByID(partnerID, DRAW_ORDER_GATE_TOP);
 		assert(top!=NULL);
 		return (Gate*)top;
 	}
@@ -174,7 +178,7 @@ Sprite* Gate::GetExit() {
  * \return Pointer to the Partner Gate
  */
 Gate* Gate::GetPartner() {
-	Sprite* partner = SpriteManager::Instance()->GetSpriteByID(partnerID);
+	Sprite* partner = SpriteManager::Instance()->GetSpriteByID(partnerID, DRAW_ORDER_GATE_TOP | DRAW_ORDER_GATE_BOTTOM);
 	assert(partner!=NULL);
 	return (Gate*)partner;
 }
@@ -194,7 +198,7 @@ void Gate::Update( lua_State *L ) {
 	if(ship!=NULL) {
 		if(exitID != 0) {
 			SendToExit(ship);
-		} else if(rand()&1) {
+		} else if(Random::Int(2)) {
 			SendToRandomLocation(ship);
 		} else {
 			SendRandomDistance(ship);
@@ -208,7 +212,7 @@ void Gate::Update( lua_State *L ) {
  */
 
 void Gate::SendToRandomLocation(Sprite* ship) {
-	Coordinate destination = Coordinate( float(rand()%GATE_RADIUS - GATE_RADIUS/2), float(rand()%GATE_RADIUS - GATE_RADIUS/2));
+	Coordinate destination = Coordinate( float(Random::Int(GATE_RADIUS) - GATE_RADIUS/2), float(Random::Int(GATE_RADIUS) - GATE_RADIUS/2));
 	ship->SetWorldPosition( destination );
 }
 
@@ -235,7 +239,7 @@ void Gate::SendToExit(Ship* ship) {
  */
 
 void Gate::SendRandomDistance(Sprite* ship) {
-	float distance = float(rand()%GATE_RADIUS);
+	float distance = float(Random::Int(GATE_RADIUS));
 	Trig *trig = Trig::Instance();
 	float angle = static_cast<float>(trig->DegToRad( GetAngle() ));
 	Coordinate destination = GetWorldPosition() +
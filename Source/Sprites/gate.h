@@ -34,7 +34,7 @@ class Gate : public Sprite, public Component {
 		// They modify both this and the partner Gate at the same time
 		void SetAngle(float angle);
 		void SetWorldPosition(Coordinate pos);
-		void SetExit(int SpriteID);
+		void SetExit(SpriteHandle SpriteID);
 
 		static void SetPair(Gate* one, Gate* two);
 
@@ -44,14 +44,14 @@ class Gate : public Sprite, public Component {
 		void Update( lua_State *L );
 	private:
 		bool top; ///< True if this Sprite is on Top.
-		int partnerID; ///< The partner is the top/bottom of this gate
-		int exitID; ///< Ships entering this gate will be transported to the Exit Gate
+		SpriteHandle partnerID; ///< The partner is the top/bottom of this gate
+		SpriteHandle exitID; ///< Ships entering this gate will be transported to the Exit Gate
 
 		void SendToRandomLocation(Sprite* ship);
 		void SendToExit(Ship* ship);
 		void SendRandomDistance(Sprite* ship);
 
-		Gate(int topID);
+		Gate(SpriteHandle topID);
 		// These setters modify this and only this Gate (not the partner)
 		void _SetAngle(float angle) { Sprite::SetAngle(angle); }
 		void _SetWorldPosition(Coordinate c) { Sprite::SetWorldPosition(c); }
@@ -0,0 +1,285 @@
+/**\file			gateroutes.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Shortest routes through the network of Gates.
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/gate.h"
+#include "Sprites/gateroutes.h"
+#include "Sprites/planets.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class GateRoutes
+ * \brief The shortest way to fly from anywhere to a Planet or Gate.
+ *
+ * The Gates and Planets form a graph.  A Ship may fly straight from any Gate
+ * to any other Gate or Planet, or from a Planet to a Gate, and the length of
+ * that edge is the distance between them.  Flying into a Gate and out of its
+ * exit costs nothing.  Ships never plan to fly from one Planet to another,
+ * since they would just as well start from wherever they are.
+ *
+ * Rather than searching from each Ship, the routes are searched backwards
+ * from the destination.  That gives a Tree holding the shortest route from
+ * every Node to the destination, which is kept and shared by every Ship
+ * bound for the same place.  A Ship's route starts at whichever Node is
+ * cheapest to fly to directly, counting the rest of the route from there.
+ *
+ * Adding a pair of Gates can only make routes shorter, so AddGatePair
+ * updates the Trees in place rather than dropping them.  Changing the exit
+ * of a known Gate, or moving or renaming a known Gate or Planet, drops every
+ * Tree, and so does any other change to the number of Gates and Planets.
+ */
+
+bool GateRoutes::built = false;
+vector<GateRoutes::Node> GateRoutes::nodes;
+map<string,int> GateRoutes::nodeIndex;
+map<int,GateRoutes::Tree> GateRoutes::trees;
+vector<bool> GateRoutes::done;
+vector<int> GateRoutes::pending;
+
+/// Longer than any real route.
+static const float unreachable = 1e30f;
+
+/**\brief Find the shortest route from a position to a Planet or Gate.
+ * \param route [out] The name of every Gate and Planet to fly to, in order.
+ *              The last one is the destination.
+ * \returns False if there is nothing with the destination's name.
+ */
+bool GateRoutes::GetRoute( Gates *gates, Planets *planets, Coordinate from, const string& destination, vector<string> *route ) {
+	if( !built || (nodes.size() != static_cast<unsigned int>(gates->Size() + planets->Size())) ) {
+		Build( gates, planets );
+	}
+
+	map<string,int>::iterator found = nodeIndex.find( destination );
+	if( found == nodeIndex.end() ) {
+		return false;
+	}
+	int dest = found->second;
+
+	map<int,Tree>::iterator t = trees.find( dest );
+	if( t == trees.end() ) {
+		t = trees.insert( make_pair( dest, Tree() ) ).first;
+		Solve( dest, &t->second );
+	}
+	Tree *tree = &t->second;
+
+	// Fly straight to whichever Node leaves the least of the route.
+	int first = dest;
+	float best = unreachable;
+	for( unsigned int n = 0; n < nodes.size(); ++n ) {
+		if( tree->distance[n] == unreachable ) {
+			continue;
+		}
+		float dx = nodes[n].x - static_cast<float>(from.GetX());
+		float dy = nodes[n].y - static_cast<float>(from.GetY());
+		float length = sqrt( dx*dx + dy*dy ) + tree->distance[n];
+		if( length < best ) {
+			best = length;
+			first = n;
+		}
+	}
+
+	route->clear();
+	for( int n = first; n != -1; n = tree->next[n] ) {
+		route->push_back( nodes[n].name );
+	}
+	return true;
+}
+
+/**\brief Add a newly created pair of Gates to every known route.
+ * \details Call this after both Gates have been added to the Gates Component.
+ */
+void GateRoutes::AddGatePair( Gate *one, Gate *two ) {
+	if( !built ) {
+		return; // Everything will be found by the next Build.
+	}
+	if( nodeIndex.count( one->GetName() ) || nodeIndex.count( two->GetName() ) ) {
+		Reset();
+		return;
+	}
+
+	unsigned int firstNew = nodes.size();
+	int a = AddNode( one->GetName(), one->GetWorldPosition(), true );
+	int b = AddNode( two->GetName(), two->GetWorldPosition(), true );
+	nodes[a].exit = (one->GetExit() == two) ? b : -1;
+	nodes[b].exit = (two->GetExit() == one) ? a : -1;
+
+	for( map<int,Tree>::iterator t = trees.begin(); t != trees.end(); ++t ) {
+		Extend( &t->second, firstNew );
+	}
+}
+
+/**\brief Forget every route if this Gate's exit was already known.
+ */
+void GateRoutes::ExitChanged( Gate *gate ) {
+	if( built && nodeIndex.count( gate->GetName() ) ) {
+		Reset();
+	}
+}
+
+/**\brief Forget every route if this Gate or Planet was already known.
+ * \details Call this when a Gate or Planet moves or is renamed, with its old name.
+ */
+void GateRoutes::Moved( const string& name ) {
+	if( built && nodeIndex.count( name ) ) {
+		Reset();
+	}
+}
+
+/**\brief Forget every Node and route.
+ */
+void GateRoutes::Reset() {
+	built = false;
+	nodes.clear();
+	nodeIndex.clear();
+	trees.clear();
+}
+
+/**\brief Collect every Gate and Planet as a Node.
+ */
+void GateRoutes::Build( Gates *gates, Planets *planets ) {
+	Reset();
+
+	list<string>* names = gates->GetNames();
+	list<string>::iterator name;
+	for( name = names->begin(); name != names->end(); ++name ) {
+		AddNode( *name, gates->GetGate( *name )->GetWorldPosition(), true );
+	}
+	names = planets->GetNames();
+	for( name = names->begin(); name != names->end(); ++name ) {
+		AddNode( *name, planets->GetPlanet( *name )->GetWorldPosition(), false );
+	}
+
+	// Only link the exits once every Gate has a Node.
+	names = gates->GetNames();
+	for( name = names->begin(); name != names->end(); ++name ) {
+		Sprite *exit = gates->GetGate( *name )->GetExit();
+		if( (exit != NULL) && (exit->GetDrawOrder() & (DRAW_ORDER_GATE_TOP|DRAW_ORDER_GATE_BOTTOM)) ) {
+			map<string,int>::iterator found = nodeIndex.find( ((Gate*)exit)->GetName() );
+			if( found != nodeIndex.end() ) {
+				nodes[ nodeIndex[*name] ].exit = found->second;
+			}
+		}
+	}
+
+	built = true;
+}
+
+/**\brief Append a Node with no exit.
+ * \returns The index of the new Node.
+ */
+int GateRoutes::AddNode( const string& name, Coordinate position, bool gate ) {
+	Node node;
+	node.name = name;
+	node.x = static_cast<float>(position.GetX());
+	node.y = static_cast<float>(position.GetY());
+	node.gate = gate;
+	node.exit = -1;
+	nodes.push_back( node );
+	nodeIndex[name] = nodes.size() - 1;
+	return nodes.size() - 1;
+}
+
+/**\brief The cost of flying from one Node to another.
+ * \returns The length of the edge, or a negative number if there is no edge.
+ */
+float GateRoutes::EdgeLength( int from, int to ) {
+	const Node& a = nodes[from];
+	const Node& b = nodes[to];
+	if( (from == to) || (!a.gate && !b.gate) ) {
+		return -1.0f;
+	}
+	if( a.exit == to ) {
+		return 0.0f;
+	}
+	float dx = a.x - b.x;
+	float dy = a.y - b.y;
+	return sqrt( dx*dx + dy*dy );
+}
+
+/**\brief Find the shortest route from every Node to the destination.
+ * \details This is Dijkstra's algorithm run backwards along the edges.  Every
+ *          Node is connected to nearly every other, so scanning for the
+ *          closest Node is as fast as keeping a heap.
+ */
+void GateRoutes::Solve( int destination, Tree *tree ) {
+	unsigned int count = nodes.size();
+	tree->distance.assign( count, unreachable );
+	tree->next.assign( count, -1 );
+	done.assign( count, false );
+	tree->distance[destination] = 0.0f;
+
+	for( unsigned int settled = 0; settled < count; ++settled ) {
+		int u = -1;
+		for( unsigned int n = 0; n < count; ++n ) {
+			if( !done[n] && (tree->distance[n] != unreachable) && ((u == -1) || (tree->distance[n] < tree->distance[u])) ) {
+				u = n;
+			}
+		}
+		if( u == -1 ) {
+			break; // Everything else is unreachable.
+		}
+		done[u] = true;
+
+		for( unsigned int v = 0; v < count; ++v ) {
+			if( done[v] ) {
+				continue;
+			}
+			float length = EdgeLength( v, u );
+			if( (length >= 0.0f) && (tree->distance[u] + length < tree->distance[v]) ) {
+				tree->distance[v] = tree->distance[u] + length;
+				tree->next[v] = u;
+			}
+		}
+	}
+}
+
+/**\brief Bring a Tree up to date after Nodes were appended.
+ * \details The old distances are still real routes, so they only need to be
+ *          lowered wherever going through a new Node is shorter.
+ * \param firstNew The index of the first appended Node.
+ */
+void GateRoutes::Extend( Tree *tree, unsigned int firstNew ) {
+	unsigned int count = nodes.size();
+	tree->distance.resize( count, unreachable );
+	tree->next.resize( count, -1 );
+
+	// Route each new Node through the old Nodes.
+	pending.clear();
+	unsigned int n, v;
+	for( n = firstNew; n < count; ++n ) {
+		for( v = 0; v < firstNew; ++v ) {
+			float length = EdgeLength( n, v );
+			if( (length >= 0.0f) && (tree->distance[v] != unreachable) && (tree->distance[v] + length < tree->distance[n]) ) {
+				tree->distance[n] = tree->distance[v] + length;
+				tree->next[n] = v;
+			}
+		}
+		if( tree->distance[n] != unreachable ) {
+			pending.push_back( n );
+		}
+	}
+
+	// Then pass on any shortcut to everything that can reach it.
+	while( !pending.empty() ) {
+		int u = pending.back();
+		pending.pop_back();
+		for( v = 0; v < count; ++v ) {
+			float length = EdgeLength( v, u );
+			if( (length >= 0.0f) && (tree->distance[u] + length < tree->distance[v]) ) {
+				tree->distance[v] = tree->distance[u] + length;
+				tree->next[v] = u;
+				pending.push_back( v );
+			}
+		}
+	}
+}
+
+/** @} */
@@ -0,0 +1,60 @@
+/**\file			gateroutes.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Shortest routes through the network of Gates.
+ * \details
+ */
+
+#ifndef __H_GATEROUTES__
+#define __H_GATEROUTES__
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+
+class Gate;
+class Gates;
+class Planets;
+
+class GateRoutes {
+	public:
+		static bool GetRoute( Gates *gates, Planets *planets, Coordinate from, const string& destination, vector<string> *route );
+
+		static void AddGatePair( Gate *one, Gate *two );
+		static void ExitChanged( Gate *gate );
+		static void Moved( const string& name );
+		static void Reset();
+
+		static unsigned int GetNumNodes() { return nodes.size(); }
+		static unsigned int GetNumTrees() { return trees.size(); }
+
+	private:
+		/// A Gate or a Planet that a route can pass through.
+		struct Node {
+			string name;
+			float x, y;
+			bool gate;
+			int exit;   ///< The Node of the Gate that this Gate leads to, or -1.
+		};
+
+		/// The shortest route from every Node to one destination.
+		struct Tree {
+			vector<float> distance; ///< Length of the route from each Node to the destination.
+			vector<int> next;       ///< The Node after each Node on its route, or -1.
+		};
+
+		static void Build( Gates *gates, Planets *planets );
+		static int AddNode( const string& name, Coordinate position, bool gate );
+		static float EdgeLength( int from, int to );
+		static void Solve( int destination, Tree *tree );
+		static void Extend( Tree *tree, unsigned int firstNew );
+
+		static bool built;
+		static vector<Node> nodes;
+		static map<string,int> nodeIndex;  ///< The Node of each name.
+		static map<int,Tree> trees;        ///< Every Tree computed so far, by destination Node.
+		static vector<bool> done;          ///< Reusable buffer for Solve.
+		static vector<int> pending;        ///< Reusable buffer for Extend.
+};
+
+#endif // __H_GATEROUTES__
@@ -0,0 +1,140 @@
+/**\file			kinematics.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Positions and velocities of every Sprite in flat arrays.
+ * \details
+ */
+
+#include "includes.h"
+#include "Sprites/kinematics.h"
+#include "Utilities/timer.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class Kinematics
+ * \brief The positions and momentums of all Sprites.
+ * \details
+ * Rather than each Sprite keeping its own Coordinates, every Sprite owns a
+ * slot in a set of parallel arrays (a structure of arrays).  The Sprite
+ * accessors like GetWorldPosition and SetMomentum read and write their slot.
+ *
+ * Keeping each value in its own contiguous array lets IntegrateRange move
+ * every Sprite in one simple loop that the compiler can vectorize, rather than
+ * making one virtual call per Sprite.
+ *
+ * Slots are reused after their Sprite is deleted, so the arrays only grow to
+ * the largest number of Sprites alive at once.  Free slots have no momentum
+ * and are harmlessly integrated along with the rest.
+ *
+ * \warn Slots may only be Allocated or Freed on the main thread, and never
+ *       while the Job threads are integrating.
+ * \see KinematicSlot
+ */
+
+vector<double> Kinematics::x;
+vector<double> Kinematics::y;
+vector<double> Kinematics::vx;
+vector<double> Kinematics::vy;
+vector<double> Kinematics::lastVx;
+vector<double> Kinematics::lastVy;
+vector<double> Kinematics::ax;
+vector<double> Kinematics::ay;
+vector<double> Kinematics::moveX;
+vector<double> Kinematics::moveY;
+vector<Uint32> Kinematics::frame;
+vector<unsigned int> Kinematics::freeSlots;
+
+/**\brief Claim a zeroed slot.
+ */
+unsigned int Kinematics::Allocate() {
+	unsigned int slot;
+	if( freeSlots.empty() ) {
+		slot = x.size();
+		x.push_back( 0. ); y.push_back( 0. );
+		vx.push_back( 0. ); vy.push_back( 0. );
+		lastVx.push_back( 0. ); lastVy.push_back( 0. );
+		ax.push_back( 0. ); ay.push_back( 0. );
+		moveX.push_back( 0. ); moveY.push_back( 0. );
+		frame.push_back( 0 );
+	} else {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	frame[slot] = Timer::GetLogicalFrameCount();
+	return slot;
+}
+
+/**\brief Release a slot so that it can be reused.
+ */
+void Kinematics::Free( unsigned int slot ) {
+	x[slot] = y[slot] = 0.;
+	vx[slot] = vy[slot] = 0.;
+	lastVx[slot] = lastVy[slot] = 0.;
+	ax[slot] = ay[slot] = 0.;
+	moveX[slot] = moveY[slot] = 0.;
+	freeSlots.push_back( slot );
+}
+
+/**\brief Copy every value from one slot to another.
+ */
+void Kinematics::Copy( unsigned int from, unsigned int to ) {
+	x[to] = x[from]; y[to] = y[from];
+	vx[to] = vx[from]; vy[to] = vy[from];
+	lastVx[to] = lastVx[from]; lastVy[to] = lastVy[from];
+	ax[to] = ax[from]; ay[to] = ay[from];
+	moveX[to] = moveX[from]; moveY[to] = moveY[from];
+	frame[to] = frame[from];
+}
+
+/**\brief Move one slot by its momentum for every frame since it last moved.
+ * \details A slot that was already integrated during this frame is left alone.
+ */
+void Kinematics::Integrate( unsigned int slot, Uint32 currentFrame ) {
+	if( frame[slot] == currentFrame ) {
+		return;
+	}
+	IntegrateRange( slot, slot + 1, currentFrame );
+}
+
+/**\brief Move every slot from first up to (but not including) last.
+ * \details This is the same math as Integrate, but without any branches so
+ *          that the loop vectorizes.
+ */
+void Kinematics::IntegrateRange( unsigned int first, unsigned int last, Uint32 currentFrame ) {
+	if( first >= last ) {
+		return;
+	}
+	double *px = &x[0], *py = &y[0];
+	double *pvx = &vx[0], *pvy = &vy[0];
+	double *plx = &lastVx[0], *ply = &lastVy[0];
+	double *pax = &ax[0], *pay = &ay[0];
+	double *pmx = &moveX[0], *pmy = &moveY[0];
+	Uint32 *pframe = &frame[0];
+
+	// The arrays never overlap, but the compiler can't prove it.
+#ifdef __GNUC__
+#pragma GCC ivdep
+#endif
+	for( unsigned int i = first; i < last; ++i ) {
+		// Apply their momentum as often as the number of frames that were skipped
+		const Uint32 skipped = (currentFrame > pframe[i]) ? (currentFrame - pframe[i]) : (pframe[i] - currentFrame);
+		const double frames = static_cast<double>( static_cast<int>(skipped) );
+		pframe[i] = currentFrame;
+
+		pmx[i] = pvx[i] * frames;
+		pmy[i] = pvy[i] * frames;
+		px[i] += pmx[i];
+		py[i] += pmy[i];
+
+		// The acceleration does not care about the skipped frames
+		pax[i] = plx[i] - pvx[i];
+		pay[i] = ply[i] - pvy[i];
+		plx[i] = pvx[i];
+		ply[i] = pvy[i];
+	}
+}
+
+/** @} */
@@ -0,0 +1,60 @@
+/**\file			kinematics.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Positions and velocities of every Sprite in flat arrays.
+ * \details
+ */
+
+#ifndef __H_KINEMATICS__
+#define __H_KINEMATICS__
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+
+class Kinematics {
+	public:
+		static unsigned int Allocate();
+		static void Free( unsigned int slot );
+		static void Copy( unsigned int from, unsigned int to );
+
+		static unsigned int GetNumSlots() { return x.size(); }
+
+		static Coordinate GetPosition( unsigned int slot ) { return Coordinate( x[slot], y[slot] ); }
+		static void SetPosition( unsigned int slot, Coordinate c ) { x[slot] = c.GetX(); y[slot] = c.GetY(); }
+		static Coordinate GetVelocity( unsigned int slot ) { return Coordinate( vx[slot], vy[slot] ); }
+		static void SetVelocity( unsigned int slot, Coordinate c ) { vx[slot] = c.GetX(); vy[slot] = c.GetY(); }
+		static Coordinate GetAcceleration( unsigned int slot ) { return Coordinate( ax[slot], ay[slot] ); }
+		static Coordinate GetMove( unsigned int slot ) { return Coordinate( moveX[slot], moveY[slot] ); }
+		static Uint32 GetFrame( unsigned int slot ) { return frame[slot]; }
+
+		static void Integrate( unsigned int slot, Uint32 currentFrame );
+		static void IntegrateRange( unsigned int first, unsigned int last, Uint32 currentFrame );
+
+	private:
+		// Each array is indexed by slot.
+		static vector<double> x, y;             ///< World position.
+		static vector<double> vx, vy;           ///< Momentum, in pixels per logical frame.
+		static vector<double> lastVx, lastVy;   ///< Momentum after the previous integration.
+		static vector<double> ax, ay;           ///< Change in momentum during the previous integration.
+		static vector<double> moveX, moveY;     ///< How far the previous integration moved the slot.
+		static vector<Uint32> frame;            ///< The logical frame of the previous integration.
+
+		static vector<unsigned int> freeSlots;  ///< Slots that are not owned by any Sprite.
+};
+
+/**\brief A Sprite's slot in the Kinematics arrays.
+ * \details The slot is allocated and freed with the Sprite.  Copying a Sprite
+ *          gives the copy its own slot holding the same values.
+ */
+class KinematicSlot {
+	public:
+		KinematicSlot() : index( Kinematics::Allocate() ) {}
+		KinematicSlot( const KinematicSlot& other ) : index( Kinematics::Allocate() ) { Kinematics::Copy( other.index, index ); }
+		KinematicSlot& operator=( const KinematicSlot& other ) { Kinematics::Copy( other.index, index ); return *this; }
+		~KinematicSlot() { Kinematics::Free( index ); }
+
+		unsigned int index;
+};
+
+#endif // __H_KINEMATICS__
@@ -0,0 +1,188 @@
+/**\file			narrowphase.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Swept collision tests between Projectiles and Ships.
+ * \details
+ */
+
+#include "includes.h"
+#include "Sprites/narrowphase.h"
+#include "Sprites/projectile.h"
+#include "Sprites/ship.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class Narrowphase
+ * \brief Finds exactly which Projectiles hit which Ships during a tick.
+ * \details
+ * Each Projectile is treated as the line segment that it travelled during
+ * the tick, and each Ship as a circle that travelled along its own segment.
+ * Testing the Projectile's motion relative to the Ship means that fast
+ * Projectiles can no longer pass through a small Ship between two ticks.
+ *
+ * The SpriteManager fills a Narrowphase with the Projectiles of one Quadrant
+ * and the Ships that the broadphase finds near them.  Both are sorted along
+ * the x axis so that each Projectile is only tested against the Ships whose
+ * sweeps overlap it.
+ *
+ * \see SpriteManager::FindContacts
+ */
+
+/**\brief Remove all Projectiles and Ships.
+ */
+void Narrowphase::Clear() {
+	projectiles.clear();
+	ships.clear();
+}
+
+/**\brief Add a Projectile that moved this tick.
+ */
+void Narrowphase::AddProjectile( Projectile *projectile ) {
+	Sweep sweep;
+	MakeSweep( projectile, 0.0f, &sweep );
+	sweep.ownerID = projectile->GetOwnerID();
+	projectiles.push_back( sweep );
+}
+
+/**\brief Add a Ship that may be hit this tick.
+ */
+void Narrowphase::AddShip( Ship *ship ) {
+	Sweep sweep;
+	MakeSweep( ship, static_cast<float>(ship->GetRadarSize()), &sweep );
+	ships.push_back( sweep );
+}
+
+/**\brief The smallest circle around the paths of every Projectile.
+ * \details This is the region that the broadphase should search for Ships.
+ */
+void Narrowphase::GetProjectileBounds( Coordinate *center, float *radius ) {
+	if( projectiles.empty() ) {
+		*center = Coordinate( 0, 0 );
+		*radius = 0.0f;
+		return;
+	}
+
+	float minX = projectiles[0].minX, maxX = projectiles[0].maxX;
+	float minY = projectiles[0].minY, maxY = projectiles[0].maxY;
+	for( unsigned int p = 1; p < projectiles.size(); ++p ) {
+		minX = min( minX, projectiles[p].minX );
+		maxX = max( maxX, projectiles[p].maxX );
+		minY = min( minY, projectiles[p].minY );
+		maxY = max( maxY, projectiles[p].maxY );
+	}
+
+	*center = Coordinate( (minX + maxX) / 2.0f, (minY + maxY) / 2.0f );
+	*radius = sqrtf( (maxX - minX)*(maxX - minX) + (maxY - minY)*(maxY - minY) ) / 2.0f;
+}
+
+/**\brief Find the first Ship that each Projectile hit.
+ * \param contacts [out] One Contact per Projectile that hit a Ship is appended here.
+ * \details A Projectile never hits the Ship that fired it.
+ */
+void Narrowphase::Collide( vector<Contact> *contacts ) {
+	unsigned int next = 0;
+	active.clear();
+
+	stable_sort( projectiles.begin(), projectiles.end(), CompareMinX );
+	stable_sort( ships.begin(), ships.end(), CompareMinX );
+
+	for( unsigned int p = 0; p < projectiles.size(); ++p ) {
+		Sweep& projectile = projectiles[p];
+
+		// Start tracking the Ships that begin before this Projectile ends.
+		while( next < ships.size() && ships[next].minX <= projectile.maxX ) {
+			active.push_back( next++ );
+		}
+
+		// The Projectiles are sorted by where they begin, so Ships that end
+		// before this Projectile begins can't be hit by any of the rest.
+		unsigned int kept = 0;
+		for( unsigned int a = 0; a < active.size(); ++a ) {
+			if( ships[ active[a] ].maxX >= projectile.minX ) {
+				active[kept++] = active[a];
+			}
+		}
+		active.resize( kept );
+
+		Contact contact;
+		contact.ship = NULL;
+		contact.time = 2.0f;
+		for( unsigned int a = 0; a < active.size(); ++a ) {
+			Sweep& ship = ships[ active[a] ];
+			if( ship.minX > projectile.maxX
+			 || ship.maxY < projectile.minY
+			 || ship.minY > projectile.maxY
+			 || ship.sprite->GetID() == projectile.ownerID ) {
+				continue;
+			}
+
+			float time;
+			if( SweepCircle( projectile.start - ship.start, projectile.move - ship.move, ship.radius + projectile.radius, &time )
+			 && time < contact.time ) {
+				contact.ship = (Ship*)ship.sprite;
+				contact.time = time;
+			}
+		}
+
+		if( contact.ship != NULL ) {
+			contact.projectile = (Projectile*)projectile.sprite;
+			contact.point = projectile.start + projectile.move * contact.time;
+			contacts->push_back( contact );
+		}
+	}
+}
+
+/**\brief Check if a moving point passes through a circle at the origin.
+ * \param start Where the point begins, relative to the center of the circle.
+ * \param move How far the point moves.
+ * \param radius The radius of the circle.
+ * \param time [out] How far along the move the point first touches the circle, from 0 to 1.
+ * \returns True if the point touches the circle.
+ */
+bool Narrowphase::SweepCircle( Coordinate start, Coordinate move, float radius, float *time ) {
+	const double c = start.GetX()*start.GetX() + start.GetY()*start.GetY() - double(radius)*radius;
+	if( c <= 0.0 ) {
+		// Already inside.
+		*time = 0.0f;
+		return true;
+	}
+
+	const double a = move.GetX()*move.GetX() + move.GetY()*move.GetY();
+	const double b = start.GetX()*move.GetX() + start.GetY()*move.GetY();
+	if( a == 0.0 || b >= 0.0 ) {
+		// Not moving, or moving away.
+		return false;
+	}
+
+	const double discriminant = b*b - a*c;
+	if( discriminant < 0.0 ) {
+		return false;
+	}
+
+	const double t = (-b - sqrt( discriminant )) / a;
+	if( t > 1.0 ) {
+		return false;
+	}
+	*time = static_cast<float>(t);
+	return true;
+}
+
+/**\brief Record the path that a Sprite took during this tick.
+ */
+void Narrowphase::MakeSweep( Sprite *sprite, float radius, Sweep *sweep ) {
+	Coordinate end = sprite->GetWorldPosition();
+	sweep->sprite = sprite;
+	sweep->ownerID = 0;
+	sweep->move = sprite->GetLastMove();
+	sweep->start = end - sweep->move;
+	sweep->radius = radius;
+	sweep->minX = static_cast<float>( min( sweep->start.GetX(), end.GetX() ) ) - radius;
+	sweep->maxX = static_cast<float>( max( sweep->start.GetX(), end.GetX() ) ) + radius;
+	sweep->minY = static_cast<float>( min( sweep->start.GetY(), end.GetY() ) ) - radius;
+	sweep->maxY = static_cast<float>( max( sweep->start.GetY(), end.GetY() ) ) + radius;
+}
+
+/** @} */
@@ -0,0 +1,66 @@
+/**\file			narrowphase.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Swept collision tests between Projectiles and Ships.
+ * \details
+ */
+
+#ifndef __H_NARROWPHASE__
+#define __H_NARROWPHASE__
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+#include "Sprites/sprite.h"
+
+/// How far past the Projectiles to search for Ships.  This covers the size
+/// of the Ships and how far they moved this tick.
+#define NARROWPHASE_MARGIN 100.0f
+
+class Sprite;
+class Ship;
+class Projectile;
+
+/**\brief A Projectile that hit a Ship during this tick.
+ */
+struct Contact {
+	Projectile *projectile;
+	Ship *ship;
+	float time;        ///< How far through this tick the hit happened, from 0 to 1.
+	Coordinate point;  ///< Where the Projectile was when it hit.
+};
+
+class Narrowphase {
+	public:
+		void Clear();
+		void AddProjectile( Projectile *projectile );
+		void AddShip( Ship *ship );
+
+		unsigned int GetNumProjectiles() { return projectiles.size(); }
+		void GetProjectileBounds( Coordinate *center, float *radius );
+
+		void Collide( vector<Contact> *contacts );
+
+		static bool SweepCircle( Coordinate start, Coordinate move, float radius, float *time );
+
+	private:
+		/// The path that one Sprite took during this tick.
+		struct Sweep {
+			Sprite *sprite;
+			SpriteHandle ownerID;  ///< The Ship that fired this Projectile.
+			Coordinate start;      ///< Where the Sprite was at the beginning of the tick.
+			Coordinate move;       ///< How far the Sprite moved during the tick.
+			float radius;
+			float minX, maxX;      ///< The horizontal span of the Sweep, including the radius.
+			float minY, maxY;      ///< The vertical span of the Sweep, including the radius.
+		};
+
+		static void MakeSweep( Sprite *sprite, float radius, Sweep *sweep );
+		static bool CompareMinX( const Sweep& a, const Sweep& b ) { return a.minX < b.minX; }
+
+		vector<Sweep> projectiles;
+		vector<Sweep> ships;
+		vector<unsigned int> active; ///< Reusable buffer for Collide.
+};
+
+#endif // __H_NARROWPHASE__
@@ -0,0 +1,228 @@
+/**\file			perception.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A packed snapshot of what an AI can see, for Lua.
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/alliances.h"
+#include "Engine/simulation_lua.h"
+#include "Sprites/ai.h"
+#include "Sprites/perception.h"
+#include "Sprites/planets.h"
+#include "Sprites/spritemanager.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class Perception
+ * \brief Everything near a Ship, gathered with one search.
+ *
+ * AI scripts used to build their view of the world one call at a time
+ * (Epiar.getSprite, GetPosition, GetHull, nearestShip, ...), each of which
+ * crossed into C++.  Ship:Perceive(radius) instead returns one table:
+ *
+ * \code
+ * snapshot = {
+ *   hostiles   = { count=n, id={...}, x={...}, y={...}, vx={...}, vy={...},
+ *                  hull={...}, alliance={...}, distance={...} },
+ *   friendlies = { ... },
+ *   planets    = { ... },
+ *   gates      = { ... },
+ * }
+ * \endcode
+ *
+ * Each category is sorted from nearest to farthest, and the i'th entry of a
+ * category is (id[i], x[i], y[i], ...).  Hostiles are Ships of any other
+ * Alliance (and the Player), friendlies are Ships of the same Alliance.  The
+ * Ship itself is left out.  The alliance field is the position of the
+ * Alliance in Epiar.alliances(), or 0 for none.
+ *
+ * \warn The same tables are refilled by every call, so nothing is allocated
+ *       once they have grown.  Copy out anything that needs to outlive the
+ *       next call to Perceive.
+ */
+
+int Perception::snapshot = LUA_NOREF;
+unsigned int Perception::counts[PERCEPTION_CATEGORIES];
+vector<Sprite*> Perception::found;
+vector<Sprite*> Perception::categories[PERCEPTION_CATEGORIES];
+map<Alliance*,int> Perception::allianceIDs;
+
+static const char* categoryNames[PERCEPTION_CATEGORIES] = { "hostiles", "friendlies", "planets", "gates" };
+static const char* fieldNames[PERCEPTION_FIELDS] = { "id", "x", "y", "vx", "vy", "hull", "alliance", "distance" };
+
+/**\brief Push a snapshot of everything within a radius of a Ship.
+ * \param limit The most Sprites to return in each category.
+ */
+void Perception::Perceive( lua_State *L, Ship *self, float radius, unsigned int limit ) {
+	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
+	Coordinate center = self->GetWorldPosition();
+	// The Player is also a Ship, but has no Alliance.
+	Alliance *alliance = (self->GetDrawOrder() == DRAW_ORDER_SHIP) ? ((AI*)self)->GetAlliance() : NULL;
+
+	found.clear();
+	sprites->GetSpritesNear( center, radius, &found, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET | DRAW_ORDER_GATE_TOP, true );
+
+	int c;
+	for( c = 0; c < PERCEPTION_CATEGORIES; ++c ) {
+		categories[c].clear();
+	}
+	for( unsigned int i = 0; i < found.size(); ++i ) {
+		Sprite *sprite = found[i];
+		switch( sprite->GetDrawOrder() ) {
+			case DRAW_ORDER_SHIP:
+				if( sprite == self ) {
+					continue;
+				}
+				c = ( alliance != NULL && ((AI*)sprite)->GetAlliance() == alliance ) ? PERCEPTION_FRIENDLIES : PERCEPTION_HOSTILES;
+				break;
+			case DRAW_ORDER_PLAYER:
+				if( sprite == self ) {
+					continue;
+				}
+				c = PERCEPTION_HOSTILES;
+				break;
+			case DRAW_ORDER_PLANET:
+				c = PERCEPTION_PLANETS;
+				break;
+			default:
+				c = PERCEPTION_GATES;
+				break;
+		}
+		if( categories[c].size() < limit ) {
+			categories[c].push_back( sprite );
+		}
+	}
+
+	PushSnapshot( L );
+	for( c = 0; c < PERCEPTION_CATEGORIES; ++c ) {
+		Fill( L, c, center );
+	}
+}
+
+/**\brief Forget the snapshot table.
+ * \details Call this when a new lua_State is created.
+ */
+void Perception::Reset() {
+	snapshot = LUA_NOREF;
+	memset( counts, 0, sizeof(counts) );
+	allianceIDs.clear();
+}
+
+/**\brief Push the snapshot table, creating it the first time.
+ */
+void Perception::PushSnapshot( lua_State *L ) {
+	if( snapshot != LUA_NOREF ) {
+		lua_rawgeti( L, LUA_REGISTRYINDEX, snapshot );
+		return;
+	}
+
+	lua_createtable( L, 0, PERCEPTION_CATEGORIES );
+	for( int c = 0; c < PERCEPTION_CATEGORIES; ++c ) {
+		lua_createtable( L, 0, PERCEPTION_FIELDS + 1 );
+		lua_pushinteger( L, 0 );
+		lua_setfield( L, -2, "count" );
+		for( int f = 0; f < PERCEPTION_FIELDS; ++f ) {
+			lua_createtable( L, PERCEPTION_DEFAULT_LIMIT, 0 );
+			lua_setfield( L, -2, fieldNames[f] );
+		}
+		lua_setfield( L, -2, categoryNames[c] );
+		counts[c] = 0;
+	}
+	lua_pushvalue( L, -1 );
+	snapshot = luaL_ref( L, LUA_REGISTRYINDEX );
+}
+
+/**\brief Copy one category into the snapshot table on the top of the stack.
+ */
+void Perception::Fill( lua_State *L, int category, Coordinate center ) {
+	const int initialStackTop = lua_gettop( L );
+	vector<Sprite*>& sprites = categories[category];
+	const unsigned int count = sprites.size();
+
+	lua_getfield( L, initialStackTop, categoryNames[category] );
+	const int table = lua_gettop( L );
+	lua_pushinteger( L, count );
+	lua_setfield( L, table, "count" );
+
+	// Every field table stays on the stack, at table+1+field.
+	int f;
+	for( f = 0; f < PERCEPTION_FIELDS; ++f ) {
+		lua_getfield( L, table, fieldNames[f] );
+	}
+
+	for( unsigned int i = 0; i < count; ++i ) {
+		Sprite *sprite = sprites[i];
+		Coordinate position = sprite->GetWorldPosition();
+		Coordinate momentum = sprite->GetMomentum();
+		double hull = 1.0;
+		int alliance = 0;
+		switch( sprite->GetDrawOrder() ) {
+			case DRAW_ORDER_SHIP:
+				hull = ((Ship*)sprite)->GetHullIntegrityPct();
+				alliance = GetAllianceID( L, ((AI*)sprite)->GetAlliance() );
+				break;
+			case DRAW_ORDER_PLAYER:
+				hull = ((Ship*)sprite)->GetHullIntegrityPct();
+				break;
+			case DRAW_ORDER_PLANET:
+				alliance = GetAllianceID( L, ((Planet*)sprite)->GetAlliance() );
+				break;
+		}
+
+		const double values[PERCEPTION_FIELDS] = {
+			static_cast<double>( sprite->GetID() ),
+			position.GetX(), position.GetY(),
+			momentum.GetX(), momentum.GetY(),
+			hull,
+			static_cast<double>( alliance ),
+			(position - center).GetMagnitude(),
+		};
+		for( f = 0; f < PERCEPTION_FIELDS; ++f ) {
+			lua_pushnumber( L, values[f] );
+			lua_rawseti( L, table + 1 + f, i + 1 );
+		}
+	}
+
+	// Clear out whatever is left over from the last snapshot so that # still works.
+	for( unsigned int i = count; i < counts[category]; ++i ) {
+		for( f = 0; f < PERCEPTION_FIELDS; ++f ) {
+			lua_pushnil( L );
+			lua_rawseti( L, table + 1 + f, i + 1 );
+		}
+	}
+	counts[category] = count;
+
+	lua_settop( L, initialStackTop );
+}
+
+/**\brief The position of an Alliance in Epiar.alliances(), starting from 1.
+ * \returns 0 if there is no Alliance.
+ */
+int Perception::GetAllianceID( lua_State *L, Alliance *alliance ) {
+	if( alliance == NULL ) {
+		return 0;
+	}
+	map<Alliance*,int>::iterator known = allianceIDs.find( alliance );
+	if( known != allianceIDs.end() ) {
+		return known->second;
+	}
+
+	// The Alliances are rarely changed, so only rebuild the IDs when a new one shows up.
+	allianceIDs.clear();
+	Alliances *alliances = Simulation_Lua::GetSimulation(L)->GetAlliances();
+	list<string> *names = alliances->GetNames();
+	int id = 1;
+	for( list<string>::iterator name = names->begin(); name != names->end(); ++name, ++id ) {
+		allianceIDs[ alliances->GetAlliance( *name ) ] = id;
+	}
+	known = allianceIDs.find( alliance );
+	return (known != allianceIDs.end()) ? known->second : 0;
+}
+
+/** @} */
@@ -0,0 +1,47 @@
+/**\file			perception.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A packed snapshot of what an AI can see, for Lua.
+ * \details
+ */
+
+#ifndef __H_PERCEPTION__
+#define __H_PERCEPTION__
+
+#include "includes.h"
+#include "Utilities/lua.h"
+#include "Utilities/coordinate.h"
+
+#define PERCEPTION_HOSTILES   0 ///< Ships of any other Alliance, including the Player.
+#define PERCEPTION_FRIENDLIES 1 ///< Ships of the same Alliance.
+#define PERCEPTION_PLANETS    2
+#define PERCEPTION_GATES      3
+#define PERCEPTION_CATEGORIES 4
+
+#define PERCEPTION_FIELDS     8 ///< id, x, y, vx, vy, hull, alliance, distance
+
+#define PERCEPTION_DEFAULT_LIMIT 16 ///< Sprites per category, unless the script asks for more.
+
+class Sprite;
+class Ship;
+class Alliance;
+
+class Perception {
+	public:
+		static void Perceive( lua_State *L, Ship *self, float radius, unsigned int limit );
+		static void Reset();
+
+	private:
+		static void PushSnapshot( lua_State *L );
+		static void Fill( lua_State *L, int category, Coordinate center );
+		static int GetAllianceID( lua_State *L, Alliance *alliance );
+
+		static int snapshot;                                 ///< Registry reference to the snapshot table.
+		static unsigned int counts[PERCEPTION_CATEGORIES];   ///< How many entries each category held after the last Perceive.
+		static vector<Sprite*> found;                        ///< Reusable buffer for the nearby Sprites.
+		static vector<Sprite*> categories[PERCEPTION_CATEGORIES]; ///< Reusable buffers for the Sprites of each category.
+		static map<Alliance*,int> allianceIDs;               ///< Position of each Alliance in Epiar.alliances().
+};
+
+#endif // __H_PERCEPTION__
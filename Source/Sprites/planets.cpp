@@ -18,6 +18,7 @@
 #include "Engine/alliances.h"
 #include "Engine/simulation_lua.h"
 #include "Sprites/spritemanager.h"
+#include "Sprites/gateroutes.h"
 
 /** \addtogroup Sprites
  * @{
@@ -54,6 +55,9 @@ Planet& Planet::operator=(const Planet& other) {
 	assert( other.GetImage() );
 	assert( other.GetAlliance() );
 
+	// The routes through this Planet may have changed.
+	GateRoutes::Moved( name );
+
 	name = other.name;
 	alliance = other.alliance;
 	landable = other.landable;
@@ -159,13 +163,22 @@ bool Planet::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"image")) ){
-		Image* image = Image::Get( NodeToString(doc,attr) );
+		// With its size, the image can load in the background without changing the radar size
+		int imageWidth = 0, imageHeight = 0;
+		xmlNodePtr size;
+		if( (size = FirstChildNamed(node,"imageWidth")) ){
+			imageWidth = atoi( NodeToString(doc,size).c_str() );
+		}
+		if( (size = FirstChildNamed(node,"imageHeight")) ){
+			imageHeight = atoi( NodeToString(doc,size).c_str() );
+		}
+		Image* image = Image::GetAsync( NodeToString(doc,attr), imageWidth, imageHeight );
 		Image::Store(name, image);
 		SetImage(image);
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"surface-image")) ){
-		this->surface = Image::Get( NodeToString(doc,attr) );
+		this->surface = Image::GetAsync( NodeToString(doc,attr) );
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"summary")) ){
@@ -200,14 +213,28 @@ void Planet::Update( lua_State *L ) {
 	Sprite::Update( L );
 }
 
+/**\brief Counts Sprites until a limit is reached.
+ */
+class TrafficCounter : public SpriteVisitor {
+	public:
+		TrafficCounter( unsigned int _limit ) : count(0), limit(_limit) {}
+		bool Visit( Sprite *sprite ) { return ++count < limit; }
+		unsigned int count;
+		unsigned int limit;
+};
+
 void Planet::GenerateTraffic( lua_State *L ) {
 	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
-	list<Sprite*> *nearbySprites = sprites->GetSpritesNear( GetWorldPosition(), TO_FLOAT(sphereOfInfluence), DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER);
 
-	if( nearbySprites->size() < traffic ) {
+	// Only count as many ships as are needed to know if there is enough traffic.
+	TrafficCounter counter( traffic );
+	if( traffic > 0 ) {
+		sprites->VisitSpritesNear( GetWorldPosition(), TO_FLOAT(sphereOfInfluence), &counter, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER, false, traffic );
+	}
+
+	if( counter.count < traffic ) {
 		Lua::Call( "createRandomShipForPlanet", "i", GetID() );
 	}
-	delete nearbySprites;
 	lastTrafficTime = Timer::GetLogicalFrameCount();
 }
 
@@ -295,6 +322,10 @@ xmlNodePtr Planet::ToXMLNode(string componentName) {
 	snprintf(buff, sizeof(buff), "%d", GetTraffic() );
 	xmlNewChild(section, NULL, BAD_CAST "traffic", BAD_CAST buff );
 	xmlNewChild(section, NULL, BAD_CAST "image", BAD_CAST GetImage()->GetPath().c_str() );
+	snprintf(buff, sizeof(buff), "%d", GetImage()->GetWidth() );
+	xmlNewChild(section, NULL, BAD_CAST "imageWidth", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", GetImage()->GetHeight() );
+	xmlNewChild(section, NULL, BAD_CAST "imageHeight", BAD_CAST buff );
 	xmlNewChild(section, NULL, BAD_CAST "surface-image", BAD_CAST surface->GetPath().c_str() );
 	snprintf(buff, sizeof(buff), "%d", GetMilitiaSize() );
 	xmlNewChild(section, NULL, BAD_CAST "militia", BAD_CAST buff );
@@ -92,8 +92,8 @@ int Planets_Lua::Get(lua_State* L){
         }
     } else if(lua_isnumber(L,1)) {
         int id = (int)luaL_checkinteger(L,1);
-        p = (Planet*)Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id);
-        if (p==NULL || p->GetDrawOrder() != DRAW_ORDER_PLANET){
+        p = (Planet*)Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(id, DRAW_ORDER_PLANET);
+        if (p==NULL){
             return luaL_error(L, "There is no planet with ID %d", id);
         }
     } else {
@@ -208,16 +208,13 @@ Planet **Planets_Lua::pushPlanet(lua_State *L){
 /**\brief Check that the a Lua value really is a Planet
  */
 Planet *Planets_Lua::checkPlanet(lua_State *L, int index){
-	int *idptr;
-	idptr = (int*)luaL_checkudata(L, index, EPIAR_PLANET);
+	SpriteHandle *idptr;
+	idptr = (SpriteHandle*)luaL_checkudata(L, index, EPIAR_PLANET);
 	luaL_argcheck(L, idptr != NULL, index, "`EPIAR_PLANET' expected");
 
 	Sprite* s;
-	s = Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(*idptr);
+	s = Simulation_Lua::GetSimulation(L)->GetSpriteManager()->GetSpriteByID(*idptr, DRAW_ORDER_PLANET);
 	if ((s) == NULL) luaL_typerror(L, index, EPIAR_PLANET);
-	if (0==((s)->GetDrawOrder() & DRAW_ORDER_PLANET)){
-		luaL_typerror(L, index, EPIAR_PLANET);
-	}
 	return (Planet*)s;
 }
 
@@ -81,6 +81,7 @@ Player* Player::Load( string filename ) {
 void Player::SetLuaControlFunc( string _luaControlFunc ) {
 	LogMsg(INFO, "Setting Player control to '%s'", _luaControlFunc.c_str() );
 	luaControlFunc = _luaControlFunc;
+	luaControlChunk = (luaControlFunc != "") ? Lua::Compile( luaControlFunc ) : LUA_NOREF;
 }
 
 /**\brief Return full control to the player.
@@ -88,6 +89,7 @@ void Player::SetLuaControlFunc( string _luaControlFunc ) {
 void Player::RemoveLuaControlFunc() {
 	LogMsg(INFO, "Clearing Player control '%s'", luaControlFunc.c_str() );
 	luaControlFunc = "";
+	luaControlChunk = LUA_NOREF;
 }
 
 /**\brief Fetch the current player Instance
@@ -190,6 +192,7 @@ void Player::Land( lua_State *L, Planet* planet ){
  */
 Player::Player() {
 	this->SetRadarColor( WHITE );
+	luaControlChunk = LUA_NOREF;
 }
 
 /**\brief Destructor
@@ -212,8 +215,8 @@ void Player::Update( lua_State *L ) {
 		}
 	}
 
-	if(luaControlFunc != ""){
-		Lua::Run(luaControlFunc);
+	if(luaControlChunk != LUA_NOREF){
+		Lua::RunChunk(luaControlChunk);
 	}
 
 	Ship::Update( L );
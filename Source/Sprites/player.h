@@ -69,6 +69,7 @@ class Player : public Ship {
 		list<Mission*> missions;
 		map<Alliance*,int> favor;
 		string luaControlFunc;
+		int luaControlChunk; ///< The compiled luaControlFunc.
 
 		// This list of hired escorts is only needed for XML saving/loading and doesn't control the game itself.
 		// Escorts from missions should not be listed here.
@@ -72,8 +72,9 @@ Projectile::~Projectile(void)
 /**\brief Update the Projectile
  *
  * Projectiles do all the normal Sprite things like moving.
- * Projectiles check for collisions with nearby Ships, and if they collide,
- * they deal damage to that ship. Note that since each projectile knows which ship fired it and will never collide with them.
+ * The SpriteManager checks the whole path that each Projectile took this tick
+ * for collisions with Ships, and if they collide, the Projectile is Hit and
+ * deals damage to that ship. Note that since each projectile knows which ship fired it and will never collide with them.
  *
  * Projectiles have a life time limit (in milli-seconds).  Each tick they need
  * to check if they've lived too long and need to disappear.
@@ -81,34 +82,24 @@ Projectile::~Projectile(void)
  * Projectiles have the ability to track down a specific target.  This only
  * means that they will turn slightly to head towards their target.
  */
-void Projectile::Update( lua_State *L ) {
-	Sprite::Update( L ); // update momentum and other generic sprite attributes
-	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
-
-	// Check for projectile collisions
-	Sprite* impact = sprites->GetNearestSprite( (Sprite*)this, 100,DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER );
-	if( (impact != NULL) && (impact->GetID() != ownerID) && ((this->GetWorldPosition() - impact->GetWorldPosition()).GetMagnitude() < impact->GetRadarSize() )) {
-		int damageDone=(weapon->GetPayload())*damageBoost;
-		((Ship*)impact)->Damage( damageDone );
-		if(impact->GetDrawOrder()==DRAW_ORDER_SHIP)
-			((AI*)impact)->AddEnemy(ownerID,damageDone);
-		sprites->Delete( (Sprite*)this );
-		
-		// Create a fire burst where this projectile hit the ship's shields.
-		// TODO: This shows how much we need to improve our collision detection.
-		Effect* hit = new Effect(this->GetWorldPosition(), "Resources/Animations/shield.ani", 0);
-		hit->SetAngle( -this->GetAngle() );
-		hit->SetMomentum( impact->GetMomentum() );
-		sprites->Add( hit );
-	}
+void Projectile::UpdatePhysics( void ) {
+	Sprite::UpdatePhysics(); // update momentum and other generic sprite attributes
 
 	// Expire the projectile after a time period
 	if (( Timer::GetTicks() > secondsOfLife + start )) {
-		sprites->Delete( (Sprite*)this );
+		SpriteManager::Instance()->Delete( (Sprite*)this );
 	}
+}
+
+/**\brief Track the target.
+ * \details Collisions were already found by the SpriteManager.
+ * \see Hit
+ */
+void Projectile::Update( lua_State *L ) {
+	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
 
 	// Track the target
-	Sprite* target = sprites->GetSpriteByID( targetID );
+	Sprite* target = sprites->GetSpriteByID( targetID, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER );
 	float tracking = weapon->GetTracking();
 	if( target != NULL && tracking > 0.00000001f ) {
 		float angleTowards = normalizeAngle( ( target->GetWorldPosition() - this->GetWorldPosition() ).GetAngle() - GetAngle() );
@@ -117,5 +108,26 @@ void Projectile::Update( lua_State *L ) {
 	}
 }
 
+/**\brief Damage the Ship that this Projectile hit and then disappear.
+ * \param contact Where and when the hit happened.
+ * \see SpriteManager::FindContacts
+ */
+void Projectile::Hit( Contact *contact ) {
+	SpriteManager *sprites = SpriteManager::Instance();
+	Ship *impact = contact->ship;
+
+	int damageDone=(weapon->GetPayload())*damageBoost;
+	impact->Damage( damageDone );
+	if(impact->GetDrawOrder()==DRAW_ORDER_SHIP)
+		((AI*)impact)->AddEnemy(ownerID,damageDone);
+	sprites->Delete( (Sprite*)this );
+
+	// Create a fire burst where this projectile hit the ship's shields.
+	Effect* hit = new Effect(contact->point, "Resources/Animations/shield.ani", 0);
+	hit->SetAngle( -this->GetAngle() );
+	hit->SetMomentum( impact->GetMomentum() );
+	sprites->Add( hit );
+}
+
 /** @} */
 
@@ -12,6 +12,7 @@
 
 #include "Sprites/sprite.h"
 #include "Engine/weapons.h"
+#include "Sprites/narrowphase.h"
 #include "includes.h"
 class Projectile :
 	public Sprite
@@ -19,17 +20,20 @@ class Projectile :
 public:
 	Projectile(float damageBooster, float angleToFire, Coordinate worldPosition, Coordinate firedMomentum, Weapon* weapon);
 	~Projectile(void);
+	void UpdatePhysics( void );
 	void Update( lua_State *L );
-	void SetOwnerID(int id) { ownerID = id; }
-	void SetTargetID(int id) { targetID = id; }
+	void Hit( Contact *contact );
+	void SetOwnerID(SpriteHandle id) { ownerID = id; }
+	SpriteHandle GetOwnerID() { return ownerID; }
+	void SetTargetID(SpriteHandle id) { targetID = id; }
 	int GetDrawOrder( void ) {
 			return( DRAW_ORDER_PROJECTILE );
 	}
 private:
 	Uint32 secondsOfLife; //time to live before projectile blows up
 	Uint32 start;
-	int ownerID;
-	int targetID;
+	SpriteHandle ownerID;
+	SpriteHandle targetID;
 	float damageBoost;
 	Weapon *weapon;
 };
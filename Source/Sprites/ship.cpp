@@ -11,6 +11,8 @@
 #include "Sprites/ship.h"
 #include "Engine/camera.h"
 #include "Engine/simulation_lua.h"
+#include "Graphics/spritebatch.h"
+#include "Utilities/random.h"
 #include "Utilities/timer.h"
 #include "Utilities/trig.h"
 #include "Sprites/spritemanager.h"
@@ -125,7 +127,7 @@ Ship::Ship()
 	shipStats = Outfit();
 
 	SetRadarColor( RED );
-	SetAngle( float( rand() %360 ) );
+	SetAngle( float( Random::Int(360) ) );
 }
 
 /**\brief Ship Destructor
@@ -382,7 +384,7 @@ bool Ship::JumpDrive( Coordinate position ) {
 /**\brief Update function on every frame.
  */
 void Ship::Update( lua_State *L ) {
-	Sprite::Update( L ); // update momentum and other generic sprite attributes
+	Sprite::Update( L );
 	
 	// Movement Changes
 	if( status.isAccelerating == false 
@@ -429,6 +431,7 @@ void Ship::Draw( void ) {
 
 	if( status.isJumping ) {
 		// When the ship is jumping, move it to the screen edge
+		SpriteBatch::Flush(); // Only this Ship should be moved
 		glPushMatrix();
 		Coordinate jumpDir = (status.jumpDestination - position);
 		jumpDir.EnforceMagnitude( Video::GetHalfWidth() );
@@ -474,6 +477,7 @@ void Ship::Draw( void ) {
 #endif
 
 	if( status.isJumping ) {
+		SpriteBatch::Flush();
 		glPopMatrix();
 	}
 }
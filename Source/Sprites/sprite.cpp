@@ -11,19 +11,23 @@
 #include "Sprites/sprite.h"
 #include "Utilities/log.h"
 #include "Utilities/timer.h"
+#include "Utilities/quadrant.h"
 
 /** \addtogroup Sprites
  * @{
  */
 
 // Sprite ID 0 is only used as a NULL
-long int Sprite::sprite_ids = 1;
+SlotMap<Sprite*> Sprite::handles;
+Uint32 Sprite::created = 0;
 
 /**\class Sprite
  * \brief Supertype for all drawable objects existing at a point in the universe with an angle and momentum.
  * \details Sprites are the objects that move around the universe.
  *          They may be created and destroyed.
- *          Each Sprite has a Unique ID.
+ *          Each Sprite has a Unique ID.  IDs are generational handles, so
+ *          the ID of a deleted Sprite is never mistaken for a newer Sprite
+ *          that reused its slot.
  *
  *          Only the SpriteManager should ever store pointers to Sprite
  *          objects.  This is because only the SpriteManager is informed when a
@@ -52,7 +56,8 @@ long int Sprite::sprite_ids = 1;
  *          Sets the radarColor as Grey.
  */
 Sprite::Sprite() {
-	id = sprite_ids++;
+	id = handles.Insert( this );
+	creation = created++;
 
 	// Momentum caps
 
@@ -63,36 +68,99 @@ Sprite::Sprite() {
 	radarSize = 1;
 	radarColor = WHITE * 0.7f;
 
-	lastUpdateFrame = Timer::GetLogicalFrameCount();
+	home.quadrant = NULL;
+	home.moved = false;
+}
+
+/**\brief Copy a Sprite.
+ * \details The copy gets its own unique ID and Kinematics slot, and is not
+ *          in any Quadrant until it is Added to the SpriteManager.
+ */
+Sprite::Sprite( const Sprite& other ):
+	kinematics( other.kinematics ),
+	image( other.image ),
+	angle( other.angle ),
+	radarSize( other.radarSize ),
+	radarColor( other.radarColor )
+{
+	id = handles.Insert( this );
+	creation = created++;
+
+	home.quadrant = NULL;
+	home.moved = false;
+}
+
+/**\brief Copy another Sprite's motion and appearance.
+ * \details This Sprite keeps its own ID and its place in the SpriteManager.
+ */
+Sprite& Sprite::operator=( const Sprite& other ) {
+	kinematics = other.kinematics;
+	image = other.image;
+	angle = other.angle;
+	radarSize = other.radarSize;
+	radarColor = other.radarColor;
+	CheckHome();
+	return *this;
+}
+
+/**\brief Release this Sprite's ID.
+ */
+Sprite::~Sprite() {
+	handles.Erase( id );
 }
 
 Coordinate Sprite::GetWorldPosition( void ) const {
-	return worldPosition;
+	return Kinematics::GetPosition( kinematics.index );
 }
 
 void Sprite::SetWorldPosition( Coordinate coord ) {
-	worldPosition = coord;
+	Kinematics::SetPosition( kinematics.index, coord );
+	CheckHome();
+}
+
+/**\brief How far this Sprite drifted during this logical frame.
+ * \details Sprites in Quadrants that were skipped this frame haven't moved,
+ *          and jumps made with SetWorldPosition are not counted.
+ * \see Narrowphase
+ */
+Coordinate Sprite::GetLastMove( void ) const {
+	if( Kinematics::GetFrame( kinematics.index ) != Timer::GetLogicalFrameCount() ) {
+		return Coordinate( 0, 0 );
+	}
+	return Kinematics::GetMove( kinematics.index );
+}
+
+/**\brief Queue this Sprite to be moved to a new Leaf.
+ * \see Quadrant::Moved
+ */
+void Sprite::LeftHome( void ) {
+	home.moved = true;
+	home.quadrant->Moved( this );
 }
 
 
 /**\brief Move this Sprite in the direction of their current momentum.
  * \details Since this is a space simulation, there is no Friction; momentum does not decrease over time.
+ *
+ * The SpriteManager runs this for many Sprites at once on the Job threads.
+ * It may only change this Sprite.  Deleting Sprites (or Adding ones that
+ * already exist) is fine since the SpriteManager buffers those until the
+ * Jobs are done, but new Sprites must not be constructed here: their IDs and
+ * Kinematics slots may only be allocated on the main thread.
+ * \see SpriteManager::Update
  */
-void Sprite::Update( lua_State *L ) {
-	Uint32 currentFrame = Timer::GetLogicalFrameCount();
-
-	Uint32 framesSinceUpdate = (currentFrame > lastUpdateFrame) 
-						? (currentFrame - lastUpdateFrame) 
-						: (lastUpdateFrame - currentFrame);
-
-	lastUpdateFrame = currentFrame;
+void Sprite::UpdatePhysics( void ) {
+	// Apply their momentum to change their coordinates.
+	// When every Quadrant is updated, the SpriteManager has already done this for all Sprites at once.
+	Kinematics::Integrate( kinematics.index, Timer::GetLogicalFrameCount() );
+	CheckHome();
+}
 
-	// Apply their momentum to change their coordinates - apply it as often as the num frames that we've skipped
-	worldPosition += (momentum * framesSinceUpdate);
-	
-	// update acceleration - we do not care about the framesSinceUpdate for updating thesef
-	acceleration = lastMomentum - momentum; 
-	lastMomentum = momentum;
+/**\brief Run the game logic for this Sprite.
+ * \details This runs on the main thread after every Sprite's UpdatePhysics,
+ *          so it is safe to look at and change other Sprites or to call Lua.
+ */
+void Sprite::Update( lua_State *L ) {
 }
 
 /**\brief Draw
@@ -104,6 +172,7 @@ void Sprite::Update( lua_State *L ) {
 void Sprite::Draw( void ) {
 	int wx, wy;
 
+	Coordinate worldPosition = GetWorldPosition();
 	wx = worldPosition.GetScreenX();
 	wy = worldPosition.GetScreenY();
 	
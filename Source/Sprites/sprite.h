@@ -13,6 +13,8 @@
 #include "Graphics/video.h"
 #include "Utilities/lua.h"
 #include "Utilities/coordinate.h"
+#include "Sprites/kinematics.h"
+#include "Utilities/slotmap.h"
 
 // With the draw order, higher numbers are drawn later (on top)
 // By using non-overlapping bits we can bit mask during searches
@@ -25,18 +27,41 @@
 #define DRAW_ORDER_EFFECT              0x0040 ///< Draw order for Effect Sprites (Explosions)
 #define DRAW_ORDER_ALL                 0xFFFF ///< Default DRAW_ORDER for searches that filter.
 
+class Quadrant;
+
+/// The unique ID of a Sprite.  It stays unique after the Sprite is deleted.
+/// \see SlotMap
+typedef SlotHandle SpriteHandle;
+
+/**\brief Where a Sprite is stored inside of a Quadrant.
+ * \details Quadrants that track their Sprites fill this in, so that a moving
+ *          Sprite only has to check the bounds of the Leaf holding it.
+ * \see Quadrant::Moved
+ */
+struct QuadrantHome {
+	Quadrant* quadrant;             ///< The Quadrant holding this Sprite, or NULL if it is not tracked.
+	int leaf;                       ///< The Leaf holding this Sprite.
+	unsigned int slot;              ///< The position of this Sprite within that Leaf.
+	float left, right, bottom, top; ///< The bounds of that Leaf.
+	bool moved;                     ///< True once the Quadrant has been told that this Sprite left the Leaf.
+};
+
 class Sprite {
 	public:
 		Sprite();
-		virtual ~Sprite() {};
+		Sprite( const Sprite& other );
+		Sprite& operator=( const Sprite& other );
+		virtual ~Sprite();
 		
 		Coordinate GetWorldPosition( void ) const;
 		void SetWorldPosition( Coordinate coord );
 		
+		virtual void UpdatePhysics( void );
 		virtual void Update( lua_State *L );
 		virtual void Draw( void );
 		
-		int GetID( void ) { return id; }
+		SpriteHandle GetID( void ) { return id; }
+		Uint32 GetCreation( void ) { return creation; }
 
 		float GetAngle( void ) const {
 			return( angle );
@@ -45,14 +70,15 @@ class Sprite {
 			this->angle = angle;
 		}
 		Coordinate GetMomentum( void ) const {
-			return momentum;
+			return Kinematics::GetVelocity( kinematics.index );
 		}
 		void SetMomentum( Coordinate momentum ) {
-			this->momentum = momentum;
+			Kinematics::SetVelocity( kinematics.index, momentum );
 		}
 		Coordinate GetAcceleration( void ) const {
-			return acceleration;
+			return Kinematics::GetAcceleration( kinematics.index );
 		}
+		Coordinate GetLastMove( void ) const;
 		void SetImage( Image *image ) {
 			assert(image);
 			this->image = image;
@@ -67,20 +93,37 @@ class Sprite {
 		int GetRadarSize( void ) { return radarSize; }
 		virtual Color GetRadarColor( void ) { return radarColor; }
 		virtual int GetDrawOrder( void ) = 0;
+
+		QuadrantHome* GetHome( void ) { return &home; }
 		
 	private:
-		static long int sprite_ids; ///< The ID for the next Sprite.
+		inline void CheckHome( void );
+		void LeftHome( void );
+
+		static SlotMap<Sprite*> handles; ///< Every Sprite that exists, by ID.
+		static Uint32 created; ///< The number of Sprites ever created.
 
-		int id; ///< The unique ID of this Sprite.
-		Coordinate worldPosition; ///< The Current position of this Sprite.
-		Coordinate momentum; ///< The current Speed and Direction that this Sprite is moving (not pointing).
-		Coordinate acceleration; ///< The ammount that the Sprite accelerated during the previous Update.
-		Coordinate lastMomentum; ///< The momentum that this Sprite had after the previous Update.
+		SpriteHandle id; ///< The unique ID of this Sprite.
+		Uint32 creation; ///< The order that this Sprite was created in.
+		KinematicSlot kinematics; ///< Where this Sprite's position, momentum and acceleration are stored.
 		Image *image; ///< The current Image that this Sprite is using.
 		float angle; ///< The current direction that this Sprite is pointing (not moving).
+		QuadrantHome home; ///< The Leaf that is holding this Sprite.
 		int radarSize; ///< A Rough appoximation of this Sprite's size.
 		Color radarColor; ///< The color of this Sprite.
-		Uint32 lastUpdateFrame; ///< The # of the logical frame that this sprite was last updated
 };
 
+/**\brief Tell the Quadrant when this Sprite has left the Leaf holding it.
+ * \details This is called on every move, so the common case (no Quadrant, or
+ *          still inside of the Leaf) is kept inline.
+ */
+inline void Sprite::CheckHome( void ) {
+	if( home.quadrant == NULL || home.moved ) return;
+	Coordinate worldPosition = GetWorldPosition();
+	if( worldPosition.GetX() < home.left || worldPosition.GetX() > home.right
+	 || worldPosition.GetY() < home.bottom || worldPosition.GetY() > home.top ) {
+		LeftHome();
+	}
+}
+
 #endif // __h_sprite__
@@ -8,10 +8,15 @@
 #include "includes.h"
 #include "common.h"
 #include "Sprites/ai.h"
+#include "Sprites/aischeduler.h"
 #include "Sprites/effects.h"
+#include "Sprites/projectile.h"
+#include "Sprites/ship.h"
 #include "Sprites/spritemanager.h"
 #include "Utilities/log.h"
 #include "Utilities/quadtree.h"
+#include "Utilities/flatquadtree.h"
+#include "Utilities/timer.h"
 #include "Engine/camera.h"
 #include "Engine/simulation_lua.h"
 
@@ -35,6 +40,9 @@
  *   - The QuadTree is a recursive datastructure that stores the Sprites by their
  *     Universal location.  The Quadtree segments the Sprites based on how
  *     relativly close the Sprites are.
+ *   - By default each Quadrant is a FlatQuadTree, which keeps its nodes in a
+ *     single pooled array.  Setting options/simulation/flat-quadtree to 0
+ *     selects the original recursive QuadTree.
  *   - Each QuadTree is only a finite size, but can theoretically hold an infinte
  *     number of sprites.
  *   - The entire universe is broken up into a grid of QuadTrees.
@@ -42,16 +50,31 @@
  *   - The QuadTrees cannot be accessed directly, but are used implicitely when
  *     requesting sprites by a location.
  *   \see QuadTree
+ *   \see FlatQuadTree
  *   \see GetSpritesNear
  *   \see GetNearestSprite
- * - The SpriteManager has a map of all Sprites by their unique ID.
+ * - The SpriteManager has a table of all Sprites by their unique ID.
  *   - Sprites can be queried by passing an ID.
+ *   - Each ID is a SlotMap handle, so the table is indexed by the slot of the
+ *     ID and the lookup only has to check that the Sprite found there still
+ *     has that ID.  IDs of deleted Sprites are never found.
  *   \see GetSpriteByID
  *
  * Sprites are never deleted immediately.  This is to prevent a Sprite from
  * being deleted during the middle of the Update Loop.  Instead, 'deleted'
  * Sprites are recorded in a list and deleted in a batch once per Update.
  *
+ * Each Update happens in two phases.  First every Quadrant moves its Sprites
+ * as a separate Job, so the Quadrants are moved in parallel.  When every
+ * Quadrant is being updated, the positions are integrated beforehand in one
+ * pass over the Kinematics arrays.  While those Jobs run, Sprites that are
+ * Added or Deleted are kept in a CommandBuffer for the thread that made the
+ * change, and the buffers are merged once every Job is done.  Sprites may not
+ * be constructed by those Jobs, since their IDs and Kinematics slots are only
+ * allocated on the main thread.  Then the game logic (including all of the
+ * Lua AI) runs serially on the main thread.
+ * \see Jobs
+ *
  */
 
 /**\brief Constructs a new sprite manager.
@@ -65,9 +88,19 @@ SpriteManager::SpriteManager() :
 	 , numSemiRegularBands (5)		//the semi-regular updates are on this number of bands - this SHOULD be easily divisible into semiRegularPeriod
 {
 	player = NULL;
+	parallel = false;
+	commands.resize( Jobs::GetNumThreads() );
+	relocations = 0;
+	visitDepth = 0;
+	ResetProfile();
+	flatQuadrants = (OPTION(int, "options/simulation/flat-quadtree") != 0);
 
 	spritelist = new list<Sprite*>();
-	spritelookup = new map<int,Sprite*>();
+	spritelookup = new vector<Sprite*>();
+
+	hash = new SpatialHash( OPTION(float, "options/simulation/hash-cell-size") );
+	hashDirty = true;
+	ReadBroadphaseOptions();
 
 	//fill in the ticksToBandNum map based on the semiRegularPeriod and numSemiRegularBands
 	int updateGap = semiRegularPeriod / numSemiRegularBands;
@@ -84,6 +117,11 @@ SpriteManager& SpriteManager::operator=( SpriteManager& object ){
 	if ( this == &object ) return * this; //block self assignment
 	
 	trees = object.trees;
+	quadrantCells = object.quadrantCells;
+	flatQuadrants = object.flatQuadrants;
+	hash = object.hash;
+	useHash = object.useHash;
+	hashDirty = object.hashDirty;
 	spritelist = object.spritelist;
 	spritelookup = object.spritelookup;
 	
@@ -121,9 +159,23 @@ SpriteManager *SpriteManager::Instance( void ) {
  * \param sprite Pointer to the sprite
  */
 void SpriteManager::Add( Sprite *sprite ) {
+	if( parallel ) {
+		commands[ Jobs::GetThreadIndex() ].added.push_back( sprite );
+		return;
+	}
 	spritelist->push_back(sprite);
-	spritelookup->insert(make_pair(sprite->GetID(),sprite));
+	unsigned int slot = SlotMap<Sprite*>::GetIndex( sprite->GetID() );
+	if( slot >= spritelookup->size() ) {
+		spritelookup->resize( slot + 1, NULL );
+	}
+	(*spritelookup)[slot] = sprite;
 	GetQuadrant( sprite->GetWorldPosition() )->Insert( sprite );
+	// An unused hash is rebuilt from the spritelist when it is needed again.
+	if( useHash ) {
+		hash->Insert( sprite );
+	} else {
+		hashDirty = true;
+	}
 }
 
 /**\brief Adds player sprite to the manager.
@@ -143,8 +195,17 @@ bool SpriteManager::DeleteSprite( Sprite *sprite ) {
 	if(sprite == player) LogMsg(ALERT, "Deleting player sprite. Should we be doing this?");
 
 	spritelist->remove(sprite);
-	spritelookup->erase( sprite->GetID() );
-	GetQuadrant( sprite->GetWorldPosition() )->Delete( sprite );
+	Sprite*& lookup = (*spritelookup)[ SlotMap<Sprite*>::GetIndex( sprite->GetID() ) ];
+	if( lookup == sprite ) {
+		lookup = NULL;
+	}
+	// Tracked Sprites know their Quadrant even if they have wandered out of it.
+	Quadrant* home = sprite->GetHome()->quadrant;
+	if( home == NULL ) {
+		home = GetQuadrant( sprite->GetWorldPosition() );
+	}
+	home->Delete( sprite );
+	hashDirty = true;
 	// Delete the sprite itself unless it is a Planet or Player.
 	// Planets and Players are special sprites since they are Components and get saved.
 	if( !(sprite->GetDrawOrder() & (DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET | DRAW_ORDER_GATE_TOP | DRAW_ORDER_GATE_BOTTOM)) ) {
@@ -159,17 +220,31 @@ bool SpriteManager::DeleteSprite( Sprite *sprite ) {
  * This just queues the sprite up to be deleted.
  */
 bool SpriteManager::Delete( Sprite *sprite ) {
+	if( parallel ) {
+		commands[ Jobs::GetThreadIndex() ].deleted.push_back( sprite );
+		return true;
+	}
 	spritesToDelete.push_back(sprite);
 	return true;
 }
 
+/**\brief Orders Sprites by their unique ID.
+ * \details Unlike their addresses, the IDs are the same every time that a
+ *          Simulation is run.
+ */
+static bool compareSpriteIDs( Sprite* a, Sprite* b ) {
+	return a->GetID() < b->GetID();
+}
+
 /**\brief SpriteManager update function.
  * \details Update the sprites inside each quadrant
  * \param lowFps If true, forces the wave-update method to be used rather than the full-update
  */
 void SpriteManager::Update( lua_State *L, bool lowFps) {
 	//this will contain every quadrant that we will potentially want to update
-	list<QuadTree*> quadList;
+	list<Quadrant*> quadList;
+
+	ReadBroadphaseOptions();
 	
 	//if update-all is given then we update every quadrant
 	//we do the same if tickCount == 0 even if update-all is not given
@@ -177,6 +252,9 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 	if( ! lowFps || tickCount == 0) {
 		//need to get all of the quadrants in our map
 		GetAllQuadrants(&quadList);
+
+		//every Sprite will move, so move them all at once
+		IntegrateAll();
 	}
 	else
 	{
@@ -190,7 +268,7 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		//	the first band is at index 1 - index 0 would be the single quadrant in the middle
 		//	when we get the list of quadrants back we splice them onto the end of our overall list
 		for (int i = 1; i <= numRegularBands; i ++) {
-			list<QuadTree*> tempBandList = GetQuadrantsInBand (currentPoint, i);
+			list<Quadrant*> tempBandList = GetQuadrantsInBand (currentPoint, i);
 			quadList.splice (quadList.end(), tempBandList);
 		}
 
@@ -202,7 +280,7 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		map<int,int>::iterator findBand = ticksToBandNum.find (semiRegularTick);
 		if (findBand != ticksToBandNum.end()) {		//found the key
 			//cout << "tick = " << tickCount << ", semiRegularTick = " << semiRegularTick << ", band = " << findBand->second << endl;
-			list<QuadTree*> tempBandList = GetQuadrantsInBand (currentPoint, findBand->second);
+			list<Quadrant*> tempBandList = GetQuadrantsInBand (currentPoint, findBand->second);
 			quadList.splice (quadList.end(), tempBandList);
 		}
 		else {
@@ -210,25 +288,90 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		}
 	}
 
-	// Find and Fix any Sprites that have moved out of bounds.
-	list<Sprite *> all_oob;
-	list<QuadTree*>::iterator iter;
+	// Move the Sprites of each Quadrant in parallel.
+	// Nothing may be added to or removed from any Quadrant until every Job is done.
+	list<Quadrant*>::iterator iter;
+	unsigned int c;
+	Uint64 start = Timer::GetNanoseconds(), now;
+	if( commands.size() < static_cast<unsigned int>(Jobs::GetNumThreads()) ) {
+		commands.resize( Jobs::GetNumThreads() );
+	}
+	physicsJobs.clear();
+	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
+		physicsJobs.push_back( QuadrantPhysicsJob(*iter) );
+	}
+	parallel = true;
+	for( c = 0; c < physicsJobs.size(); ++c ) {
+		Jobs::Submit( &physicsJobs[c] );
+	}
+	Jobs::Wait();
+	parallel = false;
+
+	// Merge the Sprites that were created by the Jobs.
+	for( c = 0; c < commands.size(); ++c ) {
+		for( unsigned int a = 0; a < commands[c].added.size(); ++a ) {
+			Add( commands[c].added[a] );
+		}
+		commands[c].added.clear();
+		spritesToDelete.insert( spritesToDelete.end(), commands[c].deleted.begin(), commands[c].deleted.end() );
+		commands[c].deleted.clear();
+	}
+
+	now = Timer::GetNanoseconds();
+	profile.physics += now - start;
+	start = now;
+
+	// Everything has moved, so the hash has to be re-sorted.
+	// When the hash isn't being used, this is put off until it is.
+	hashDirty = true;
+	if( useHash ) {
+		RefreshHash();
+	}
+
+	// Resolve every Projectile that hit a Ship along its path.
+	FindContacts( &quadList );
+	for( c = 0; c < contacts.size(); ++c ) {
+		contacts[c].projectile->Hit( &contacts[c] );
+	}
+
+	now = Timer::GetNanoseconds();
+	profile.collisions += now - start;
+	start = now;
+
+	// Run the game logic
+	AIScheduler::BeginTick( Simulation_Lua::GetSimulation(L)->GetCamera()->GetFocusCoordinate(), player );
 	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
 		(*iter)->Update(L);
-		list<Sprite *>* oob = (*iter)->FixOutOfBounds();
-		all_oob.splice(all_oob.end(), *oob );
-		delete oob;
+	}
+
+	now = Timer::GetNanoseconds();
+	profile.update += now - start;
+	start = now;
+
+	// Find and Fix any Sprites that have moved out of bounds.
+	outOfBounds.clear();
+	relocations = 0;
+	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
+		relocations += (*iter)->FixOutOfBounds( &outOfBounds );
 	}
 
 	// Move sprites to adjacent Quadrants as they cross boundaries
-	list<Sprite *>::iterator i;
-	for( i = all_oob.begin(); i != all_oob.end(); ++i ) {
-		GetQuadrant( (*i)->GetWorldPosition() )->Insert( *i );
+	vector<Sprite *>::iterator oob;
+	for( oob = outOfBounds.begin(); oob != outOfBounds.end(); ++oob ) {
+		GetQuadrant( (*oob)->GetWorldPosition() )->Insert( *oob );
 	}
 
+	now = Timer::GetNanoseconds();
+	profile.outOfBounds += now - start;
+	start = now;
+
+	list<Sprite *>::iterator i;
+
 	// Delete all sprites queued to be deleted
 	if (!spritesToDelete.empty()) {
-		spritesToDelete.sort(); // The list has to be sorted or unique doesn't work correctly.
+		// The list has to be sorted or unique doesn't work correctly.
+		// Sorting by ID keeps the order of the Lua callbacks reproducible.
+		spritesToDelete.sort( compareSpriteIDs );
 		spritesToDelete.unique();
 	
 		// Tell the AI that they've been killed
@@ -244,23 +387,103 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		spritesToDelete.clear();
 	}
 
+	now = Timer::GetNanoseconds();
+	profile.deletion += now - start;
+	start = now;
+
 	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
 		(*iter)->ReBallance();
 	}
 
+	now = Timer::GetNanoseconds();
+	profile.rebalance += now - start;
+	start = now;
+
 	DeleteEmptyQuadrants();
 
+	profile.deletion += Timer::GetNanoseconds() - start;
+	profile.updates++;
+
 	// Update the tick count after all updates for this tick are done
 	UpdateTickCount ();
 }
 
+/**\brief Clear the time spent in each part of Update.
+ * \see GetProfile
+ */
+void SpriteManager::ResetProfile() {
+	profile.physics = 0;
+	profile.collisions = 0;
+	profile.update = 0;
+	profile.outOfBounds = 0;
+	profile.deletion = 0;
+	profile.rebalance = 0;
+	profile.updates = 0;
+}
+
+/**\brief Find the Projectiles that hit a Ship during this Update (Internal use)
+ * \details The Projectiles of each Quadrant are collided together, so the
+ *          broadphase is only searched once per Quadrant rather than once per
+ *          Projectile.
+ * \see Narrowphase
+ */
+void SpriteManager::FindContacts( list<Quadrant*> *quadList ) {
+	list<Quadrant*>::iterator iter;
+	Coordinate center;
+	float radius;
+	unsigned int s;
+
+	contacts.clear();
+	for ( iter = quadList->begin(); iter != quadList->end(); ++iter ) {
+		narrowphase.Clear();
+		collisionSprites.clear();
+		(*iter)->GetSprites( &collisionSprites );
+		for( s = 0; s < collisionSprites.size(); ++s ) {
+			if( collisionSprites[s]->GetDrawOrder() == DRAW_ORDER_PROJECTILE ) {
+				narrowphase.AddProjectile( (Projectile*)collisionSprites[s] );
+			}
+		}
+		if( narrowphase.GetNumProjectiles() == 0 ) {
+			continue;
+		}
+
+		narrowphase.GetProjectileBounds( &center, &radius );
+		collisionSprites.clear();
+		GetSpritesNear( center, radius + NARROWPHASE_MARGIN, &collisionSprites, DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER );
+		for( s = 0; s < collisionSprites.size(); ++s ) {
+			narrowphase.AddShip( (Ship*)collisionSprites[s] );
+		}
+		narrowphase.Collide( &contacts );
+	}
+}
+
+/**\brief Move every Sprite by its momentum (Internal use)
+ * \details The Kinematics arrays are split into a few large Jobs.  Each
+ *          Sprite's UpdatePhysics will see that it already moved this frame.
+ */
+void SpriteManager::IntegrateAll() {
+	const unsigned int numSlots = Kinematics::GetNumSlots();
+	const unsigned int numJobs = Jobs::GetNumThreads();
+	const unsigned int perJob = (numSlots + numJobs - 1) / numJobs;
+	const Uint32 frame = Timer::GetLogicalFrameCount();
+
+	kinematicsJobs.clear();
+	for( unsigned int first = 0; first < numSlots; first += perJob ) {
+		kinematicsJobs.push_back( KinematicsJob( first, min( first + perJob, numSlots ), frame ) );
+	}
+	for( unsigned int j = 0; j < kinematicsJobs.size(); ++j ) {
+		Jobs::Submit( &kinematicsJobs[j] );
+	}
+	Jobs::Wait();
+}
+
 /**\brief Deletes empty QuadTrees (Internal use)
  */
 void SpriteManager::DeleteEmptyQuadrants() {
-	map<Coordinate,QuadTree*>::iterator iter;
+	map<Coordinate,Quadrant*>::iterator iter;
 	// Delete QuadTrees that are empty
 	// TODO: Delete QuadTrees that are far away from 
-	list<QuadTree*> emptyTrees;
+	list<Quadrant*> emptyTrees;
 	// Collect empty trees
 	for ( iter = trees.begin(); iter != trees.end(); ++iter ) { 
 		if ( iter->second->Count() == 0 ) {
@@ -268,10 +491,11 @@ void SpriteManager::DeleteEmptyQuadrants() {
 		}
 	}
 	// Delete empty trees
-	list<QuadTree*>::iterator emptyIter;
+	list<Quadrant*>::iterator emptyIter;
 	for ( emptyIter = emptyTrees.begin(); emptyIter != emptyTrees.end(); ++emptyIter) {
 		//cout<<"Deleting the empty tree at "<<(*emptyIter)->GetCenter()<<endl;
 		trees.erase((*emptyIter)->GetCenter());
+		quadrantCells.Erase( QuadrantKey((*emptyIter)->GetCenter().GetX()), QuadrantKey((*emptyIter)->GetCenter().GetY()) );
 		delete (*emptyIter);
 	}
 	if( emptyTrees.size() ) {
@@ -283,8 +507,12 @@ void SpriteManager::DeleteEmptyQuadrants() {
  *
  * \details The goal here is to order the sprites in a deterministic way.
  *          We also need the Sprites to be ordered by their DRAW_ORDER.
- *          Since the Sprite ID is unique, and monotonically increasing, this
- *          will sort older sprites below newer sprites.
+ *          Sprite IDs reuse slots, so they say nothing about age.  Instead
+ *          each Sprite is numbered as it is created, which sorts older
+ *          sprites below newer sprites.
+ *          Within each DRAW_ORDER the Sprites are grouped by texture first,
+ *          so that the SpriteBatch can draw each group at once.  Most Images
+ *          share a TextureAtlas page, so this rarely changes the order.
  *
  * \param a A pointer to a Sprite.
  * \param b A pointer to another Sprite.
@@ -296,25 +524,29 @@ void SpriteManager::DeleteEmptyQuadrants() {
 bool compareSpritePtrs(Sprite* a, Sprite* b){
 	if(a->GetDrawOrder() != b->GetDrawOrder()) {
 		return a->GetDrawOrder() < b->GetDrawOrder();
+	}
+	GLuint ta = a->GetImage() ? a->GetImage()->GetTexture() : 0;
+	GLuint tb = b->GetImage() ? b->GetImage()->GetTexture() : 0;
+	if(ta != tb) {
+		return ta < tb;
 	} else {
-		return a->GetID() < b->GetID();
+		return a->GetCreation() < b->GetCreation();
 	}
 }
 
 /**\brief Draws the current sprites
  */
 void SpriteManager::Draw( Coordinate focus ) {
-	list<Sprite *>::iterator i;
-	list<Sprite*> *onscreen;
+	vector<Sprite *>::iterator i;
 	float r = (Video::GetHalfHeight() < Video::GetHalfWidth() ? Video::GetHalfWidth() : Video::GetHalfHeight()) *V_SQRT2;
-	onscreen = GetSpritesNear( focus, r, DRAW_ORDER_ALL);
+	onscreen.clear();
+	GetSpritesNear( focus, r, &onscreen, DRAW_ORDER_ALL );
 
-	onscreen->sort(compareSpritePtrs);
+	sort( onscreen.begin(), onscreen.end(), compareSpritePtrs );
 
-	for( i = onscreen->begin(); i != onscreen->end(); ++i ) {
+	for( i = onscreen.begin(); i != onscreen.end(); ++i ) {
 		(*i)->Draw();
 	}
-	delete onscreen;
 }
 
 /**\brief Draws the current sprites
@@ -346,10 +578,27 @@ list<Sprite *> *SpriteManager::GetSprites(int type) {
 /**\brief Queries for sprite by the ID
  * \param id Identification of the sprite.
  */
-Sprite *SpriteManager::GetSpriteByID(int id) {
-	map<int,Sprite*>::iterator val = spritelookup->find( id );
-	if( val != spritelookup->end() ){
-		return val->second;
+Sprite *SpriteManager::GetSpriteByID(SpriteHandle id) {
+	unsigned int slot = SlotMap<Sprite*>::GetIndex( id );
+	if( slot < spritelookup->size() ) {
+		Sprite *sprite = (*spritelookup)[slot];
+		// An older or newer Sprite may be using this slot.
+		if( sprite != NULL && sprite->GetID() == id ) {
+			return sprite;
+		}
+	}
+	return NULL;
+}
+
+/**\brief Queries for sprite by the ID, only if it is of a certain type.
+ * \details Use this before casting the Sprite to a subclass.
+ * \param id Identification of the sprite.
+ * \param type A DRAW_ORDER mask of the types that are expected.
+ */
+Sprite *SpriteManager::GetSpriteByID(SpriteHandle id, int type) {
+	Sprite *sprite = GetSpriteByID( id );
+	if( sprite != NULL && (sprite->GetDrawOrder() & type) ) {
+		return sprite;
 	}
 	return NULL;
 }
@@ -359,66 +608,29 @@ Sprite *SpriteManager::GetSpriteByID(int id) {
  * \param bandIndex number of quadrants distant from c
  * \return std::list of QuadTree pointers.
  */
-list<QuadTree*> SpriteManager::GetQuadrantsInBand ( Coordinate c, int bandIndex) {
+list<Quadrant*> SpriteManager::GetQuadrantsInBand ( Coordinate c, int bandIndex) {
 	// The possibleQuadrants here are the quadrants that are in the square band
 	//  at distance bandIndex from the coordinate
-	// After we get the possible quadrants we prune them by making sure they exist
-	//  (ie that something is in them)
-
-	list<QuadTree*> nearbyQuadrants;
-	set<Coordinate> possibleQuadrants;
-
-	//note that the QUADRANTSIZE define is the
-	//	distance from the middle to the edge of a quadrant
-	//to get the square band of co-ordinates we have to
-	//		- start at bottom left 
-	//			loop over increasing Y (to get 'west' line)
-	//			loop over increasing X (to get 'south' line)
-	//		- start at top right
-	//			loop over decreasing Y (to get 'east' line)
-	//			loop over decreasing X (to get 'north' line)
-			
-	int edgeDistance = bandIndex * QUADRANTSIZE * 2;		//number of pixels from middle to the band
-	Coordinate bottomLeft (c - Coordinate (edgeDistance, edgeDistance));
-	Coordinate topLeft (c + Coordinate (-edgeDistance, edgeDistance));
-	Coordinate topRight (c + Coordinate (edgeDistance, edgeDistance));
-	Coordinate bottomRight (c + Coordinate (edgeDistance, -edgeDistance));
-
-	//the 'full' length of one of the lines is (bandindex * 2) + 1
-	//we don't need the +1 as we deal with the corners individually, separately
-	int bandLength = (bandIndex * 2);
-
-	//deal with the un-included corners first
-	//we're using bottomLeft and topRight as the anchors, 
-	// so topLeft and bottomRight are added here
-	possibleQuadrants.insert (GetQuadrantCenter (topLeft));
-	possibleQuadrants.insert (GetQuadrantCenter (bottomRight));
-	for (int i = 0; i < bandLength; i ++) {
-		int offset = ((QUADRANTSIZE * 2) * i);
-		Coordinate west, south, north, east;
-
-		west = GetQuadrantCenter (bottomLeft + Coordinate (0, offset));
-		south = GetQuadrantCenter (bottomLeft + Coordinate (offset, 0));
-		north = GetQuadrantCenter (topRight - Coordinate (offset, 0));
-		east = GetQuadrantCenter (topRight - Coordinate (0, offset));
-
-		possibleQuadrants.insert (west);		//west
-		possibleQuadrants.insert (south);		//south
-		possibleQuadrants.insert (north);		//north
-		possibleQuadrants.insert (east);		//east
-	}
-
-	//here we're checking to see if this possible quadrant is one of the existing quadrants
-	// and if it is then we add its QuadTree to the vector we're returning
-	// if it's not then there's nothing in it anyway so we don't care about it
-	set<Coordinate>::iterator it;
-	map<Coordinate,QuadTree*>::iterator iter;
-	for(it = possibleQuadrants.begin(); it != possibleQuadrants.end(); ++it) {
-		iter = trees.find(*it);
-		if(iter != trees.end()) {
-			nearbyQuadrants.push_back(iter->second);
+	// Since the quadrants are keyed by their integer grid position, the band
+	//  is just the ring of keys bandIndex steps away from the key of c.
+	// Keys that aren't in the table have nothing in them, so we don't care about them.
+
+	list<Quadrant*> nearbyQuadrants;
+	Quadrant** found;
+
+	int cx = QuadrantKey( GetQuadrantCenter(c).GetX() );
+	int cy = QuadrantKey( GetQuadrantCenter(c).GetY() );
+
+	for (int y = cy - bandIndex; y <= cy + bandIndex; y ++) {
+		// The north and south lines are complete, the rest only have the east and west ends
+		bool edge = (y == cy - bandIndex) || (y == cy + bandIndex);
+		int step = (edge || bandIndex == 0) ? 1 : (bandIndex * 2);
+		for (int x = cx - bandIndex; x <= cx + bandIndex; x += step) {
+			found = quadrantCells.Find(x, y);
+			if( found != NULL ) {
+				nearbyQuadrants.push_back(*found);
+			}
 		}
-		
 	}
 	return nearbyQuadrants;
 }
@@ -427,41 +639,36 @@ list<QuadTree*> SpriteManager::GetQuadrantsInBand ( Coordinate c, int bandIndex)
 /**\brief Retrieves nearby QuadTrees
  * \param c Coordinate
  * \param r Radius
- * \return std::list of QuadTree pointers.
+ * \param nearbyQuadrants [out] The Quadrants are appended here.
  */
-list<QuadTree*> SpriteManager::GetQuadrantsNear( Coordinate c, float r) {
+void SpriteManager::GetQuadrantsNear( Coordinate c, float r, vector<Quadrant*> *nearbyQuadrants ) {
 	// The possibleQuadrants are those trees adjacent and within a radius r
 	// Gather more trees when r is greater than the size of a quadrant
-	map<Coordinate,QuadTree*>::iterator iter;
-	list<QuadTree*> nearbyQuadrants;
-	set<Coordinate> possibleQuadrants;
+	Coordinate possibleQuadrants[9];
+	Quadrant* quadrant;
 
-	Coordinate center = GetQuadrantCenter(c);
-
-	possibleQuadrants.insert( center );
 	float R = r;
 	do{
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-0,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+0,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+R)));
+		possibleQuadrants[0] = c;
+		possibleQuadrants[1] = c + Coordinate(-R,-0);
+		possibleQuadrants[2] = c + Coordinate(-0,+R);
+		possibleQuadrants[3] = c + Coordinate(+0,-R);
+		possibleQuadrants[4] = c + Coordinate(+R,+0);
+		possibleQuadrants[5] = c + Coordinate(-R,-R);
+		possibleQuadrants[6] = c + Coordinate(-R,+R);
+		possibleQuadrants[7] = c + Coordinate(+R,-R);
+		possibleQuadrants[8] = c + Coordinate(+R,+R);
+		for(int i = 0; i < 9; ++i) {
+			//here we're checking to see if this possible quadrant is one of the existing quadrants
+			// and if it is then we add its QuadTree to the vector we're returning
+			quadrant = FindQuadrant( GetQuadrantCenter(possibleQuadrants[i]) );
+			if(quadrant != NULL && quadrant->PossiblyNear(c,r)
+			  && find(nearbyQuadrants->begin(), nearbyQuadrants->end(), quadrant) == nearbyQuadrants->end() ){
+				nearbyQuadrants->push_back(quadrant);
+			}
+		}
 		R/=2;
 	} while(R>QUADRANTSIZE);
-	set<Coordinate>::iterator it;
-	for(it = possibleQuadrants.begin(); it != possibleQuadrants.end(); ++it) {
-		//here we're checking to see if this possible quadrant is one of the existing quadrants
-		// and if it is then we add its QuadTree to the vector we're returning
-		//how about we try creating the quadrant if it does not already exist
-		iter = trees.find(*it);
-		if(iter != trees.end() && iter->second->PossiblyNear(c,r)){
-			nearbyQuadrants.push_back(iter->second);
-		}
-	}
-	return nearbyQuadrants;
 }
 
 
@@ -490,27 +697,87 @@ struct compareSpriteDistFromPoint
 	Coordinate point;
 };
 
-/**\brief Returns a list of sprites that are near coordinate.
+/**\brief Finds the sprites that are near a coordinate.
+ * \details Nothing is allocated as long as the found vector is large enough,
+ *          so callers that search every frame should keep their vector around.
+ *
+ *          Sprites already in the found vector are left alone.
  * \param c Coordinate
  * \param r Radius
- * \return std::list of Sprite pointers.
+ * \param found [out] The nearby Sprites are appended here.
+ * \param type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \param sorted If true, the Sprites are sorted by their distance from c.
+ * \param limit If not zero, only this many Sprites are kept.  When sorted, these are the closest ones.
+ *              When not sorted, the search stops as soon as this many are found.
  */
-list<Sprite*> *SpriteManager::GetSpritesNear(Coordinate c, float r, int type) {
-	list<Sprite*> *sprites = new list<Sprite*>();
-	
-	// Search the possible quadrants
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(c,r);
-	list<QuadTree*>::iterator it;
-	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
-			list<Sprite *>* nearby = new list<Sprite*>;
-			(*it)->GetSpritesNear(c,r,nearby,type);
-			sprites->splice(sprites->end(), *nearby);
-			delete nearby;
+void SpriteManager::GetSpritesNear(Coordinate c, float r, vector<Sprite*> *found, int type, bool sorted, unsigned int limit) {
+	unsigned int start = found->size();
+
+	// The closest Sprites can only be known once every Sprite has been seen.
+	unsigned int searchLimit = sorted ? 0 : limit;
+
+	if( useHash ) {
+		RefreshHash();
+		hash->GetSpritesNear(c,r,found,type,searchLimit);
+	} else {
+		// Search the possible quadrants
+		vector<Quadrant*>::iterator it;
+		nearbyQuadrants.clear();
+		GetQuadrantsNear(c,r,&nearbyQuadrants);
+		for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
+			unsigned int numFound = found->size() - start;
+			if( searchLimit != 0 && numFound >= searchLimit ) {
+				break;
+			}
+			(*it)->GetSpritesNear(c,r,found,type, searchLimit ? searchLimit - numFound : 0);
+		}
 	}
 
-	// Sort sprites by their distance from the coordinate c
-	sprites->sort(compareSpriteDistFromPoint(c));
-	return( sprites );
+	unsigned int numFound = found->size() - start;
+	if( limit != 0 && numFound > limit ) {
+		// Only the closest sprites need to be sorted
+		if( sorted ) {
+			partial_sort(found->begin() + start, found->begin() + start + limit, found->end(), compareSpriteDistFromPoint(c));
+			sorted = false;
+		}
+		found->resize( start + limit );
+	}
+	if( sorted ) {
+		sort(found->begin() + start, found->end(), compareSpriteDistFromPoint(c));
+	}
+}
+
+/**\brief Calls a SpriteVisitor for each sprite that is near a coordinate.
+ * \details The visitor may search again (or delete Sprites) while it is visiting.
+ * \param c Coordinate
+ * \param r Radius
+ * \param visitor Called for each nearby Sprite until it returns false.
+ * \param type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \param sorted If true, the Sprites are visited from closest to farthest.
+ * \param limit If not zero, at most this many Sprites are visited.  The
+ *              search itself stops early, so visitors that only need the
+ *              first few Sprites should pass a limit rather than just return false.
+ * \return true if the visitor never stopped the search.
+ */
+bool SpriteManager::VisitSpritesNear(Coordinate c, float r, SpriteVisitor *visitor, int type, bool sorted, unsigned int limit) {
+	// Each level of nested visiting gets its own buffer.
+	if( visitDepth == visitBuffers.size() ) {
+		visitBuffers.push_back( new vector<Sprite*>() );
+	}
+	vector<Sprite*> *found = visitBuffers[visitDepth];
+	found->clear();
+	GetSpritesNear( c, r, found, type, sorted, limit );
+
+	bool finished = true;
+	visitDepth++;
+	for( unsigned int i = 0; i < found->size(); ++i ) {
+		if( !visitor->Visit( (*found)[i] ) ) {
+			finished = false;
+			break;
+		}
+	}
+	visitDepth--;
+	return finished;
 }
 
 /**\brief Get a Sprite nearest to another Sprite.
@@ -539,8 +806,13 @@ Sprite* SpriteManager::GetNearestSprite(Sprite* obj, float r, int type) {
 	Sprite* possible=NULL;
 	if(obj==NULL)
 		return (Sprite*)NULL;
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(obj->GetWorldPosition(),r);
-	list<QuadTree*>::iterator it;
+	if( useHash ) {
+		RefreshHash();
+		return hash->GetNearestSprite(obj, r, type);
+	}
+	nearbyQuadrants.clear();
+	GetQuadrantsNear(obj->GetWorldPosition(),r,&nearbyQuadrants);
+	vector<Quadrant*>::iterator it;
 	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
 		possible = (*it)->GetNearestSprite(obj,r, type);
 		if(possible!=NULL) {
@@ -577,33 +849,72 @@ Coordinate SpriteManager::GetQuadrantCenter(Coordinate point){
  */
 int SpriteManager::GetNumSprites() {
 	unsigned int total = 0;
-	map<Coordinate,QuadTree*>::iterator iter;
+	map<Coordinate,Quadrant*>::iterator iter;
 	for ( iter = trees.begin(); iter != trees.end(); ++iter ) { 
 		total += iter->second->Count();
 	}
 	assert( total == spritelist->size() );
-	assert( total == spritelookup->size() );
 	return total;
 }
 
+/**\brief Mix some bytes into an FNV-1a checksum.
+ */
+static Uint32 HashBytes( Uint32 checksum, const void *data, size_t size ) {
+	const unsigned char *bytes = static_cast<const unsigned char*>( data );
+	for( size_t b = 0; b < size; ++b ) {
+		checksum = (checksum ^ bytes[b]) * 16777619u;
+	}
+	return checksum;
+}
+
+/**\brief A checksum of the state of every Sprite.
+ * \details The ID, type, position, momentum and angle of each Sprite are
+ *          hashed in the order of their ID slots.  Two Simulations that start from the same seed
+ *          and run for the same number of ticks must have the same hash.
+ */
+Uint32 SpriteManager::GetStateHash() {
+	Uint32 checksum = 2166136261u;
+	for( unsigned int slot = 0; slot < spritelookup->size(); ++slot ) {
+		Sprite *sprite = (*spritelookup)[slot];
+		if( sprite == NULL ) continue;
+		Coordinate position = sprite->GetWorldPosition();
+		Coordinate momentum = sprite->GetMomentum();
+		int id = sprite->GetID();
+		int drawOrder = sprite->GetDrawOrder();
+		float angle = sprite->GetAngle();
+		double values[4] = { position.GetX(), position.GetY(), momentum.GetX(), momentum.GetY() };
+
+		checksum = HashBytes( checksum, &id, sizeof(id) );
+		checksum = HashBytes( checksum, &drawOrder, sizeof(drawOrder) );
+		checksum = HashBytes( checksum, values, sizeof(values) );
+		checksum = HashBytes( checksum, &angle, sizeof(angle) );
+	}
+	return checksum;
+}
+
 /**\brief Returns QuadTree at Coordinate
  * \param point Coordinate
  */
-QuadTree* SpriteManager::GetQuadrant( Coordinate point ) {
+Quadrant* SpriteManager::GetQuadrant( Coordinate point ) {
 	Coordinate treeCenter = GetQuadrantCenter(point);
 
 	// Check in the known Quadrant
-	map<Coordinate,QuadTree*>::iterator iter;
-	iter = trees.find( treeCenter );
-	if( iter != trees.end() ) {
-		return iter->second;
+	Quadrant* known = FindQuadrant( treeCenter );
+	if( known != NULL ) {
+		return known;
 	}
 
 	// Create the new Tree and attach it to the universe
-	QuadTree *newTree = new QuadTree(treeCenter, QUADRANTSIZE);
+	Quadrant *newTree;
+	if( flatQuadrants ) {
+		newTree = new FlatQuadTree(treeCenter, QUADRANTSIZE);
+	} else {
+		newTree = new QuadTree(treeCenter, QUADRANTSIZE);
+	}
 	assert(treeCenter == newTree->GetCenter() );
 	assert(newTree->Contains(point));
 	trees.insert(make_pair(treeCenter, newTree));
+	quadrantCells.Insert( QuadrantKey(treeCenter.GetX()), QuadrantKey(treeCenter.GetY()) ) = newTree;
 	AdjustBoundaries();
 
 	// Debug
@@ -612,6 +923,40 @@ QuadTree* SpriteManager::GetQuadrant( Coordinate point ) {
 	return newTree;
 }
 
+/**\brief Returns the existing QuadTree centered at a Coordinate
+ * \param center The center of a Quadrant (see GetQuadrantCenter)
+ * \return The Quadrant or NULL if there isn't one.
+ */
+Quadrant* SpriteManager::FindQuadrant( Coordinate center ) {
+	Quadrant** found = quadrantCells.Find( QuadrantKey(center.GetX()), QuadrantKey(center.GetY()) );
+	return (found != NULL) ? *found : NULL;
+}
+
+/**\brief Check which broadphase the searches should use.
+ * \details Both options can be changed while the game is running.
+ */
+void SpriteManager::ReadBroadphaseOptions() {
+	bool wantHash = ( OPTION(string, "options/simulation/broadphase") == "hash" );
+	float cellSize = OPTION(float, "options/simulation/hash-cell-size");
+	if( cellSize > 0 && cellSize != hash->GetCellSize() ) {
+		hash->SetCellSize( cellSize );
+		hashDirty = true;
+	}
+	if( wantHash != useHash ) {
+		hashDirty = true;
+	}
+	useHash = wantHash;
+}
+
+/**\brief Rebuild the SpatialHash if it is out of date.
+ */
+void SpriteManager::RefreshHash() {
+	if( hashDirty ) {
+		hash->Rebuild( spritelist );
+		hashDirty = false;
+	}
+}
+
 /**\brief Get the universe boundaries
  * \note Returns the values through the pointer arguments.
  */
@@ -628,7 +973,7 @@ void SpriteManager::GetBoundaries(float *_northEdge, float *_southEdge, float *_
 void SpriteManager::AdjustBoundaries()
 {
 	Coordinate c;
-	map<Coordinate,QuadTree*>::iterator iter;
+	map<Coordinate,Quadrant*>::iterator iter;
 
 	northEdge = southEdge = eastEdge = westEdge = 0;
 	for ( iter = trees.begin(); iter != trees.end(); ++iter ) { 
@@ -649,7 +994,7 @@ void SpriteManager::AdjustBoundaries()
  * The point of this is to create a file that could be useful for debugging quadtree problems.
  */
 void SpriteManager::Save() {
-	map<Coordinate,QuadTree*>::iterator iter;
+	map<Coordinate,Quadrant*>::iterator iter;
 	xmlDocPtr doc = NULL;       /* document pointer */
 	xmlNodePtr root_node = NULL;/* node pointers */
 
@@ -683,9 +1028,9 @@ void SpriteManager::UpdateTickCount ()
  *   a helper method to get map->second to pass as the 4th argument of transform
  *   with the third argument being a back_inserter into the list we want)
  */
-void SpriteManager::GetAllQuadrants (list<QuadTree*> *newList)
+void SpriteManager::GetAllQuadrants (list<Quadrant*> *newList)
 {
-	map<Coordinate,QuadTree*>::iterator mapIter = trees.begin();
+	map<Coordinate,Quadrant*>::iterator mapIter = trees.begin();
 	while (mapIter != trees.end())
 	{
 		newList->push_back (mapIter->second);
@@ -9,7 +9,52 @@
 #define __H_SPRITEMANAGER__
 
 #include "Sprites/sprite.h"
-#include "Utilities/quadtree.h"
+#include "Utilities/quadrant.h"
+#include "Utilities/spatialhash.h"
+#include "Utilities/jobs.h"
+#include "Sprites/narrowphase.h"
+
+/**\brief Callback for SpriteManager::VisitSpritesNear.
+ */
+class SpriteVisitor {
+	public:
+		virtual ~SpriteVisitor() {}
+		virtual bool Visit( Sprite *sprite ) = 0; ///< Return false to stop the search.
+};
+
+/**\brief Job that moves the Sprites of one Quadrant.
+ */
+class QuadrantPhysicsJob : public Job {
+	public:
+		QuadrantPhysicsJob( Quadrant *_quadrant ) : quadrant(_quadrant) {}
+		void Run() { quadrant->UpdatePhysics(); }
+	private:
+		Quadrant *quadrant;
+};
+
+/**\brief Job that integrates a range of Kinematics slots.
+ */
+class KinematicsJob : public Job {
+	public:
+		KinematicsJob( unsigned int _first, unsigned int _last, Uint32 _frame ) : first(_first), last(_last), frame(_frame) {}
+		void Run() { Kinematics::IntegrateRange( first, last, frame ); }
+	private:
+		unsigned int first, last;
+		Uint32 frame;
+};
+
+/**\brief How long each part of SpriteManager::Update took, in nanoseconds.
+ * \details Every Update adds to these until SpriteManager::ResetProfile.
+ */
+struct UpdateProfile {
+	Uint64 physics;      ///< Moving the Sprites.
+	Uint64 collisions;   ///< Re-sorting the broadphase and resolving Projectile hits.
+	Uint64 update;       ///< Running the game logic of each Sprite.
+	Uint64 outOfBounds;  ///< Moving Sprites that left their Quadrant.
+	Uint64 deletion;     ///< Deleting Sprites and empty Quadrants.
+	Uint64 rebalance;    ///< Rebalancing the Quadrants.
+	Uint32 updates;      ///< The number of Updates that were measured.
+};
 
 class SpriteManager {
 	public:
@@ -24,16 +69,23 @@ class SpriteManager {
 		void Draw( Coordinate focus );
 		void DrawQuadrantMap( Coordinate focus );
 
-		Sprite *GetSpriteByID(int id);
+		Sprite *GetSpriteByID(SpriteHandle id);
+		Sprite *GetSpriteByID(SpriteHandle id, int type);
 		list<Sprite*> *GetSprites(int type = DRAW_ORDER_ALL);
-		list<Sprite*> *GetSpritesNear(Coordinate c, float r, int type = DRAW_ORDER_ALL);
+		void GetSpritesNear(Coordinate c, float r, vector<Sprite*> *found, int type = DRAW_ORDER_ALL, bool sorted = false, unsigned int limit = 0);
+		bool VisitSpritesNear(Coordinate c, float r, SpriteVisitor *visitor, int type = DRAW_ORDER_ALL, bool sorted = false, unsigned int limit = 0);
 		Sprite* GetNearestSprite(Sprite *obj, float r, int type = DRAW_ORDER_ALL);
 		Sprite* GetNearestSprite(Coordinate c, float r, int type = DRAW_ORDER_ALL);
 
 		Coordinate GetQuadrantCenter( Coordinate point );
 		int GetNumQuadrants() { return trees.size(); }
 		int GetNumSprites();
+		unsigned int GetRelocations() { return relocations; }
 		void GetBoundaries(float *northEdge, float *southEdge, float *eastEdge, float *westEdge);
+		Uint32 GetStateHash();
+
+		const UpdateProfile& GetProfile() { return profile; }
+		void ResetProfile();
 
 		void Save();
 		
@@ -42,13 +94,32 @@ class SpriteManager {
 	private:
 		// These structures each contain a complete list of all Sprites.
 		// Each one is useful for a different purpose, depending on the way that the sprites need to be accessed.
-		map<Coordinate,QuadTree*> trees;    ///< Collection of all Sprites.  Use the tree when referring to the sprites at a location.
+		map<Coordinate,Quadrant*> trees;    ///< Collection of all Sprites.  Use the tree when referring to the sprites at a location.
+		bool flatQuadrants;                 ///< New Quadrants use the pooled FlatQuadTree rather than the recursive QuadTree.
+		CellTable<Quadrant*> quadrantCells; ///< The same Quadrants as trees, keyed by their integer grid position.
+		SpatialHash *hash;                  ///< Collection of all Sprites.  Use the hash for location searches when the broadphase option is "hash".
+		bool useHash;                       ///< Searches use the SpatialHash rather than the Quadrants.
+		bool hashDirty;                     ///< The SpatialHash holds Sprites that have since been deleted.
 		list<Sprite*> *spritelist;          ///< Collection of all Sprites.  Use the list when referring to all sprites.
-		map<int,Sprite*> *spritelookup;     ///< Collection of all Sprites.  Use the map when referring to sprites by their unique ID.
+		vector<Sprite*> *spritelookup;      ///< Collection of all Sprites.  Use the lookup when referring to sprites by their unique ID.  Indexed by the slot of each ID.
 
 		Sprite *player;                     ///< The Player Sprite.
 		
 		list<Sprite *> spritesToDelete;     ///< The list of Sprites that should be deleted at the end of this Update.
+
+		/// Sprites that were Added or Deleted by one thread while the physics Jobs were running.
+		struct CommandBuffer {
+			vector<Sprite*> added;
+			vector<Sprite*> deleted;
+		};
+		vector<CommandBuffer> commands;     ///< One CommandBuffer per Job thread.
+		vector<QuadrantPhysicsJob> physicsJobs; ///< Reusable buffer for the Jobs of one Update.
+		vector<KinematicsJob> kinematicsJobs;   ///< Reusable buffer for the Jobs of one Update.
+		bool parallel;                      ///< The physics Jobs are running, so changes must go into the commands.
+
+		Narrowphase narrowphase;            ///< Finds the Projectiles that hit Ships.
+		vector<Contact> contacts;           ///< The Projectiles that hit Ships during this Update.
+		vector<Sprite*> collisionSprites;   ///< Reusable buffer for FindContacts.
 		static SpriteManager *pInstance;    ///< The Static SpriteManager Instance.
 
 		int tickCount;                      ///< Counts number of ticks to track updates to quadrants.  Max value is the number of ticks to update all quadrants
@@ -61,15 +132,29 @@ class SpriteManager {
 
 		float northEdge, southEdge, eastEdge, westEdge; ///< The Edges of the universe
 
+		vector<Sprite*> outOfBounds;        ///< Reusable buffer for Sprites that left their Quadrant during an Update.
+		unsigned int relocations;           ///< The number of Sprites that changed Leaves or Quadrants during the last Update.
+		vector<Quadrant*> nearbyQuadrants;  ///< Reusable buffer for GetQuadrantsNear.
+		vector<Sprite*> onscreen;           ///< Reusable buffer for Draw.
+		vector< vector<Sprite*>* > visitBuffers; ///< Reusable buffers for VisitSpritesNear, one per level of nesting.
+		unsigned int visitDepth;            ///< How many VisitSpritesNear calls are in progress.
+		UpdateProfile profile;              ///< Time spent in each part of Update.
+
 		bool DeleteSprite( Sprite *sprite );
 		void DeleteEmptyQuadrants( void );
-		QuadTree* GetQuadrant( Coordinate point );
-		list<QuadTree*> GetQuadrantsNear( Coordinate c, float r);
-		list<QuadTree*> GetQuadrantsInBand ( Coordinate c, int bandIndex);
+		void FindContacts( list<Quadrant*> *quadList );
+		Quadrant* GetQuadrant( Coordinate point );
+		Quadrant* FindQuadrant( Coordinate center );
+		static int QuadrantKey( double v ) { return static_cast<int>(floor( v / (QUADRANTSIZE*2.0) + 0.5 )); } ///< Grid position of a Quadrant center along one axis.
+		void ReadBroadphaseOptions();
+		void RefreshHash();
+		void GetQuadrantsNear( Coordinate c, float r, vector<Quadrant*> *nearbyQuadrants );
+		list<Quadrant*> GetQuadrantsInBand ( Coordinate c, int bandIndex);
 		void AdjustBoundaries();
 		void UpdateTickCount();
+		void IntegrateAll();
 
-		void GetAllQuadrants( list<QuadTree*> *newTree);
+		void GetAllQuadrants( list<Quadrant*> *newTree);
 };
 
 #endif // __H_SPRITEMANAGER__
@@ -0,0 +1,227 @@
+/**\file			statemachines.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			AI State Machines resolved to Lua registry references.
+ * \details
+ */
+
+#include "includes.h"
+#include "Sprites/statemachines.h"
+#include "Utilities/log.h"
+#include "Utilities/timer.h"
+
+/** \addtogroup Sprites
+ * @{
+ */
+
+/**\class StateMachines
+ * \brief The AI State Machines, compiled so that each state can be run without
+ *        looking it up by name.
+ *
+ * A State Machine is a global Lua table of functions, one for each state (see
+ * ai.lua).  When a Machine is first used, each of its functions is stored as a
+ * registry reference and each state name is given an integer ID.  An AI then
+ * only has to remember its Machine and state IDs, and running a state is a
+ * single lua_rawgeti.
+ *
+ * Scripts may replace a Machine, or change its states, at any time.  Once per
+ * logical frame Refresh compares every compiled Machine against its global
+ * table and recompiles any that changed.  Recompiling can renumber the states,
+ * so the generation is increased and each AI looks up its state again by name.
+ *
+ * \warn The references belong to one lua_State.  Reset must be called whenever
+ *       a new lua_State is used.
+ * \see AI::Decide
+ */
+
+vector<StateMachines::Machine> StateMachines::machines;
+map<string,int> StateMachines::machineIDs;
+Uint32 StateMachines::generation = 1;
+Uint32 StateMachines::refreshedFrame = 0;
+
+/**\brief Get the ID of a State Machine, compiling it if this is its first use.
+ * \returns -1 if there is no table with this name.
+ */
+int StateMachines::Find( lua_State *L, const string& machine ) {
+	map<string,int>::iterator known = machineIDs.find( machine );
+	if( known != machineIDs.end() ) {
+		return (machines[ known->second ].table == LUA_NOREF) ? -1 : known->second;
+	}
+
+	int id = machines.size();
+	machineIDs[ machine ] = id;
+	machines.push_back( Machine() );
+	machines[id].name = machine;
+	machines[id].table = LUA_NOREF;
+	machines[id].states = LUA_NOREF;
+	if( !Compile( L, &machines[id] ) ) {
+		return -1;
+	}
+	return id;
+}
+
+/**\brief Get the ID of a state within a State Machine.
+ * \returns -1 if the Machine has no state with this name.
+ */
+int StateMachines::FindState( int machine, const string& state ) {
+	vector<string>& names = machines[machine].names;
+	for( unsigned int s = 0; s < names.size(); ++s ) {
+		if( names[s] == state ) {
+			return s;
+		}
+	}
+	return -1;
+}
+
+/**\brief Get the name of a state within a State Machine.
+ */
+const string& StateMachines::GetStateName( int machine, int state ) {
+	return machines[machine].names[state];
+}
+
+/**\brief Push the function of a state onto the Lua stack.
+ */
+void StateMachines::PushState( lua_State *L, int machine, int state ) {
+	lua_rawgeti( L, LUA_REGISTRYINDEX, machines[machine].functions[state] );
+}
+
+/**\brief Get the ID of the state named by a value on the Lua stack.
+ * \returns -1 if the value is not the name of one of the Machine's states.
+ */
+int StateMachines::ToState( lua_State *L, int machine, int index ) {
+	lua_pushvalue( L, index );
+	lua_rawgeti( L, LUA_REGISTRYINDEX, machines[machine].states );
+	lua_insert( L, -2 );
+	lua_rawget( L, -2 );
+	int state = lua_isnumber( L, -1 ) ? static_cast<int>( lua_tointeger( L, -1 ) ) : -1;
+	lua_pop( L, 2 );
+	return state;
+}
+
+/**\brief Recompile any State Machines that scripts have changed.
+ * \details This only checks once per logical frame, so it is cheap to call
+ *          before every Decide.
+ */
+void StateMachines::Refresh( lua_State *L ) {
+	Uint32 frame = Timer::GetLogicalFrameCount();
+	if( frame == refreshedFrame ) {
+		return;
+	}
+	refreshedFrame = frame;
+
+	for( unsigned int m = 0; m < machines.size(); ++m ) {
+		if( Changed( L, m ) ) {
+			LogMsg(INFO, "Recompiling the State Machine '%s'.", machines[m].name.c_str() );
+			Compile( L, &machines[m] );
+			// Only the AI using an existing Machine could have remembered its state IDs.
+			generation++;
+		}
+	}
+}
+
+/**\brief Forget every compiled State Machine.
+ * \details Call this when a new lua_State is created.  The references are not
+ *          released since the old lua_State may already be closed.
+ */
+void StateMachines::Reset() {
+	machines.clear();
+	machineIDs.clear();
+	generation++;
+	refreshedFrame = 0;
+}
+
+/**\brief Resolve the global table of a State Machine into references.
+ * \returns false if there is no table with the Machine's name.
+ */
+bool StateMachines::Compile( lua_State *L, Machine *machine ) {
+	Release( L, machine );
+
+	lua_getglobal( L, machine->name.c_str() );
+	if( !lua_istable( L, -1 ) ) {
+		lua_pop( L, 1 );
+		return false;
+	}
+	int table = lua_gettop( L );
+	lua_newtable( L );
+	int states = lua_gettop( L );
+
+	lua_pushnil( L );
+	while( lua_next( L, table ) != 0 ) {
+		// Only string keys are states, and lua_tostring would change any others.
+		if( lua_type( L, -2 ) == LUA_TSTRING && lua_isfunction( L, -1 ) ) {
+			int id = machine->names.size();
+			machine->names.push_back( lua_tostring( L, -2 ) );
+			machine->functions.push_back( luaL_ref( L, LUA_REGISTRYINDEX ) ); // Pops the function
+
+			lua_pushvalue( L, -1 );
+			lua_pushinteger( L, id );
+			lua_rawset( L, states );
+		} else {
+			lua_pop( L, 1 );
+		}
+	}
+
+	machine->states = luaL_ref( L, LUA_REGISTRYINDEX ); // Pops the states
+	machine->table = luaL_ref( L, LUA_REGISTRYINDEX ); // Pops the table
+	return true;
+}
+
+/**\brief Release the references of a State Machine.
+ */
+void StateMachines::Release( lua_State *L, Machine *machine ) {
+	luaL_unref( L, LUA_REGISTRYINDEX, machine->table );
+	luaL_unref( L, LUA_REGISTRYINDEX, machine->states );
+	for( unsigned int s = 0; s < machine->functions.size(); ++s ) {
+		luaL_unref( L, LUA_REGISTRYINDEX, machine->functions[s] );
+	}
+	machine->table = LUA_NOREF;
+	machine->states = LUA_NOREF;
+	machine->functions.clear();
+	machine->names.clear();
+}
+
+/**\brief Check whether a State Machine's global table is different from when
+ *        it was compiled.
+ * \details The table may have been replaced, or had states added, removed or
+ *          replaced.
+ */
+bool StateMachines::Changed( lua_State *L, int m ) {
+	Machine *machine = &machines[m];
+	const int initialStackTop = lua_gettop( L );
+	bool changed = false;
+
+	lua_getglobal( L, machine->name.c_str() );
+	int table = lua_gettop( L );
+	if( machine->table == LUA_NOREF ) {
+		changed = lua_istable( L, table );
+	} else {
+		lua_rawgeti( L, LUA_REGISTRYINDEX, machine->table );
+		changed = !lua_rawequal( L, table, -1 );
+	}
+
+	if( !changed && machine->table != LUA_NOREF ) {
+		unsigned int count = 0;
+		lua_pushnil( L );
+		while( !changed && lua_next( L, table ) != 0 ) {
+			if( lua_type( L, -2 ) == LUA_TSTRING && lua_isfunction( L, -1 ) ) {
+				int state = ToState( L, m, -2 );
+				if( state < 0 ) {
+					changed = true;
+				} else {
+					lua_rawgeti( L, LUA_REGISTRYINDEX, machine->functions[state] );
+					changed = !lua_rawequal( L, -1, -2 );
+					lua_pop( L, 1 );
+				}
+				count++;
+			}
+			lua_pop( L, 1 );
+		}
+		changed = changed || ( count != machine->functions.size() );
+	}
+
+	lua_settop( L, initialStackTop );
+	return changed;
+}
+
+/** @} */
@@ -0,0 +1,49 @@
+/**\file			statemachines.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			AI State Machines resolved to Lua registry references.
+ * \details
+ */
+
+#ifndef __H_STATEMACHINES__
+#define __H_STATEMACHINES__
+
+#include "includes.h"
+#include "Utilities/lua.h"
+
+class StateMachines {
+	public:
+		static int Find( lua_State *L, const string& machine );
+		static int FindState( int machine, const string& state );
+		static const string& GetStateName( int machine, int state );
+
+		static void PushState( lua_State *L, int machine, int state );
+		static int ToState( lua_State *L, int machine, int index );
+
+		static void Refresh( lua_State *L );
+		static void Reset();
+
+		static Uint32 GetGeneration() { return generation; }
+
+	private:
+		/// One State Machine table, compiled.
+		struct Machine {
+			string name;
+			int table;               ///< Registry reference to the table that was compiled, or LUA_NOREF if there was none.
+			int states;              ///< Registry reference to a table of state IDs by state name.
+			vector<int> functions;   ///< Registry reference to the function of each state, by state ID.
+			vector<string> names;    ///< The name of each state, by state ID.
+		};
+
+		static bool Compile( lua_State *L, Machine *machine );
+		static void Release( lua_State *L, Machine *machine );
+		static bool Changed( lua_State *L, int m );
+
+		static vector<Machine> machines;
+		static map<string,int> machineIDs;  ///< The ID of each Machine, by name.
+		static Uint32 generation;           ///< Increased every time that a Machine is recompiled or Reset.
+		static Uint32 refreshedFrame;       ///< The logical frame of the last Refresh.
+};
+
+#endif // __H_STATEMACHINES__
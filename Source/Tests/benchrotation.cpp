@@ -0,0 +1,184 @@
+/**\file			benchrotation.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Compares rotating Images in a vertex shader with rotating them on the CPU
+ * \details
+ * 10,000 Images are drawn at random positions and angles, first rotated on
+ * the CPU with the Trig tables and then, if the driver has one, rotated by
+ * the SpriteBatch's vertex shader.
+ *
+ * Before that, the corners alone are rotated the way Image::_Draw used to,
+ * with atan2, sqrt, cos and sin for every corner, and with the Trig tables.
+ * The tables must stay within a pixel of the exact corners.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Graphics/image.h"
+#include "Graphics/spritebatch.h"
+#include "Graphics/video.h"
+#include "Utilities/options.h"
+#include "Utilities/trig.h"
+#include "Tests/benchrotation.h"
+
+#define BENCH_SPRITES 10000
+#define BENCH_FRAMES  20
+
+/// One rotated Image to draw.
+struct BenchRotated {
+	int x, y;
+	float angle; ///< In degrees.
+};
+
+/**\brief Rotate a point the way that Image::_Draw used to.
+ */
+static void ExactRotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang ) {
+	float theta = atan2( y - ay, x - ax );
+	float dist = sqrt( ((x - ax)*(x-ax)) + ((y - ay)*(y-ay)) );
+	float ntheta = theta + ang;
+
+	*nx = ax + (dist * cos( ntheta ) );
+	*ny = ay - (dist * sin( ntheta ) );
+}
+
+/**\brief Rotate the corners of every Image both ways, and check that they agree.
+ * \returns The number of failures.
+ */
+static int CompareCorners( const vector<BenchRotated>& sprites, float w, float h ) {
+	Trig *trig = Trig::Instance();
+	const float cornerX[4] = { -w / 2.f, w / 2.f, w / 2.f, -w / 2.f };
+	const float cornerY[4] = { -h / 2.f, -h / 2.f, h / 2.f, h / 2.f };
+	float exactX[4], exactY[4], tableX[4], tableY[4];
+	float worst = 0.f;
+	double exactSum = 0., tableSum = 0.; // Printed, so that the compiler can't skip the rotations
+	double exactSeconds, tableSeconds;
+	clock_t start;
+	unsigned int i;
+	int frame, c;
+
+	start = clock();
+	for( frame = 0; frame < BENCH_FRAMES; ++frame ) {
+		for( i = 0; i < sprites.size(); ++i ) {
+			const float a = static_cast<float>( trig->DegToRad( sprites[i].angle ) );
+			for( c = 0; c < 4; ++c ) {
+				ExactRotatePoint( sprites[i].x + cornerX[c], sprites[i].y + cornerY[c],
+					static_cast<float>(sprites[i].x), static_cast<float>(sprites[i].y), &exactX[c], &exactY[c], a );
+				exactSum += exactX[c] + exactY[c];
+			}
+		}
+	}
+	exactSeconds = static_cast<double>( clock() - start ) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for( frame = 0; frame < BENCH_FRAMES; ++frame ) {
+		for( i = 0; i < sprites.size(); ++i ) {
+			const float a = static_cast<float>( trig->DegToRad( sprites[i].angle ) );
+			float s, co;
+			trig->GetSinCos( a, &s, &co );
+			for( c = 0; c < 4; ++c ) {
+				tableX[c] = sprites[i].x + (cornerX[c] * co - cornerY[c] * s);
+				tableY[c] = sprites[i].y - (cornerX[c] * s + cornerY[c] * co);
+				tableSum += tableX[c] + tableY[c];
+			}
+		}
+	}
+	tableSeconds = static_cast<double>( clock() - start ) / CLOCKS_PER_SEC;
+
+	// Measure the error separately, so that the timings are only the rotations.
+	for( i = 0; i < sprites.size(); ++i ) {
+		const float a = static_cast<float>( trig->DegToRad( sprites[i].angle ) );
+		for( c = 0; c < 4; ++c ) {
+			ExactRotatePoint( sprites[i].x + cornerX[c], sprites[i].y + cornerY[c],
+				static_cast<float>(sprites[i].x), static_cast<float>(sprites[i].y), &exactX[c], &exactY[c], a );
+			trig->RotatePoint( sprites[i].x + cornerX[c], sprites[i].y + cornerY[c],
+				static_cast<float>(sprites[i].x), static_cast<float>(sprites[i].y), &tableX[c], &tableY[c], a );
+			worst = max( worst, static_cast<float>( fabs( exactX[c] - tableX[c] ) ) );
+			worst = max( worst, static_cast<float>( fabs( exactY[c] - tableY[c] ) ) );
+		}
+	}
+
+	cout << "Corners, exact: " << exactSeconds << "s, tables: " << tableSeconds << "s";
+	if( tableSeconds > 0 ) {
+		cout << " (" << exactSeconds / tableSeconds << "x)";
+	}
+	cout << ", worst error " << worst << " pixels" << endl;
+	cout << "Corner checksums, exact: " << exactSum << ", tables: " << tableSum << endl;
+
+	if( worst > 1.f ) {
+		cout << "Failed: the Trig tables are more than a pixel away from the exact corners." << endl;
+		return 1;
+	}
+	return 0;
+}
+
+/**\brief Draw every Image BENCH_FRAMES times.
+ * \returns The milliseconds per frame.
+ */
+static double DrawFrames( Image *image, const vector<BenchRotated>& sprites ) {
+	Uint32 start;
+	int frame;
+	unsigned int i;
+
+	// Draw once first, so that the texture and the shader are ready.
+	for( i = 0; i < sprites.size(); ++i ) {
+		image->DrawCentered( sprites[i].x, sprites[i].y, sprites[i].angle );
+	}
+	SpriteBatch::Flush();
+	glFinish();
+
+	start = SDL_GetTicks();
+	for( frame = 0; frame < BENCH_FRAMES; ++frame ) {
+		Video::Erase();
+		for( i = 0; i < sprites.size(); ++i ) {
+			image->DrawCentered( sprites[i].x, sprites[i].y, sprites[i].angle );
+		}
+		SpriteBatch::Flush();
+		glFinish();
+	}
+	return static_cast<double>( SDL_GetTicks() - start ) / BENCH_FRAMES;
+}
+
+/**\brief Time 10,000 rotated Images with and without the rotation shader.
+ */
+int test_bench_rotation(int argc, char **argv){
+	vector<BenchRotated> sprites;
+	int failures = 0;
+	unsigned int i;
+
+	Image *image = Image::Get( "Resources/Graphics/terran-frigate.png" );
+	if( image == NULL ) {
+		cout << "Failed: could not load the Image to draw." << endl;
+		return 1;
+	}
+
+	srand( 1 );
+	for( i = 0; i < BENCH_SPRITES; ++i ) {
+		BenchRotated sprite;
+		sprite.x = rand() % Video::GetWidth();
+		sprite.y = rand() % Video::GetHeight();
+		sprite.angle = static_cast<float>( rand() % 3599 + 1 ) / 10.f; // Never 0, which isn't rotated
+		sprites.push_back( sprite );
+	}
+
+	failures += CompareCorners( sprites, static_cast<float>( image->GetWidth() ), static_cast<float>( image->GetHeight() ) );
+
+	SpriteBatch::UseRotateShader( false );
+	double tableMs = DrawFrames( image, sprites );
+	cout << "Draw, tables: " << tableMs << "ms per frame" << endl;
+
+	if( SpriteBatch::HasRotateShader() ) {
+		SpriteBatch::UseRotateShader( true );
+		double shaderMs = DrawFrames( image, sprites );
+		cout << "Draw, vertex shader: " << shaderMs << "ms per frame";
+		if( shaderMs > 0 ) {
+			cout << " (" << tableMs / shaderMs << "x)";
+		}
+		cout << endl;
+	} else {
+		cout << "Draw, vertex shader: not supported by this driver" << endl;
+	}
+
+	SpriteBatch::UseRotateShader( OPTION( bool, "options/video/rotate-shader" ) );
+	return failures;
+}
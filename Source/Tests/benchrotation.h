@@ -0,0 +1,13 @@
+/**\file			benchrotation.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Compares rotating Images in a vertex shader with rotating them on the CPU
+ * \details
+ */
+
+
+#ifndef __H_TEST_BENCHROTATION__
+#define __H_TEST_BENCHROTATION__
+int test_bench_rotation(int argc, char **argv);
+#endif // __H_TEST_BENCHROTATION__
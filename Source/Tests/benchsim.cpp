@@ -0,0 +1,311 @@
+/**\file			benchsim.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Simulation tick benchmarks
+ * \details
+ * Each benchmark fills the default Simulation with a number of Sprites, half
+ * AI Ships, then Projectiles and Effects, and runs it headless for a number of
+ * logical ticks (100 unless --ticks is given).  The results are printed as one
+ * line of JSON per benchmark so that they can be tracked over time:
+ *
+ * \code
+ * {"benchmark":"bench-sim-1k","sprites":1000,"ships":500,"projectiles":300,
+ *  "effects":200,"ticks":100,"ns_per_tick":...,"phases_ns_per_tick":{...},
+ *  "peak_rss_kb":...,"allocs_per_tick":...,"lua_allocs_per_tick":...}
+ * \endcode
+ *
+ * The phases are the parts of SpriteManager::Update (see UpdateProfile).
+ * The AI tiers are averaged from AIScheduler::GetStats.
+ * Allocations count every C++ new and every Lua allocation that grew memory
+ * while the ticks are being measured.  Outside of that window nothing is
+ * counted, so the rest of the game only pays for one test of a flag.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/aischeduler.h"
+#include "Sprites/effects.h"
+#include "Sprites/projectile.h"
+#include "Sprites/spritemanager.h"
+#include "Utilities/argparser.h"
+#include "Utilities/jobs.h"
+#include "Utilities/lua.h"
+#include "Utilities/random.h"
+#include "Utilities/timer.h"
+#include "Tests/benchsim.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+extern ArgParser *argparser;
+
+#define BENCH_DEFAULT_TICKS 100
+#define BENCH_WARMUP_TICKS  5
+#define BENCH_SEED          1
+#define BENCH_SPACING       300 ///< Average distance between Sprites, in pixels.
+
+// Allocation counting
+
+// Dynamic exception specifications are deprecated after C++98.
+#if __cplusplus >= 201103L
+#define BENCH_THROWS_BAD_ALLOC
+#define BENCH_THROWS_NOTHING noexcept
+#else
+#define BENCH_THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define BENCH_THROWS_NOTHING throw()
+#endif
+
+static volatile bool countingAllocations = false; ///< Only set while a benchmark is measuring.
+static volatile long allocations = 0;
+
+static void CountAllocation() {
+	if( !countingAllocations ) {
+		return;
+	}
+#if defined(__GNUC__)
+	__sync_fetch_and_add( &allocations, 1 );
+#elif defined(_WIN32)
+	InterlockedIncrement( &allocations );
+#else
+	allocations++;
+#endif
+}
+
+void* operator new( size_t size ) BENCH_THROWS_BAD_ALLOC {
+	CountAllocation();
+	void *p = malloc( size ? size : 1 );
+	if( p == NULL ) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[]( size_t size ) BENCH_THROWS_BAD_ALLOC {
+	CountAllocation();
+	void *p = malloc( size ? size : 1 );
+	if( p == NULL ) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete( void *p ) BENCH_THROWS_NOTHING { free( p ); }
+void operator delete[]( void *p ) BENCH_THROWS_NOTHING { free( p ); }
+
+static lua_Alloc luaAllocator = NULL;
+static void *luaAllocatorData = NULL;
+static long luaAllocations = 0;
+
+/**\brief Lua allocator that counts every allocation that needs more memory.
+ */
+static void* CountingLuaAlloc( void *ud, void *ptr, size_t osize, size_t nsize ) {
+	if( countingAllocations && (nsize > osize) ) {
+		luaAllocations++;
+	}
+	return luaAllocator( luaAllocatorData, ptr, osize, nsize );
+}
+
+/**\brief The largest resident set of this process so far, in kilobytes.
+ * \returns -1 if this platform can't tell.
+ */
+static long PeakRSS() {
+#ifdef _WIN32
+	return -1;
+#else
+	struct rusage usage;
+	if( getrusage( RUSAGE_SELF, &usage ) != 0 ) {
+		return -1;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // bytes
+#else
+	return usage.ru_maxrss; // kilobytes
+#endif
+#endif
+}
+
+// Benchmark Setup
+
+/**\brief Load the default Simulation without a window, once per process.
+ */
+static Simulation* GetBenchSimulation() {
+	static Simulation *simulation = NULL;
+	if( simulation == NULL ) {
+		Timer::Initialize();
+		Timer::UseVirtualClock();
+		Jobs::Initialize( OPTION(int, "options/simulation/threads") );
+		Random::Seed( BENCH_SEED );
+
+		// Only keep the Simulation once it has loaded, so that a failure isn't benchmarked later.
+		Simulation *loading = new Simulation();
+		loading->SetHeadless( true );
+		if( !loading->Load( "default" ) || !loading->SetupToRun() ) {
+			LogMsg(ERR, "Could not load the default Simulation for benchmarking." );
+			delete loading;
+			return NULL;
+		}
+		simulation = loading;
+
+		lua_State *L = Lua::CurrentState();
+		luaAllocator = lua_getallocf( L, &luaAllocatorData );
+		lua_setallocf( L, CountingLuaAlloc, NULL );
+	}
+	return simulation;
+}
+
+/**\brief Remove every Ship, Projectile and Effect.
+ */
+static void ClearBench( SpriteManager *sprites ) {
+	list<Sprite*> *movers = sprites->GetSprites( DRAW_ORDER_SHIP | DRAW_ORDER_PROJECTILE | DRAW_ORDER_EFFECT );
+	for( list<Sprite*>::iterator i = movers->begin(); i != movers->end(); ++i ) {
+		sprites->Delete( *i );
+	}
+	delete movers;
+	sprites->Update( Lua::CurrentState(), false );
+}
+
+/**\brief Run one benchmark and print its results.
+ * \returns 0 on success.
+ */
+static int RunBench( const string& name, unsigned int count ) {
+	Simulation *simulation = GetBenchSimulation();
+	if( simulation == NULL ) {
+		return -1;
+	}
+	SpriteManager *sprites = simulation->GetSpriteManager();
+	lua_State *L = Lua::CurrentState();
+
+	Uint32 ticks = BENCH_DEFAULT_TICKS;
+	string ticksValue = argparser->HaveValue("ticks");
+	if( ticksValue != "" ) {
+		ticks = convertTo<Uint32>( ticksValue );
+	}
+
+	const unsigned int ships = count / 2;
+	const unsigned int projectiles = count * 3 / 10;
+	const unsigned int effects = count - ships - projectiles;
+	const int side = static_cast<int>( sqrt( static_cast<double>(count) ) * BENCH_SPACING );
+	unsigned int i;
+
+	ClearBench( sprites );
+
+	// The Ships are made by the same Lua that makes the planet traffic.
+	stringstream shipScript;
+	shipScript << "local models, engines, weapons = Epiar.models(), Epiar.engines(), Epiar.weapons() "
+	           << "for i=1," << ships << " do createRandomShip(0, 0, " << side << ", models, engines, weapons) end";
+	Lua::Run( shipScript.str() );
+
+	list<string>* weaponNames = simulation->GetWeapons()->GetNames();
+	vector<Weapon*> weapons;
+	for( list<string>::iterator w = weaponNames->begin(); w != weaponNames->end(); ++w ) {
+		weapons.push_back( simulation->GetWeapons()->GetWeapon( *w ) );
+	}
+	if( weapons.empty() ) {
+		LogMsg(ERR, "The default Simulation has no Weapons to benchmark." );
+		return -1;
+	}
+	for( i = 0; i < projectiles; ++i ) {
+		Coordinate position( Random::Int(side) - side/2, Random::Int(side) - side/2 );
+		Projectile *projectile = new Projectile( 1.0f, float( Random::Int(360) ), position, GaussianCoordinate(), weapons[ Random::Int(weapons.size()) ] );
+		sprites->Add( projectile );
+	}
+	for( i = 0; i < effects; ++i ) {
+		Coordinate position( Random::Int(side) - side/2, Random::Int(side) - side/2 );
+		sprites->Add( new Effect( position, "Resources/Animations/explosion1.ani", 1.0f ) );
+	}
+
+	// Let the AI pick their first states before measuring.
+	Uint32 tick;
+	for( tick = 0; tick < BENCH_WARMUP_TICKS; ++tick ) {
+		Timer::AdvanceVirtualClock( static_cast<Uint32>( 1000 / LOGIC_FPS ) );
+		Timer::Update();
+		Timer::IncrementFrameCount();
+		sprites->Update( L, false );
+	}
+
+	sprites->ResetProfile();
+	long allocationsBefore = allocations;
+	long luaAllocationsBefore = luaAllocations;
+	countingAllocations = true;
+	Uint64 start = Timer::GetNanoseconds();
+	AITierStats tiers[AI_TIERS];
+	memset( tiers, 0, sizeof(tiers) );
+	for( tick = 0; tick < ticks; ++tick ) {
+		Timer::AdvanceVirtualClock( static_cast<Uint32>( 1000 / LOGIC_FPS ) );
+		Timer::Update();
+		Timer::IncrementFrameCount();
+		sprites->Update( L, false );
+		for( int t = 0; t < AI_TIERS; ++t ) {
+			const AITierStats& stats = AIScheduler::GetStats( t );
+			tiers[t].ships += stats.ships;
+			tiers[t].decisions += stats.decisions;
+			tiers[t].deferred += stats.deferred;
+			tiers[t].time += stats.time;
+		}
+	}
+	Uint64 elapsed = Timer::GetNanoseconds() - start;
+	countingAllocations = false;
+	long allocationsDuring = allocations - allocationsBefore;
+	long luaAllocationsDuring = luaAllocations - luaAllocationsBefore;
+
+	const UpdateProfile& profile = sprites->GetProfile();
+	const double perTick = (ticks > 0) ? 1.0 / ticks : 0.0;
+	cout << fixed << setprecision(1)
+	     << "{\"benchmark\":\"" << name << "\""
+	     << ",\"sprites\":" << count
+	     << ",\"ships\":" << ships
+	     << ",\"projectiles\":" << projectiles
+	     << ",\"effects\":" << effects
+	     << ",\"ticks\":" << ticks
+	     << ",\"threads\":" << Jobs::GetNumThreads()
+	     << ",\"final_sprites\":" << sprites->GetNumSprites()
+	     << ",\"ns_per_tick\":" << elapsed * perTick
+	     << ",\"phases_ns_per_tick\":{"
+	     <<     "\"physics\":" << profile.physics * perTick
+	     <<     ",\"collisions\":" << profile.collisions * perTick
+	     <<     ",\"update\":" << profile.update * perTick
+	     <<     ",\"out_of_bounds\":" << profile.outOfBounds * perTick
+	     <<     ",\"delete\":" << profile.deletion * perTick
+	     <<     ",\"rebalance\":" << profile.rebalance * perTick
+	     << "}"
+	     << ",\"ai_tiers_per_tick\":{";
+	for( int t = 0; t < AI_TIERS; ++t ) {
+		cout << (t ? "," : "") << "\"" << AIScheduler::GetTierName( t ) << "\":{"
+		     << "\"ships\":" << tiers[t].ships * perTick
+		     << ",\"decisions\":" << tiers[t].decisions * perTick
+		     << ",\"deferred\":" << tiers[t].deferred * perTick
+		     << ",\"ns\":" << tiers[t].time * perTick
+		     << "}";
+	}
+	cout << "}"
+	     << ",\"peak_rss_kb\":" << PeakRSS()
+	     << ",\"allocs_per_tick\":" << allocationsDuring * perTick
+	     << ",\"lua_allocs_per_tick\":" << luaAllocationsDuring * perTick
+	     << "}" << endl;
+
+	return 0;
+}
+
+/**\brief Run the 1k, 10k and 100k Sprite benchmarks in turn.
+ */
+int test_bench_sim(int argc, char **argv){
+	int failures = 0;
+	failures += ( test_bench_sim_1k( argc, argv ) != 0 );
+	failures += ( test_bench_sim_10k( argc, argv ) != 0 );
+	failures += ( test_bench_sim_100k( argc, argv ) != 0 );
+	return failures;
+}
+
+/**\brief Benchmark 1,000 Sprites.*/
+int test_bench_sim_1k(int argc, char **argv){
+	return RunBench( "bench-sim-1k", 1000 );
+}
+
+/**\brief Benchmark 10,000 Sprites.*/
+int test_bench_sim_10k(int argc, char **argv){
+	return RunBench( "bench-sim-10k", 10000 );
+}
+
+/**\brief Benchmark 100,000 Sprites.*/
+int test_bench_sim_100k(int argc, char **argv){
+	return RunBench( "bench-sim-100k", 100000 );
+}
@@ -0,0 +1,16 @@
+/**\file			benchsim.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Simulation tick benchmarks
+ * \details
+ */
+
+
+#ifndef __H_TEST_BENCHSIM__
+#define __H_TEST_BENCHSIM__
+int test_bench_sim(int argc, char **argv);
+int test_bench_sim_1k(int argc, char **argv);
+int test_bench_sim_10k(int argc, char **argv);
+int test_bench_sim_100k(int argc, char **argv);
+#endif // __H_TEST_BENCHSIM__
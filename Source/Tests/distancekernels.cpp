@@ -0,0 +1,148 @@
+/**\file			distancekernels.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Compares and times the vectorized distance kernels
+ * \details
+ * A scene of 100,000 Sprites is searched once at every level that this CPU
+ * supports.  Every level must find exactly what the scalar kernels find.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/sprite.h"
+#include "Utilities/distancekernels.h"
+#include "Utilities/spatialhash.h"
+
+#define BENCH_SPRITES 100000
+#define BENCH_QUERIES 2000
+#define BENCH_WORLD   50000
+
+/// A Sprite that only has a position and a type.
+class BenchSprite : public Sprite {
+	public:
+		BenchSprite( Coordinate position, int _drawOrder ) : drawOrder( _drawOrder ) { SetWorldPosition( position ); }
+		int GetDrawOrder( void ) { return drawOrder; }
+	private:
+		int drawOrder;
+};
+
+/// Everything found by one pass over the queries.
+struct BenchResult {
+	vector<unsigned int> counts;  ///< How many points each radius search found.
+	vector<unsigned int> hits;    ///< Every point found by the radius searches.
+	vector<int> nearest;          ///< The closest point for each query.
+	vector<Sprite*> nearby;       ///< Every Sprite found by the SpatialHash.
+	vector<Sprite*> closest;      ///< The closest Sprite for each query.
+	double kernelSeconds;
+	double hashSeconds;
+};
+
+static float RandomFloat( float range ) {
+	return range * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+}
+
+/**\brief Run every query at the current DistanceKernels level.
+ */
+static void RunQueries( const vector<float>& x, const vector<float>& y, const vector<float>& size, const vector<int>& type,
+	const vector<Coordinate>& queries, SpatialHash *hash, vector<BenchSprite*>& sprites, BenchResult *result ) {
+	const unsigned int count = x.size();
+	vector<unsigned int> hits( count );
+	unsigned int q, found;
+	clock_t start;
+
+	result->counts.clear();
+	result->hits.clear();
+	result->nearest.clear();
+	result->nearby.clear();
+	result->closest.clear();
+
+	// The raw kernels over the whole scene.
+	start = clock();
+	for( q = 0; q < queries.size(); ++q ) {
+		const float px = static_cast<float>( queries[q].GetX() );
+		const float py = static_cast<float>( queries[q].GetY() );
+		const int mask = (q % 2) ? DRAW_ORDER_SHIP : DRAW_ORDER_ALL;
+		float best = 1e12f;
+
+		found = DistanceKernels::WithinRadius( &x[0], &y[0], &size[0], &type[0], count, px, py, 1000.0f*1000.0f, mask, &hits[0] );
+		result->counts.push_back( found );
+		result->hits.insert( result->hits.end(), hits.begin(), hits.begin() + found );
+		result->nearest.push_back( DistanceKernels::Nearest( &x[0], &y[0], &type[0], count, px, py, mask, -1, &best ) );
+	}
+	result->kernelSeconds = static_cast<double>( clock() - start ) / CLOCKS_PER_SEC;
+
+	// The same searches through the SpatialHash, the way the game uses them.
+	start = clock();
+	for( q = 0; q < queries.size(); ++q ) {
+		const int mask = (q % 2) ? DRAW_ORDER_SHIP : DRAW_ORDER_ALL;
+		hash->GetSpritesNear( queries[q], 1000.0f, &result->nearby, mask );
+		result->closest.push_back( hash->GetNearestSprite( sprites[q], 3000.0f, mask ) );
+	}
+	result->hashSeconds = static_cast<double>( clock() - start ) / CLOCKS_PER_SEC;
+}
+
+/**\brief Check that every DistanceKernels level agrees with the scalar one, and time them.
+ */
+int test_distancekernels(int argc, char **argv){
+	vector<float> x, y, size;
+	vector<int> type;
+	vector<BenchSprite*> sprites;
+	list<Sprite*> all;
+	vector<Coordinate> queries;
+	SpatialHash hash( 500.0f );
+	BenchResult scalar, vectorized;
+	int failures = 0;
+	unsigned int i;
+
+	srand( 1 );
+	for( i = 0; i < BENCH_SPRITES; ++i ) {
+		const int drawOrder = (i % 3) ? DRAW_ORDER_SHIP : DRAW_ORDER_PROJECTILE;
+		BenchSprite *sprite = new BenchSprite( Coordinate( RandomFloat(BENCH_WORLD), RandomFloat(BENCH_WORLD) ), drawOrder );
+		sprites.push_back( sprite );
+		all.push_back( sprite );
+		x.push_back( static_cast<float>( sprite->GetWorldPosition().GetX() ) );
+		y.push_back( static_cast<float>( sprite->GetWorldPosition().GetY() ) );
+		size.push_back( static_cast<float>( sprite->GetRadarSize() ) );
+		type.push_back( drawOrder );
+	}
+	for( i = 0; i < BENCH_QUERIES; ++i ) {
+		queries.push_back( sprites[i]->GetWorldPosition() );
+	}
+	hash.Rebuild( &all );
+
+	DistanceKernels::SetLevel( KERNELS_SCALAR );
+	RunQueries( x, y, size, type, queries, &hash, sprites, &scalar );
+	cout << DistanceKernels::GetLevelName( KERNELS_SCALAR ) << ": "
+	     << scalar.kernelSeconds << "s raw, " << scalar.hashSeconds << "s hashed" << endl;
+
+	for( int level = KERNELS_SCALAR + 1; level <= DistanceKernels::GetSupportedLevel(); ++level ) {
+		DistanceKernels::SetLevel( level );
+		RunQueries( x, y, size, type, queries, &hash, sprites, &vectorized );
+		cout << DistanceKernels::GetLevelName( level ) << ": "
+		     << vectorized.kernelSeconds << "s raw, " << vectorized.hashSeconds << "s hashed";
+		if( vectorized.kernelSeconds > 0 ) {
+			cout << " (" << scalar.kernelSeconds / vectorized.kernelSeconds << "x raw)";
+		}
+		cout << endl;
+
+		if( vectorized.counts != scalar.counts || vectorized.hits != scalar.hits ) {
+			cout << "Failed: " << DistanceKernels::GetLevelName( level ) << " radius search disagrees with scalar." << endl;
+			failures++;
+		}
+		if( vectorized.nearest != scalar.nearest ) {
+			cout << "Failed: " << DistanceKernels::GetLevelName( level ) << " nearest search disagrees with scalar." << endl;
+			failures++;
+		}
+		if( vectorized.nearby != scalar.nearby || vectorized.closest != scalar.closest ) {
+			cout << "Failed: " << DistanceKernels::GetLevelName( level ) << " SpatialHash disagrees with scalar." << endl;
+			failures++;
+		}
+	}
+
+	DistanceKernels::SetLevel( DistanceKernels::GetSupportedLevel() );
+	for( i = 0; i < sprites.size(); ++i ) {
+		delete sprites[i];
+	}
+	return failures;
+}
@@ -0,0 +1,13 @@
+/**\file			distancekernels.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Compares and times the vectorized distance kernels
+ * \details
+ */
+
+
+#ifndef __H_TEST_DISTANCEKERNELS__
+#define __H_TEST_DISTANCEKERNELS__
+int test_distancekernels(int argc, char **argv);
+#endif // __H_TEST_DISTANCEKERNELS__
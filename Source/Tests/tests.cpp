@@ -15,6 +15,9 @@
 #include "Tests/argparser.h"
 #include "Tests/ui.h"
 #include "Tests/font.h"
+#include "Tests/distancekernels.h"
+#include "Tests/benchsim.h"
+#include "Tests/benchrotation.h"
 // Header files for various subsystems
 #include "Audio/audio.h"
 #include "Graphics/font.h"
@@ -46,6 +49,13 @@ Test::Test( const string& testname ):testname( testname ){
 		REQUIRE_VIDEO|REQUIRE_AUDIO|REQUIRE_OPTIONS|REQUIRE_FONTS);
 	tests["font"]=make_pair(test_font,
 		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["distance-kernels"]=make_pair(test_distancekernels,0);
+	tests["bench-sim"]=make_pair(test_bench_sim,0);
+	tests["bench-sim-1k"]=make_pair(test_bench_sim_1k,0);
+	tests["bench-sim-10k"]=make_pair(test_bench_sim_10k,0);
+	tests["bench-sim-100k"]=make_pair(test_bench_sim_100k,0);
+	tests["bench-rotation"]=make_pair(test_bench_rotation,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS);
 
 }
 
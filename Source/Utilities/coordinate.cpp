@@ -9,6 +9,7 @@
 #include "includes.h"
 #include "Engine/camera.h"
 #include "Utilities/coordinate.h"
+#include "Utilities/random.h"
 #include "Utilities/trig.h"
 
 /**\class Coordinate
@@ -157,7 +158,7 @@ Coordinate Coordinate::RotateTo( float newangle ) {
 
 float randf()
 {
-	return (float)rand()/(float)RAND_MAX;
+	return Random::Float();
 }
 
 float gaussian()
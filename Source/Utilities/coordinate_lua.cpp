@@ -0,0 +1,337 @@
+/**\file			coordinate_lua.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Lua bridge for Coordinates.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/coordinate_lua.h"
+#include "Utilities/lua.h"
+
+/**\class Coordinate_Lua
+ * \brief Lua bridge for Coordinates.
+ *
+ * Coordinates are full userdata holding a copy of the Coordinate, so vector
+ * math in the scripts is done natively rather than by packing numbers into
+ * Lua tables.  They act like values:
+ *
+ * \code
+ * local p = Coordinate.new(10,20)
+ * local q = (p - ship:GetCoordinate()) * 2
+ * print(q.x, q.y, q:magnitude(), q:angle())
+ * \endcode
+ *
+ * Angles follow Coordinate::GetAngle, where 0 is right and 90 is up.
+ */
+
+/**\brief Load all Coordinate related Lua functions
+ */
+void Coordinate_Lua::RegisterCoordinate(lua_State *L){
+	static const luaL_Reg coordinateFunctions[] = {
+		{"new", &Coordinate_Lua::New},
+		{"intercept", &Coordinate_Lua::GetIntercept},
+		{NULL, NULL}
+	};
+
+	static const luaL_Reg coordinateMethods[] = {
+		{"__index", &Coordinate_Lua::Index},
+		{"__add", &Coordinate_Lua::Add},
+		{"__sub", &Coordinate_Lua::Subtract},
+		{"__mul", &Coordinate_Lua::Multiply},
+		{"__div", &Coordinate_Lua::Divide},
+		{"__unm", &Coordinate_Lua::Negate},
+		{"__eq", &Coordinate_Lua::Equals},
+		{"__tostring", &Coordinate_Lua::ToString},
+		{"magnitude", &Coordinate_Lua::GetMagnitude},
+		{"angle", &Coordinate_Lua::GetAngle},
+		{"rotate", &Coordinate_Lua::Rotate},
+		{"distance", &Coordinate_Lua::GetDistance},
+		{"unpack", &Coordinate_Lua::Unpack},
+		{NULL, NULL}
+	};
+
+	luaL_newmetatable(L, EPIAR_COORDINATE);
+	luaL_openlib(L, NULL, coordinateMethods, 0);
+	luaL_openlib(L, EPIAR_COORDINATE, coordinateFunctions, 0);
+	lua_pop(L,2);
+}
+
+/**\brief Push a copy of a Coordinate onto the Lua stack.
+ */
+void Coordinate_Lua::pushCoordinate(lua_State *L, Coordinate c){
+	Coordinate* coord = (Coordinate*)lua_newuserdata(L, sizeof(Coordinate));
+	new (coord) Coordinate( c.GetX(), c.GetY() );
+	luaL_getmetatable(L, EPIAR_COORDINATE);
+	lua_setmetatable(L, -2);
+}
+
+/**\brief Validates Coordinate in Lua.
+ */
+Coordinate* Coordinate_Lua::checkCoordinate(lua_State *L, int index){
+	Coordinate* coord = (Coordinate*)luaL_checkudata(L, index, EPIAR_COORDINATE);
+	luaL_argcheck(L, coord != NULL, index, "`EPIAR_COORDINATE' expected");
+	return coord;
+}
+
+/**\brief Check for a Coordinate without raising an error.
+ */
+bool Coordinate_Lua::isCoordinate(lua_State *L, int index){
+	if( !lua_isuserdata(L, index) || !lua_getmetatable(L, index) ) {
+		return false;
+	}
+	luaL_getmetatable(L, EPIAR_COORDINATE);
+	bool same = (lua_rawequal(L, -1, -2) != 0);
+	lua_pop(L,2);
+	return same;
+}
+
+/**\brief Find where to aim so that a shot meets a moving target.
+ * \param shooterPosition,shooterVelocity Where the shot starts, and the
+ *        velocity that it inherits.
+ * \param targetPosition,targetVelocity The target, assumed not to turn.
+ * \param speed How fast the shot moves away from the shooter.
+ * \param aim [out] The point to aim at.
+ * \param time [out] How long until the shot meets the target.
+ * \returns False if the shot can never catch the target.
+ * \details Relative to the shooter, the target is at p moving at v, and the
+ *          shot can reach any point at distance speed*t after t.  They meet
+ *          when |p + v*t| = speed*t, which is a quadratic in t.
+ */
+bool Coordinate_Lua::Intercept( Coordinate shooterPosition, Coordinate shooterVelocity,
+	Coordinate targetPosition, Coordinate targetVelocity, float speed,
+	Coordinate *aim, float *time ) {
+	double px = targetPosition.GetX() - shooterPosition.GetX();
+	double py = targetPosition.GetY() - shooterPosition.GetY();
+	double vx = targetVelocity.GetX() - shooterVelocity.GetX();
+	double vy = targetVelocity.GetY() - shooterVelocity.GetY();
+
+	double a = vx*vx + vy*vy - speed*speed;
+	double b = 2 * (px*vx + py*vy);
+	double c = px*px + py*py;
+	double t;
+
+	if( c == 0 ) {
+		t = 0;
+	} else if( fabs(a) < 1e-9 ) {
+		// The shot is exactly as fast as the target, so it only catches up
+		// when the target is coming closer.
+		if( b >= 0 ) {
+			return false;
+		}
+		t = -c / b;
+	} else {
+		double discriminant = b*b - 4*a*c;
+		if( discriminant < 0 ) {
+			return false;
+		}
+		double root = sqrt( discriminant );
+		double t1 = (-b - root) / (2*a);
+		double t2 = (-b + root) / (2*a);
+		if( t1 > t2 ) {
+			swap( t1, t2 );
+		}
+		t = (t1 > 0) ? t1 : t2;
+		if( t <= 0 ) {
+			return false;
+		}
+	}
+
+	*aim = Coordinate( targetPosition.GetX() + vx*t, targetPosition.GetY() + vy*t );
+	*time = static_cast<float>(t);
+	return true;
+}
+
+/**\brief Create a new Coordinate
+ * \details Takes x and y, which default to 0.
+ */
+int Coordinate_Lua::New(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n == 0) {
+		pushCoordinate(L, Coordinate(0,0));
+	} else if (n == 2) {
+		double x = luaL_checknumber(L, 1);
+		double y = luaL_checknumber(L, 2);
+		pushCoordinate(L, Coordinate(x,y));
+	} else {
+		return luaL_error(L, "Got %d arguments expected 0 or 2 (x, y)", n);
+	}
+	return 1;
+}
+
+/**\brief Find where to aim a shot at a moving target.
+ * \details Takes the shooter's position and velocity, the target's position
+ *          and velocity, and the speed of the shot.  Returns the point to aim
+ *          at and how long the shot will take, or nil if it can never hit.
+ * \sa Coordinate_Lua::Intercept
+ */
+int Coordinate_Lua::GetIntercept(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 5) {
+		return luaL_error(L, "Got %d arguments expected 5 (position, velocity, targetPosition, targetVelocity, speed)", n);
+	}
+	Coordinate aim;
+	float time;
+	if( !Intercept( *checkCoordinate(L,1), *checkCoordinate(L,2),
+	                *checkCoordinate(L,3), *checkCoordinate(L,4),
+	                static_cast<float>( luaL_checknumber(L,5) ), &aim, &time ) ) {
+		lua_pushnil(L);
+		return 1;
+	}
+	pushCoordinate(L, aim);
+	lua_pushnumber(L, time);
+	return 2;
+}
+
+/**\brief Look up the x and y fields, or else a method.
+ */
+int Coordinate_Lua::Index(lua_State* L){
+	Coordinate* coord = checkCoordinate(L,1);
+	size_t len;
+	const char* key = lua_tolstring(L, 2, &len);
+	if( (key != NULL) && (len == 1) ) {
+		if( key[0] == 'x' ) {
+			lua_pushnumber(L, coord->GetX() );
+			return 1;
+		} else if( key[0] == 'y' ) {
+			lua_pushnumber(L, coord->GetY() );
+			return 1;
+		}
+	}
+	luaL_getmetatable(L, EPIAR_COORDINATE);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+	return 1;
+}
+
+/**\brief Add two Coordinates.
+ */
+int Coordinate_Lua::Add(lua_State* L){
+	Coordinate a = *checkCoordinate(L,1);
+	Coordinate b = *checkCoordinate(L,2);
+	pushCoordinate(L, a + b);
+	return 1;
+}
+
+/**\brief Subtract one Coordinate from another.
+ */
+int Coordinate_Lua::Subtract(lua_State* L){
+	Coordinate a = *checkCoordinate(L,1);
+	Coordinate b = *checkCoordinate(L,2);
+	pushCoordinate(L, a - b);
+	return 1;
+}
+
+/**\brief Scale a Coordinate by a number, on either side.
+ */
+int Coordinate_Lua::Multiply(lua_State* L){
+	if( lua_isnumber(L,1) ) {
+		double r = lua_tonumber(L,1);
+		Coordinate c = *checkCoordinate(L,2);
+		pushCoordinate(L, c * r);
+	} else {
+		Coordinate c = *checkCoordinate(L,1);
+		double r = luaL_checknumber(L,2);
+		pushCoordinate(L, c * r);
+	}
+	return 1;
+}
+
+/**\brief Divide a Coordinate by a number.
+ */
+int Coordinate_Lua::Divide(lua_State* L){
+	Coordinate c = *checkCoordinate(L,1);
+	double r = luaL_checknumber(L,2);
+	pushCoordinate(L, c / r);
+	return 1;
+}
+
+/**\brief Point a Coordinate the opposite way.
+ */
+int Coordinate_Lua::Negate(lua_State* L){
+	Coordinate* c = checkCoordinate(L,1);
+	pushCoordinate(L, Coordinate( -c->GetX(), -c->GetY() ));
+	return 1;
+}
+
+/**\brief Compare two Coordinates.
+ */
+int Coordinate_Lua::Equals(lua_State* L){
+	Coordinate* a = checkCoordinate(L,1);
+	Coordinate* b = checkCoordinate(L,2);
+	lua_pushboolean(L, (a->GetX() == b->GetX()) && (a->GetY() == b->GetY()) );
+	return 1;
+}
+
+/**\brief Describe a Coordinate as "(x,y)".
+ */
+int Coordinate_Lua::ToString(lua_State* L){
+	Coordinate* c = checkCoordinate(L,1);
+	lua_pushfstring(L, "(%f,%f)", c->GetX(), c->GetY() );
+	return 1;
+}
+
+/**\brief Get the length of a Coordinate.
+ * \sa Coordinate::GetMagnitude()
+ */
+int Coordinate_Lua::GetMagnitude(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 1) {
+		return luaL_error(L, "Got %d arguments expected 1 (self)", n);
+	}
+	lua_pushnumber(L, checkCoordinate(L,1)->GetMagnitude() );
+	return 1;
+}
+
+/**\brief Get the direction of a Coordinate.
+ * \sa Coordinate::GetAngle()
+ */
+int Coordinate_Lua::GetAngle(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 1) {
+		return luaL_error(L, "Got %d arguments expected 1 (self)", n);
+	}
+	lua_pushnumber(L, checkCoordinate(L,1)->GetAngle() );
+	return 1;
+}
+
+/**\brief Get a copy of a Coordinate turned by an angle.
+ * \sa Coordinate::RotateBy()
+ */
+int Coordinate_Lua::Rotate(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 2) {
+		return luaL_error(L, "Got %d arguments expected 2 (self, angle)", n);
+	}
+	Coordinate c = *checkCoordinate(L,1);
+	float angle = static_cast<float>( luaL_checknumber(L,2) );
+	pushCoordinate(L, c.RotateBy( angle ));
+	return 1;
+}
+
+/**\brief Get the distance between two Coordinates.
+ */
+int Coordinate_Lua::GetDistance(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 2) {
+		return luaL_error(L, "Got %d arguments expected 2 (self, other)", n);
+	}
+	Coordinate a = *checkCoordinate(L,1);
+	Coordinate b = *checkCoordinate(L,2);
+	lua_pushnumber(L, (a - b).GetMagnitude() );
+	return 1;
+}
+
+/**\brief Get the x and y of a Coordinate as two numbers.
+ */
+int Coordinate_Lua::Unpack(lua_State* L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 1) {
+		return luaL_error(L, "Got %d arguments expected 1 (self)", n);
+	}
+	Coordinate* c = checkCoordinate(L,1);
+	lua_pushnumber(L, c->GetX() );
+	lua_pushnumber(L, c->GetY() );
+	return 2;
+}
@@ -0,0 +1,58 @@
+/**\file			coordinate_lua.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Lua bridge for Coordinates.
+ * \details
+ */
+
+#ifndef __h_coordinate_lua__
+#define __h_coordinate_lua__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#	include <lua.h>
+#	include <lauxlib.h>
+#	include <lualib.h>
+#ifdef __cplusplus
+}
+#endif
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+
+#define EPIAR_COORDINATE "Coordinate"
+
+class Coordinate_Lua {
+	public:
+		static void RegisterCoordinate(lua_State *L);
+		static void pushCoordinate(lua_State *L, Coordinate c);
+		static Coordinate* checkCoordinate(lua_State *L, int index);
+		static bool isCoordinate(lua_State *L, int index);
+
+		static bool Intercept( Coordinate shooterPosition, Coordinate shooterVelocity,
+			Coordinate targetPosition, Coordinate targetVelocity, float speed,
+			Coordinate *aim, float *time );
+
+		// Functions
+		static int New(lua_State* L);
+		static int GetIntercept(lua_State* L);
+
+		// Methods
+		static int Index(lua_State* L);
+		static int Add(lua_State* L);
+		static int Subtract(lua_State* L);
+		static int Multiply(lua_State* L);
+		static int Divide(lua_State* L);
+		static int Negate(lua_State* L);
+		static int Equals(lua_State* L);
+		static int ToString(lua_State* L);
+		static int GetMagnitude(lua_State* L);
+		static int GetAngle(lua_State* L);
+		static int Rotate(lua_State* L);
+		static int GetDistance(lua_State* L);
+		static int Unpack(lua_State* L);
+};
+
+#endif // __h_coordinate_lua__
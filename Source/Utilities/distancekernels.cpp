@@ -0,0 +1,366 @@
+/**\file			distancekernels.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Vectorized distance tests over packed arrays of points.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/distancekernels.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+	#define KERNELS_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define TARGET_SSE2
+		#define TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		// Only these functions use the newer instructions, so the rest of the game still runs on older processors.
+		#define TARGET_SSE2 __attribute__((target("sse2")))
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+/**\class DistanceKernels
+ * \brief Distance tests that check several points per instruction.
+ * \details
+ * The spatial indexes keep their Sprites' positions, sizes and draw orders in
+ * packed arrays.  These kernels test 4 (SSE2) or 8 (AVX2) of those points at
+ * once against a search radius, or find the nearest one.
+ *
+ * The fastest version that the processor supports is picked the first time a
+ * kernel is called.  Every version does exactly the same float math in the
+ * same order, so they all find exactly the same points.
+ *
+ * \see SpatialHash
+ */
+
+// Scalar kernels
+
+static unsigned int WithinRadiusScalar( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+	float px, float py, float distSquared, int mask, unsigned int *hits ) {
+	unsigned int found = 0;
+	for( unsigned int i = 0; i < count; ++i ) {
+		if( (type[i] & mask) == 0 ) continue;
+		const float dx = px - x[i];
+		const float dy = py - y[i];
+		if( dx*dx + dy*dy < distSquared + size[i]*size[i] ) {
+			hits[found++] = i;
+		}
+	}
+	return found;
+}
+
+static int NearestScalar( const float *x, const float *y, const int *type, unsigned int count,
+	float px, float py, int mask, int skip, float *bestSquared ) {
+	int best = -1;
+	float bestDist = *bestSquared;
+	for( unsigned int i = 0; i < count; ++i ) {
+		if( ((type[i] & mask) == 0) || (static_cast<int>(i) == skip) ) continue;
+		const float dx = px - x[i];
+		const float dy = py - y[i];
+		const float d = dx*dx + dy*dy;
+		if( d < bestDist ) {
+			bestDist = d;
+			best = i;
+		}
+	}
+	*bestSquared = bestDist;
+	return best;
+}
+
+#ifdef KERNELS_X86
+
+// SSE2 kernels
+
+TARGET_SSE2 static unsigned int WithinRadiusSSE2( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+	float px, float py, float distSquared, int mask, unsigned int *hits ) {
+	const __m128 vpx = _mm_set1_ps( px );
+	const __m128 vpy = _mm_set1_ps( py );
+	const __m128 vdist = _mm_set1_ps( distSquared );
+	const __m128i vmask = _mm_set1_epi32( mask );
+	const __m128i zero = _mm_setzero_si128();
+	unsigned int found = 0;
+	unsigned int i = 0;
+
+	for( ; i + 4 <= count; i += 4 ) {
+		const __m128 dx = _mm_sub_ps( vpx, _mm_loadu_ps(x + i) );
+		const __m128 dy = _mm_sub_ps( vpy, _mm_loadu_ps(y + i) );
+		const __m128 s = _mm_loadu_ps( size + i );
+		const __m128 d = _mm_add_ps( _mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy) );
+		const __m128 inside = _mm_cmplt_ps( d, _mm_add_ps(vdist, _mm_mul_ps(s, s)) );
+		const __m128i wrongType = _mm_cmpeq_epi32( _mm_and_si128(_mm_loadu_si128((const __m128i*)(type + i)), vmask), zero );
+		int bits = _mm_movemask_ps( _mm_andnot_ps(_mm_castsi128_ps(wrongType), inside) );
+		for( unsigned int lane = i; bits != 0; bits >>= 1, ++lane ) {
+			if( bits & 1 ) hits[found++] = lane;
+		}
+	}
+
+	// The scalar kernel finishes the last few points.
+	const unsigned int tail = found;
+	found += WithinRadiusScalar( x + i, y + i, size + i, type + i, count - i, px, py, distSquared, mask, hits + found );
+	for( unsigned int h = tail; h < found; ++h ) {
+		hits[h] += i;
+	}
+	return found;
+}
+
+TARGET_SSE2 static int NearestSSE2( const float *x, const float *y, const int *type, unsigned int count,
+	float px, float py, int mask, int skip, float *bestSquared ) {
+	const __m128 vpx = _mm_set1_ps( px );
+	const __m128 vpy = _mm_set1_ps( py );
+	const __m128i vmask = _mm_set1_epi32( mask );
+	const __m128i vskip = _mm_set1_epi32( skip );
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i four = _mm_set1_epi32( 4 );
+	__m128 bestDist = _mm_set1_ps( *bestSquared );
+	__m128i bestIndex = _mm_set1_epi32( -1 );
+	__m128i index = _mm_set_epi32( 3, 2, 1, 0 );
+	unsigned int i = 0;
+
+	// Each lane keeps the closest point that it has seen.
+	for( ; i + 4 <= count; i += 4 ) {
+		const __m128 dx = _mm_sub_ps( vpx, _mm_loadu_ps(x + i) );
+		const __m128 dy = _mm_sub_ps( vpy, _mm_loadu_ps(y + i) );
+		const __m128 d = _mm_add_ps( _mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy) );
+		const __m128i wrongType = _mm_cmpeq_epi32( _mm_and_si128(_mm_loadu_si128((const __m128i*)(type + i)), vmask), zero );
+		const __m128i ignored = _mm_or_si128( wrongType, _mm_cmpeq_epi32(index, vskip) );
+		const __m128 closer = _mm_andnot_ps( _mm_castsi128_ps(ignored), _mm_cmplt_ps(d, bestDist) );
+		bestDist = _mm_or_ps( _mm_and_ps(closer, d), _mm_andnot_ps(closer, bestDist) );
+		bestIndex = _mm_or_si128( _mm_and_si128(_mm_castps_si128(closer), index), _mm_andnot_si128(_mm_castps_si128(closer), bestIndex) );
+		index = _mm_add_epi32( index, four );
+	}
+
+	// Then the lanes are combined, preferring the lowest index on ties.
+	float dists[4];
+	int indices[4];
+	_mm_storeu_ps( dists, bestDist );
+	_mm_storeu_si128( (__m128i*)indices, bestIndex );
+	int best = -1;
+	float bestD = *bestSquared;
+	for( int lane = 0; lane < 4; ++lane ) {
+		if( indices[lane] < 0 ) continue;
+		if( dists[lane] < bestD || (dists[lane] == bestD && indices[lane] < best) ) {
+			bestD = dists[lane];
+			best = indices[lane];
+		}
+	}
+
+	int tail = NearestScalar( x + i, y + i, type + i, count - i, px, py, mask, skip - static_cast<int>(i), &bestD );
+	if( tail >= 0 ) {
+		best = tail + i;
+	}
+	*bestSquared = bestD;
+	return best;
+}
+
+// AVX2 kernels
+
+TARGET_AVX2 static unsigned int WithinRadiusAVX2( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+	float px, float py, float distSquared, int mask, unsigned int *hits ) {
+	const __m256 vpx = _mm256_set1_ps( px );
+	const __m256 vpy = _mm256_set1_ps( py );
+	const __m256 vdist = _mm256_set1_ps( distSquared );
+	const __m256i vmask = _mm256_set1_epi32( mask );
+	const __m256i zero = _mm256_setzero_si256();
+	unsigned int found = 0;
+	unsigned int i = 0;
+
+	for( ; i + 8 <= count; i += 8 ) {
+		const __m256 dx = _mm256_sub_ps( vpx, _mm256_loadu_ps(x + i) );
+		const __m256 dy = _mm256_sub_ps( vpy, _mm256_loadu_ps(y + i) );
+		const __m256 s = _mm256_loadu_ps( size + i );
+		const __m256 d = _mm256_add_ps( _mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy) );
+		const __m256 inside = _mm256_cmp_ps( d, _mm256_add_ps(vdist, _mm256_mul_ps(s, s)), _CMP_LT_OQ );
+		const __m256i wrongType = _mm256_cmpeq_epi32( _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(type + i)), vmask), zero );
+		int bits = _mm256_movemask_ps( _mm256_andnot_ps(_mm256_castsi256_ps(wrongType), inside) );
+		for( unsigned int lane = i; bits != 0; bits >>= 1, ++lane ) {
+			if( bits & 1 ) hits[found++] = lane;
+		}
+	}
+
+	// The scalar kernel finishes the last few points.
+	const unsigned int tail = found;
+	found += WithinRadiusScalar( x + i, y + i, size + i, type + i, count - i, px, py, distSquared, mask, hits + found );
+	for( unsigned int h = tail; h < found; ++h ) {
+		hits[h] += i;
+	}
+	return found;
+}
+
+TARGET_AVX2 static int NearestAVX2( const float *x, const float *y, const int *type, unsigned int count,
+	float px, float py, int mask, int skip, float *bestSquared ) {
+	const __m256 vpx = _mm256_set1_ps( px );
+	const __m256 vpy = _mm256_set1_ps( py );
+	const __m256i vmask = _mm256_set1_epi32( mask );
+	const __m256i vskip = _mm256_set1_epi32( skip );
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i eight = _mm256_set1_epi32( 8 );
+	__m256 bestDist = _mm256_set1_ps( *bestSquared );
+	__m256i bestIndex = _mm256_set1_epi32( -1 );
+	__m256i index = _mm256_set_epi32( 7, 6, 5, 4, 3, 2, 1, 0 );
+	unsigned int i = 0;
+
+	for( ; i + 8 <= count; i += 8 ) {
+		const __m256 dx = _mm256_sub_ps( vpx, _mm256_loadu_ps(x + i) );
+		const __m256 dy = _mm256_sub_ps( vpy, _mm256_loadu_ps(y + i) );
+		const __m256 d = _mm256_add_ps( _mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy) );
+		const __m256i wrongType = _mm256_cmpeq_epi32( _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(type + i)), vmask), zero );
+		const __m256i ignored = _mm256_or_si256( wrongType, _mm256_cmpeq_epi32(index, vskip) );
+		const __m256 closer = _mm256_andnot_ps( _mm256_castsi256_ps(ignored), _mm256_cmp_ps(d, bestDist, _CMP_LT_OQ) );
+		bestDist = _mm256_blendv_ps( bestDist, d, closer );
+		bestIndex = _mm256_castps_si256( _mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), closer) );
+		index = _mm256_add_epi32( index, eight );
+	}
+
+	float dists[8];
+	int indices[8];
+	_mm256_storeu_ps( dists, bestDist );
+	_mm256_storeu_si256( (__m256i*)indices, bestIndex );
+	int best = -1;
+	float bestD = *bestSquared;
+	for( int lane = 0; lane < 8; ++lane ) {
+		if( indices[lane] < 0 ) continue;
+		if( dists[lane] < bestD || (dists[lane] == bestD && indices[lane] < best) ) {
+			bestD = dists[lane];
+			best = indices[lane];
+		}
+	}
+
+	int tail = NearestScalar( x + i, y + i, type + i, count - i, px, py, mask, skip - static_cast<int>(i), &bestD );
+	if( tail >= 0 ) {
+		best = tail + i;
+	}
+	*bestSquared = bestD;
+	return best;
+}
+
+#endif // KERNELS_X86
+
+// Selection
+
+/**\brief Ask the processor which instruction sets it supports.
+ */
+static int DetectLevel() {
+#ifdef KERNELS_X86
+	unsigned int a = 0, b = 0, c = 0, d = 0;
+	unsigned int maxLeaf;
+	bool sse2, avx, avx2 = false;
+
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid( info, 0 );
+	maxLeaf = info[0];
+	__cpuid( info, 1 );
+	c = info[2];
+	d = info[3];
+#else
+	maxLeaf = __get_cpuid_max( 0, NULL );
+	if( maxLeaf < 1 ) {
+		return KERNELS_SCALAR;
+	}
+	__cpuid( 1, a, b, c, d );
+#endif
+	sse2 = (d & (1u << 26)) != 0;
+
+	// AVX also needs the operating system to save the wider registers.
+	avx = (c & (1u << 27)) && (c & (1u << 28));
+	if( avx ) {
+#ifdef _MSC_VER
+		unsigned long long xcr0 = _xgetbv( 0 );
+#else
+		unsigned int xcrLow, xcrHigh;
+		__asm__ __volatile__ ( "xgetbv" : "=a"(xcrLow), "=d"(xcrHigh) : "c"(0) );
+		unsigned long long xcr0 = xcrLow;
+#endif
+		avx = (xcr0 & 6) == 6;
+	}
+	if( avx && maxLeaf >= 7 ) {
+#ifdef _MSC_VER
+		__cpuidex( info, 7, 0 );
+		b = info[1];
+#else
+		__cpuid_count( 7, 0, a, b, c, d );
+#endif
+		avx2 = (b & (1u << 5)) != 0;
+	}
+
+	if( avx2 ) return KERNELS_AVX2;
+	if( sse2 ) return KERNELS_SSE2;
+#endif // KERNELS_X86
+	return KERNELS_SCALAR;
+}
+
+// Until a level is picked, these pick the best level and then forward the call.
+static unsigned int WithinRadiusFirst( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+	float px, float py, float distSquared, int mask, unsigned int *hits ) {
+	DistanceKernels::SetLevel( DistanceKernels::GetSupportedLevel() );
+	return DistanceKernels::WithinRadius( x, y, size, type, count, px, py, distSquared, mask, hits );
+}
+
+static int NearestFirst( const float *x, const float *y, const int *type, unsigned int count,
+	float px, float py, int mask, int skip, float *bestSquared ) {
+	DistanceKernels::SetLevel( DistanceKernels::GetSupportedLevel() );
+	return DistanceKernels::Nearest( x, y, type, count, px, py, mask, skip, bestSquared );
+}
+
+DistanceKernels::WithinRadiusFunc DistanceKernels::withinRadius = WithinRadiusFirst;
+DistanceKernels::NearestFunc DistanceKernels::nearest = NearestFirst;
+int DistanceKernels::level = -1;
+
+/**\brief The level that the kernels are using.
+ */
+int DistanceKernels::GetLevel() {
+	if( level < 0 ) {
+		SetLevel( GetSupportedLevel() );
+	}
+	return level;
+}
+
+/**\brief Choose which kernels to use.
+ * \details Levels that this processor doesn't support are lowered to the best one that it does.
+ *          This is mostly useful for comparing the kernels.
+ */
+void DistanceKernels::SetLevel( int _level ) {
+	level = min( _level, GetSupportedLevel() );
+	switch( level ) {
+#ifdef KERNELS_X86
+		case KERNELS_AVX2:
+			withinRadius = WithinRadiusAVX2;
+			nearest = NearestAVX2;
+			break;
+		case KERNELS_SSE2:
+			withinRadius = WithinRadiusSSE2;
+			nearest = NearestSSE2;
+			break;
+#endif
+		default:
+			level = KERNELS_SCALAR;
+			withinRadius = WithinRadiusScalar;
+			nearest = NearestScalar;
+			break;
+	}
+}
+
+/**\brief The fastest level that this processor supports.
+ */
+int DistanceKernels::GetSupportedLevel() {
+	static int supported = -1;
+	if( supported < 0 ) {
+		supported = DetectLevel();
+	}
+	return supported;
+}
+
+/**\brief A readable name for a level.
+ */
+const char* DistanceKernels::GetLevelName( int _level ) {
+	switch( _level ) {
+		case KERNELS_AVX2: return "AVX2";
+		case KERNELS_SSE2: return "SSE2";
+		default: return "Scalar";
+	}
+}
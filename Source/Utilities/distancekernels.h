@@ -0,0 +1,72 @@
+/**\file			distancekernels.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Vectorized distance tests over packed arrays of points.
+ * \details
+ */
+
+#ifndef __h_distancekernels__
+#define __h_distancekernels__
+
+#include "includes.h"
+
+// Instruction sets that the kernels can use, from slowest to fastest.
+#define KERNELS_SCALAR 0
+#define KERNELS_SSE2   1
+#define KERNELS_AVX2   2
+
+class DistanceKernels {
+	public:
+		static unsigned int WithinRadius( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+			float px, float py, float distSquared, int mask, unsigned int *hits );
+		static int Nearest( const float *x, const float *y, const int *type, unsigned int count,
+			float px, float py, int mask, int skip, float *bestSquared );
+
+		static int GetLevel();
+		static void SetLevel( int level );
+		static int GetSupportedLevel();
+		static const char* GetLevelName( int level );
+
+	private:
+		typedef unsigned int (*WithinRadiusFunc)( const float*, const float*, const float*, const int*, unsigned int,
+			float, float, float, int, unsigned int* );
+		typedef int (*NearestFunc)( const float*, const float*, const int*, unsigned int,
+			float, float, int, int, float* );
+
+		static WithinRadiusFunc withinRadius;
+		static NearestFunc nearest;
+		static int level;
+};
+
+/**\brief Find the points that are within a radius.
+ * \param x,y,size,type Packed arrays describing count points.
+ * \param px,py The center of the search.
+ * \param distSquared The square of the search radius.
+ * \param mask Only points whose type shares a bit with the mask are found.
+ * \param hits [out] The index of every point found, in order.  Must have room for count indices.
+ * \returns The number of points found.
+ * \details A point is found when its distance squared from the center is less
+ *          than distSquared plus its size squared.
+ */
+inline unsigned int DistanceKernels::WithinRadius( const float *x, const float *y, const float *size, const int *type, unsigned int count,
+	float px, float py, float distSquared, int mask, unsigned int *hits ) {
+	return withinRadius( x, y, size, type, count, px, py, distSquared, mask, hits );
+}
+
+/**\brief Find the closest point to a center.
+ * \param x,y,type Packed arrays describing count points.
+ * \param px,py The center of the search.
+ * \param mask Only points whose type shares a bit with the mask are considered.
+ * \param skip The index of a point to ignore, or -1.
+ * \param bestSquared [in,out] Only points closer than this are considered.
+ *                    It is lowered to the distance squared of the point found.
+ * \returns The index of the closest point, or -1 if none are closer than bestSquared.
+ *          When points tie, the one with the lowest index is returned.
+ */
+inline int DistanceKernels::Nearest( const float *x, const float *y, const int *type, unsigned int count,
+	float px, float py, int mask, int skip, float *bestSquared ) {
+	return nearest( x, y, type, count, px, py, mask, skip, bestSquared );
+}
+
+#endif // __h_distancekernels__
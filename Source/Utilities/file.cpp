@@ -169,6 +169,43 @@ char *File::Read( void ){
 	}
 }
 
+/**Reads the whole file into a buffer without using the Log, so that it is
+ * safe on a loader thread.  Free the buffer with "delete [] buffer".
+ * \param error Set to the reason the file could not be read.
+ * \return Pointer to buffer, NULL otherwise.*/
+char *File::Read( string *error ){
+	if ( fp == NULL ){
+		*error = validName + ": File is not open.";
+		return NULL;
+	}
+
+	// Seek to beginning
+#ifdef USE_PHYSICSFS
+	if ( PHYSFS_seek( fp, 0 ) == 0 )
+#else
+	if ( fseek( fp, 0, SEEK_SET ) != 0 )
+#endif
+	{
+		*error = validName + ": Error using file seek [0]. " + LastErrorMessage();
+		return NULL;
+	}
+
+	char *fBuffer = new char[static_cast<Uint32>(contentSize)];
+	long bytesRead = static_cast<long>(
+#ifdef USE_PHYSICSFS
+		PHYSFS_read( this->fp, fBuffer, 1, contentSize )
+#else
+		fread(fBuffer,1,contentSize,fp)
+#endif
+		);
+	if( bytesRead != contentSize){
+		delete [] fBuffer;
+		*error = validName + ": Unable to read file into memory. " + LastErrorMessage();
+		return NULL;
+	}
+	return fBuffer;
+}
+
 /**Writes buffer to file.
  * \param buffer The buffer to write
  * \param bufsize The size of the buffer in bytes
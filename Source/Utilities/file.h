@@ -29,6 +29,7 @@ class File {
 		bool OpenRead( const string& filename );
 		bool OpenWrite( const string& filename );
 		char *Read( void );
+		char *Read( string *error );
 		bool Write( char *buffer, const long bufsize );
 		long Tell( void );
 		bool Seek( long pos );
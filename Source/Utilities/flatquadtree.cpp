@@ -0,0 +1,672 @@
+/**\file			flatquadtree.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A QuadTree that keeps all of its nodes in one pooled array.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/log.h"
+#include "Utilities/flatquadtree.h"
+#include "Graphics/video.h"
+
+/**\class FlatQuadTree
+ * \brief A QuadTree whose nodes live in a single pooled array.
+ *
+ * This behaves exactly like the recursive QuadTree: Leaves split once they
+ * hold more than QUADMAXOBJECTS Sprites and Nodes merge once they hold
+ * QUADMAXOBJECTS or fewer.  The difference is in how the memory is laid out.
+ *
+ *  - Every Leaf and Node is an element of one vector.  Subtrees refer to each
+ *    other by index.  When a subtree is removed its slot is put on a free
+ *    list and reused by the next split, so a busy tree stops allocating once
+ *    it has warmed up.
+ *  - Each Leaf stores its Sprites in a small vector of Entries.  An Entry
+ *    caches the Sprite's position, radar size and draw order next to the
+ *    Sprite pointer, so the searches never call into the Sprite itself.
+ *  - All searches walk the tree with a reusable explicit stack and append
+ *    their results to a caller supplied vector.
+ *
+ * The cached positions are refreshed whenever the tree is Updated.
+ *
+ * Every Sprite also remembers which Leaf and slot holds it (see QuadrantHome).
+ * When a Sprite moves outside of that Leaf it tells the tree, so
+ * FixOutOfBounds only touches the Sprites that crossed a boundary rather than
+ * sweeping every Leaf.
+ *
+ * \see QuadTree
+ * \see Quadrant
+ */
+
+/** \brief Constructor
+ * The root node is always the first element of the pool.
+ */
+FlatQuadTree::FlatQuadTree(Coordinate _center, float _radius)
+	:Quadrant(_center, _radius)
+{
+	assert(_radius>MIN_QUAD_SIZE/2);
+	nodes.reserve(16);
+	AllocateNode( static_cast<float>(center.GetX()), static_cast<float>(center.GetY()), radius, FLATQUAD_NONE );
+}
+
+/** \brief Destructor
+ */
+FlatQuadTree::~FlatQuadTree(){
+	nodes.clear();
+	freeNodes.clear();
+}
+
+/** \brief The number of Sprites within this QuadTree.
+ */
+unsigned int FlatQuadTree::Count(){
+	return nodes[0].count;
+}
+
+/** \brief Add a Sprite to this Tree
+ */
+void FlatQuadTree::Insert(Sprite *obj){
+	Entry entry;
+	entry.sprite = obj;
+	entry.drawOrder = obj->GetDrawOrder();
+	RefreshEntry( entry );
+	InsertEntry( 0, entry );
+}
+
+/** \brief Remove a Sprite from this Tree
+ *
+ * The Sprite's QuadrantHome says exactly where it is stored.  If that doesn't
+ * match (the Sprite belongs to another tree), every Leaf is searched.
+ *
+ * \returns TRUE if the Sprite is found and successfully removed.
+ */
+bool FlatQuadTree::Delete(Sprite* obj){
+	int leaf = FLATQUAD_NONE;
+	unsigned int slot = 0;
+	if(0 == this->Count())
+		return( false ); // No objects to delete.
+
+	QuadrantHome* home = obj->GetHome();
+	if( IsHome( obj ) ) {
+		leaf = home->leaf;
+		slot = home->slot;
+	} else {
+		for( unsigned int n = 0; (leaf == FLATQUAD_NONE) && (n < nodes.size()); ++n ) {
+			vector<Entry>& entries = nodes[n].entries;
+			for( slot = 0; slot < entries.size(); ++slot ) {
+				if( entries[slot].sprite == obj ) {
+					leaf = n;
+					break;
+				}
+			}
+		}
+		if( leaf == FLATQUAD_NONE ) {
+			return( false );
+		}
+	}
+
+	RemoveEntry( leaf, slot );
+	if( home->moved ) {
+		vector<Sprite*>::iterator i = find( moved.begin(), moved.end(), obj );
+		if( i != moved.end() ) moved.erase( i );
+	}
+	home->quadrant = NULL;
+	home->moved = false;
+	return( true );
+}
+
+/** \brief Get all Sprites in this QuadTree
+ *
+ * Only Leaves hold entries, so this is a linear scan of the pool.
+ *
+ * \arg sprites [out] The vector that the Sprites are appended to.
+ */
+void FlatQuadTree::GetSprites(vector<Sprite*> *sprites) {
+	for( unsigned int n = 0; n < nodes.size(); ++n ) {
+		vector<Entry>& entries = nodes[n].entries;
+		for( unsigned int slot = 0; slot < entries.size(); ++slot ) {
+			sprites->push_back( entries[slot].sprite );
+		}
+	}
+}
+
+/** \brief Get all Sprites within a certain radius.
+ *
+ * \arg point The center of the search radius.
+ * \arg distance The maximum search radius.
+ * \arg nearby [out] All Sprites found within the search radius are appended here.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \arg limit If not zero, the search stops once this many Sprites are found.
+ */
+void FlatQuadTree::GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type, unsigned int limit){
+	const float px = static_cast<float>(point.GetX());
+	const float py = static_cast<float>(point.GetY());
+	const float distSquared = distance*distance;
+	const unsigned int full = nearby->size() + limit;
+
+	stack.clear();
+	stack.push_back(0);
+	while( !stack.empty() ) {
+		int n = stack.back();
+		stack.pop_back();
+		if( !NodePossiblyNear(n, px, py, distance) ) {
+			continue;
+		}
+
+		const Node& node = nodes[n];
+		if( !node.isLeaf ) { // Node
+			for(int t=0;t<4;t++){
+				if( node.children[t] != FLATQUAD_NONE ){
+					stack.push_back( node.children[t] );
+				}
+			}
+		} else { // Leaf
+			const Entry* e = node.entries.empty() ? NULL : &node.entries[0];
+			const Entry* end = e + node.entries.size();
+			for( ; e != end; ++e ) {
+				if( (e->drawOrder & type) == 0 ) continue;
+				const float dx = px - e->x;
+				const float dy = py - e->y;
+				if( dx*dx + dy*dy < distSquared + e->size*e->size ) {
+					nearby->push_back( e->sprite );
+					if( limit && nearby->size() >= full ) return;
+				}
+			}
+		}
+	}
+}
+
+/**\brief Find the Sprite that is closest to a known point.
+ *
+ * \arg obj The Sprite at the center of the search radius.  This Sprite is ignored while searching.
+ * \arg distance A Max radius to use while searching.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ *
+ * \returns A pointer to the Sprite nearest the obj Sprite, within a certain distance, and of the correct type.
+ */
+Sprite* FlatQuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
+	Coordinate point = obj->GetWorldPosition();
+	const float px = static_cast<float>(point.GetX());
+	const float py = static_cast<float>(point.GetY());
+	Sprite* closest = NULL;
+	float mindist = distance;
+	float mindistSquared = distance*distance;
+
+	stack.clear();
+	stack.push_back(0);
+	while( !stack.empty() ) {
+		int n = stack.back();
+		stack.pop_back();
+		// The search radius shrinks as closer Sprites are found.
+		if( !NodePossiblyNear(n, px, py, mindist) ) {
+			continue;
+		}
+
+		const Node& node = nodes[n];
+		if( !node.isLeaf ) { // Node
+			for(int t=0;t<4;t++){
+				if( node.children[t] != FLATQUAD_NONE ){
+					stack.push_back( node.children[t] );
+				}
+			}
+		} else { // Leaf
+			const Entry* e = node.entries.empty() ? NULL : &node.entries[0];
+			const Entry* end = e + node.entries.size();
+			for( ; e != end; ++e ) {
+				if( (e->sprite == obj) || ((e->drawOrder & type) == 0) ) continue;
+				const float dx = px - e->x;
+				const float dy = py - e->y;
+				const float tmpdist = dx*dx + dy*dy;
+				if( tmpdist < mindistSquared ) {
+					mindistSquared = tmpdist;
+					closest = e->sprite;
+				}
+			}
+			mindist = sqrtf( mindistSquared );
+		}
+	}
+	return closest;
+}
+
+/** \brief  Move the Sprites that have left their Leaves.
+ *
+ * Only the Sprites that reported a move since the last call are checked.
+ * Sprites that are still inside of this QuadTree are moved to the correct
+ * Leaf.  Sprites that are outside of this QuadTree are removed and forgotten.
+ *
+ * \arg outofbounds [out] Sprites that are outside of this QuadTree are appended here.
+ * \returns The number of Sprites that changed Leaves or left this QuadTree.
+ */
+unsigned int FlatQuadTree::FixOutOfBounds(vector<Sprite*> *outofbounds){
+	unsigned int relocated = 0;
+	for( unsigned int i = 0; i < moved.size(); ++i ) {
+		QuadrantHome* home = moved[i]->GetHome();
+		if( !IsHome( moved[i] ) ) {
+			continue; // Not one of ours (a copy of one of our Sprites).
+		}
+		home->moved = false;
+
+		Entry entry = nodes[home->leaf].entries[home->slot];
+		RefreshEntry( entry );
+		if( NodeContains(home->leaf, entry.x, entry.y) ) {
+			// It came back before we got to it.
+			nodes[home->leaf].entries[home->slot] = entry;
+			continue;
+		}
+
+		RemoveEntry( home->leaf, home->slot );
+		relocated++;
+		if( this->Contains( entry.sprite->GetWorldPosition() ) ) {
+			InsertEntry( 0, entry );
+		} else {
+			home->quadrant = NULL;
+			outofbounds->push_back( entry.sprite );
+		}
+	}
+	moved.clear();
+	return relocated;
+}
+
+/** \brief Remember that a Sprite has left its Leaf
+ * \details The Sprite is moved during the next FixOutOfBounds.
+ */
+void FlatQuadTree::Moved(Sprite* obj){
+	moved.push_back( obj );
+}
+
+/** \brief Move all Sprites in this QuadTree
+ *
+ * The SpriteManager buffers every Add and Delete while the physics Jobs are
+ * running, so the entries can be walked directly.
+ */
+void FlatQuadTree::UpdatePhysics(){
+	const unsigned int numNodes = nodes.size();
+	for( unsigned int n = 0; n < numNodes; ++n ) {
+		vector<Entry>& entries = nodes[n].entries;
+		for( unsigned int slot = 0; slot < entries.size(); ++slot ) {
+			entries[slot].sprite->UpdatePhysics();
+			RefreshEntry( entries[slot] );
+		}
+	}
+}
+
+/** \brief Run the game logic for all Sprites in this QuadTree
+ *
+ * Entries are only appended while Sprites are updating (removals are always
+ * deferred by the SpriteManager), so the pool indices stay valid even if a
+ * Sprite adds new Sprites to this tree.
+ */
+void FlatQuadTree::Update( lua_State *L ){
+	const unsigned int numNodes = nodes.size();
+	for( unsigned int n = 0; n < numNodes; ++n ) {
+		const unsigned int numEntries = nodes[n].entries.size();
+		for( unsigned int slot = 0; slot < numEntries; ++slot ) {
+			nodes[n].entries[slot].sprite->Update( L );
+			// Re-index since the update may have grown the pool.
+			RefreshEntry( nodes[n].entries[slot] );
+		}
+	}
+}
+
+/**  Draw the QuadTree
+ *
+ * /arg root The center coordinate for the root of this QuadTree.
+ *
+ * (Useful for debugging.)
+ */
+void FlatQuadTree::Draw(Coordinate root){
+	// The QuadTree is scaled so that it always fits on the screen.
+	float scale = (Video::GetHalfHeight() > Video::GetHalfWidth() ?
+		static_cast<float>(Video::GetHalfWidth()) : static_cast<float>(Video::GetHalfHeight()) -5);
+	DrawNode( 0, root, scale );
+}
+
+/** \brief Ballance the QuadTree by splitting and merging subtrees
+ *
+ * \see QuadTree::ReBallance
+ */
+void FlatQuadTree::ReBallance(){
+	unsigned int numObjects = this->Count();
+	ReBallanceNode( 0 );
+	assert(numObjects == this->Count()); // ReBallancing should never change the total number of elements
+}
+
+/** \brief Generate an XML Node of this QuadTree.
+ *
+ * (Useful for debugging.)
+ *
+ * \returns xmlNodePtr of this QuadTree
+ */
+xmlNodePtr FlatQuadTree::ToNode() {
+	return NodeToXML( 0 );
+}
+
+/** \brief Take a node from the pool
+ * \note This may grow the pool, so references into it should not be held across this call.
+ * \returns The index of the new Leaf.
+ */
+int FlatQuadTree::AllocateNode(float x, float y, float radius, int parent){
+	int n;
+	if( !freeNodes.empty() ) {
+		n = freeNodes.back();
+		freeNodes.pop_back();
+	} else {
+		nodes.push_back( Node() );
+		n = nodes.size() - 1;
+	}
+
+	Node& node = nodes[n];
+	node.x = x;
+	node.y = y;
+	node.radius = radius;
+	node.parent = parent;
+	for(int t=0;t<4;t++){
+		node.children[t] = FLATQUAD_NONE;
+	}
+	node.count = 0;
+	node.isLeaf = true;
+	node.isDirty = false;
+	node.entries.clear();
+	return n;
+}
+
+/** \brief Return a node and all of its subtrees to the pool
+ * \note The entry vectors are cleared but keep their capacity.
+ */
+void FlatQuadTree::FreeNode(int n){
+	for(int t=0;t<4;t++){
+		if( nodes[n].children[t] != FLATQUAD_NONE ){
+			FreeNode( nodes[n].children[t] );
+			nodes[n].children[t] = FLATQUAD_NONE;
+		}
+	}
+	nodes[n].entries.clear();
+	nodes[n].count = 0;
+	freeNodes.push_back( n );
+}
+
+/** \brief Get the subtree of a Node that would contain a point
+ *  If that subtree doesn't exist, this creates it.
+ * \returns The index of the subtree.
+ */
+int FlatQuadTree::ChildThatContains(int n, float x, float y){
+	bool rightOfCenter = x > nodes[n].x;
+	bool aboveCenter = y > nodes[n].y;
+	int pos =  (aboveCenter?0:2) | (rightOfCenter?1:0);
+
+	if( nodes[n].children[pos] == FLATQUAD_NONE ) {
+		// Each subtree has a specific new center (See QuadTree::CreateSubTree)
+		float half = nodes[n].radius/2;
+		float cx = nodes[n].x + (rightOfCenter ? half : -half);
+		float cy = nodes[n].y + (aboveCenter ? half : -half);
+		int child = AllocateNode( cx, cy, half, n );
+		nodes[n].children[pos] = child;
+	}
+	return nodes[n].children[pos];
+}
+
+/** \brief Draw a node and its subtrees
+ * \see QuadTree::Draw
+ */
+void FlatQuadTree::DrawNode(int n, Coordinate root, float scale){
+	Coordinate nodeCenter( nodes[n].x, nodes[n].y );
+	float r = scale* nodes[n].radius / QUADRANTSIZE;
+	float x = (scale* static_cast<float>((nodeCenter-root).GetX()) / QUADRANTSIZE)
+		+ static_cast<float>(Video::GetHalfWidth())  -r;
+	float y = (scale* static_cast<float>((nodeCenter-root).GetY()) / QUADRANTSIZE)
+		+ static_cast<float>(Video::GetHalfHeight()) -r;
+	Video::DrawRect( static_cast<int>(x),static_cast<int>(y),
+		static_cast<int>(2*r),static_cast<int>(2*r), 0,255.f,0.f, .1f);
+
+	if( !nodes[n].isLeaf ){ // Node
+		for(int t=0;t<4;t++){
+			if( nodes[n].children[t] != FLATQUAD_NONE ) DrawNode( nodes[n].children[t], root, scale );
+		}
+	} else { // Leaf
+		vector<Entry>& entries = nodes[n].entries;
+		for( unsigned int slot = 0; slot < entries.size(); ++slot ) {
+			Coordinate pos = Coordinate( entries[slot].x, entries[slot].y ) - root;
+			int posx = static_cast<int>((scale* (float)pos.GetX() / QUADRANTSIZE) + (float)Video::GetHalfWidth());
+			int posy = static_cast<int>((scale* (float)pos.GetY() / QUADRANTSIZE) + (float)Video::GetHalfHeight());
+			Color col = entries[slot].sprite->GetRadarColor();
+			// The 17 is here because it looks nice.  I can't explain why.
+			Video::DrawCircle( posx, posy, static_cast<int>(17.f*entries[slot].size/scale),2, col.r,col.g,col.b );
+		}
+	}
+}
+
+/** \brief Add an Entry to the tree below a node
+ *
+ * Every node that is passed through counts the new Sprite.
+ * The Leaf that receives the Sprite is marked as dirty.
+ */
+void FlatQuadTree::InsertEntry(int n, const Entry& entry){
+	while( !nodes[n].isLeaf ) { // Node
+		nodes[n].count++;
+		n = ChildThatContains( n, entry.x, entry.y );
+	}
+	// Leaf
+	nodes[n].count++;
+	nodes[n].entries.push_back( entry );
+	SetHome( n, nodes[n].entries.size() - 1 );
+	// An over Full Leaf should become a Node
+	nodes[n].isDirty = true;
+}
+
+/** \brief Remove an Entry from a Leaf
+ *
+ * The last Entry of the Leaf is moved into the empty slot, so slots greater
+ * than or equal to this one are invalidated.  Every Node above the Leaf is
+ * marked as dirty.
+ */
+void FlatQuadTree::RemoveEntry(int leaf, unsigned int slot){
+	vector<Entry>& entries = nodes[leaf].entries;
+	assert( slot < entries.size() );
+	entries[slot] = entries.back();
+	entries.pop_back();
+	if( slot < entries.size() ) {
+		SetHome( leaf, slot );
+	}
+
+	// Note that leaves don't ReBallance on delete.
+	nodes[leaf].count--;
+	for( int n = nodes[leaf].parent; n != FLATQUAD_NONE; n = nodes[n].parent ) {
+		nodes[n].count--;
+		nodes[n].isDirty = true;
+	}
+}
+
+/** \brief Turn a Leaf into a Node by pushing its entries into new Leaves
+ */
+void FlatQuadTree::Split(int n){
+	assert( nodes[n].isLeaf );
+	assert( 0 != nodes[n].entries.size() ); // The Leaf list should not be empty
+
+	scratch.clear();
+	scratch.swap( nodes[n].entries );
+	nodes[n].isLeaf = false;
+	for( unsigned int i = 0; i < scratch.size(); ++i ) {
+		InsertEntry( ChildThatContains( n, scratch[i].x, scratch[i].y ), scratch[i] );
+	}
+	// Hand the (now larger) buffer back so that it can be reused.
+	scratch.swap( nodes[n].entries );
+	nodes[n].entries.clear();
+	scratch.clear();
+}
+
+/** \brief Turn a Node into a Leaf by pulling up all of the entries of its subtrees
+ */
+void FlatQuadTree::Merge(int n){
+	assert( !nodes[n].isLeaf );
+	assert( 0 == nodes[n].entries.size() ); // The Leaf list should be empty
+
+	scratch.clear();
+	for(int t=0;t<4;t++){
+		if( nodes[n].children[t] != FLATQUAD_NONE ){
+			CollectEntries( nodes[n].children[t], &scratch );
+			FreeNode( nodes[n].children[t] );
+			nodes[n].children[t] = FLATQUAD_NONE;
+		}
+	}
+	nodes[n].isLeaf = true;
+	nodes[n].entries.assign( scratch.begin(), scratch.end() );
+	for( unsigned int slot = 0; slot < nodes[n].entries.size(); ++slot ) {
+		SetHome( n, slot );
+	}
+	scratch.clear();
+}
+
+/** \brief Split and Merge a node, then ReBallance its subtrees
+ * \see QuadTree::ReBallance
+ */
+void FlatQuadTree::ReBallanceNode(int n){
+	if( nodes[n].isDirty && nodes[n].isLeaf && nodes[n].count>QUADMAXOBJECTS && nodes[n].radius>MIN_QUAD_SIZE ){
+		Split( n );
+	} else if( nodes[n].isDirty && !nodes[n].isLeaf && nodes[n].count<=QUADMAXOBJECTS ){
+		Merge( n );
+	}
+
+	// ReBallance the subtrees
+	for(int t=0;t<4;t++){
+		int child = nodes[n].children[t];
+		if( child != FLATQUAD_NONE ){
+			if( nodes[child].count == 0 ){
+				FreeNode( child );
+				nodes[n].children[t] = FLATQUAD_NONE;
+			} else {
+				ReBallanceNode( child );
+			}
+		}
+	}
+	nodes[n].isDirty = false;
+}
+
+/** \brief Append every Entry below a node
+ */
+void FlatQuadTree::CollectEntries(int n, vector<Entry> *out){
+	out->insert( out->end(), nodes[n].entries.begin(), nodes[n].entries.end() );
+	for(int t=0;t<4;t++){
+		if( nodes[n].children[t] != FLATQUAD_NONE ){
+			CollectEntries( nodes[n].children[t], out );
+		}
+	}
+}
+
+/** \brief Check if a point is inside of a node
+ */
+bool FlatQuadTree::NodeContains(int n, float x, float y){
+	const Node& node = nodes[n];
+	return (node.x - node.radius <= x) && (node.x + node.radius >= x)
+	    && (node.y - node.radius <= y) && (node.y + node.radius >= y);
+}
+
+/** \brief Check if any part of a node could be within a distance of a point
+ * \see Quadrant::PossiblyNear
+ */
+bool FlatQuadTree::NodePossiblyNear(int n, float x, float y, float distance){
+	const Node& node = nodes[n];
+	const float maxrange = static_cast<float>(V_SQRT2)*node.radius + distance;
+	const float dx = x - node.x;
+	const float dy = y - node.y;
+	return( dx*dx + dy*dy <= maxrange*maxrange );
+}
+
+/** \brief Copy the current Sprite values into an Entry
+ */
+void FlatQuadTree::RefreshEntry(Entry& entry){
+	Coordinate pos = entry.sprite->GetWorldPosition();
+	entry.x = static_cast<float>(pos.GetX());
+	entry.y = static_cast<float>(pos.GetY());
+	entry.size = static_cast<float>(entry.sprite->GetRadarSize());
+}
+
+/** \brief Check that a Sprite's QuadrantHome points to where it is stored in this tree
+ */
+bool FlatQuadTree::IsHome(Sprite* obj){
+	QuadrantHome* home = obj->GetHome();
+	return (home->quadrant == this)
+	    && (home->leaf >= 0) && (static_cast<unsigned int>(home->leaf) < nodes.size())
+	    && (home->slot < nodes[home->leaf].entries.size())
+	    && (nodes[home->leaf].entries[home->slot].sprite == obj);
+}
+
+/** \brief Record in a Sprite which Leaf and slot is holding it
+ * \note This leaves the moved flag alone, since the Sprite may already be queued.
+ */
+void FlatQuadTree::SetHome(int leaf, unsigned int slot){
+	const Node& node = nodes[leaf];
+	QuadrantHome* home = node.entries[slot].sprite->GetHome();
+	home->quadrant = this;
+	home->leaf = leaf;
+	home->slot = slot;
+	home->left = node.x - node.radius;
+	home->right = node.x + node.radius;
+	home->bottom = node.y - node.radius;
+	home->top = node.y + node.radius;
+}
+
+/** \brief Generate an XML Node of a node and its subtrees
+ * \see QuadTree::ToNode
+ */
+xmlNodePtr FlatQuadTree::NodeToXML(int n) {
+	xmlNodePtr thisNode, objNode;
+	char buff[256];
+
+	thisNode = xmlNewNode(NULL, BAD_CAST "QuadTree" );
+
+	snprintf(buff, sizeof(buff), "%d", (int) nodes[n].x );
+	xmlSetProp( thisNode, BAD_CAST "x", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", (int) nodes[n].y );
+	xmlSetProp( thisNode, BAD_CAST "y", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", (int) nodes[n].radius );
+	xmlSetProp( thisNode, BAD_CAST "r", BAD_CAST buff );
+
+	if( !nodes[n].isLeaf ){ // Node
+		for(int t=0;t<4;t++){
+			if( nodes[n].children[t] != FLATQUAD_NONE ){
+				xmlAddChild(thisNode, NodeToXML( nodes[n].children[t] ) );
+			}
+		}
+	} else { // Leaf
+		vector<Entry>& entries = nodes[n].entries;
+		for( unsigned int slot = 0; slot < entries.size(); ++slot ) {
+			Sprite* sprite = entries[slot].sprite;
+			switch( entries[slot].drawOrder ) {
+				case DRAW_ORDER_PLANET:
+					snprintf(buff, sizeof(buff), "%s", "Planet" );
+					break;
+				case DRAW_ORDER_PROJECTILE:
+					snprintf(buff, sizeof(buff), "%s", "Weapon" );
+					break;
+				case DRAW_ORDER_SHIP:
+					snprintf(buff, sizeof(buff), "%s", "Ship" );
+					break;
+				case DRAW_ORDER_PLAYER:
+					snprintf(buff, sizeof(buff), "%s", "Player" );
+					break;
+				case DRAW_ORDER_GATE_TOP:
+					snprintf(buff, sizeof(buff), "%s", "Gate" );
+					break;
+				case DRAW_ORDER_EFFECT:
+					snprintf(buff, sizeof(buff), "%s", "Effect" );
+					break;
+				case DRAW_ORDER_GATE_BOTTOM: // Ignore
+					continue;
+				default:
+					LogMsg(ERR,"Unknown Sprite Type: %d", entries[slot].drawOrder);
+					assert(0);
+					break;
+			}
+			objNode = xmlNewNode(NULL, BAD_CAST buff);
+			snprintf(buff, sizeof(buff), "%d", (int) sprite->GetWorldPosition().GetX() );
+			xmlSetProp( objNode, BAD_CAST "x", BAD_CAST buff );
+			snprintf(buff, sizeof(buff), "%d", (int) sprite->GetWorldPosition().GetY() );
+			xmlSetProp( objNode, BAD_CAST "y", BAD_CAST buff );
+			snprintf(buff, sizeof(buff), "%d", (int) sprite->GetAngle() );
+			xmlSetProp( objNode, BAD_CAST "angle", BAD_CAST buff );
+			xmlAddChild(thisNode, objNode);
+		}
+	}
+
+	return thisNode;
+}
@@ -0,0 +1,87 @@
+/**\file			flatquadtree.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A QuadTree that keeps all of its nodes in one pooled array.
+ * \details
+ */
+
+#ifndef __h_flatquadtree__
+#define __h_flatquadtree__
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/sprite.h"
+#include "Utilities/quadrant.h"
+
+#define FLATQUAD_NONE (-1) ///< Index of a missing node.
+
+class FlatQuadTree : public Quadrant {
+	public:
+		FlatQuadTree(Coordinate center, float radius);
+		~FlatQuadTree();
+
+		unsigned int Count();
+
+		void Insert(Sprite* obj);
+		bool Delete(Sprite* obj);
+
+		void GetSprites(vector<Sprite*> *sprites);
+		void GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type = DRAW_ORDER_ALL, unsigned int limit = 0);
+		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL);
+		unsigned int FixOutOfBounds(vector<Sprite*> *outofbounds);
+		void Moved(Sprite* obj);
+
+		void UpdatePhysics();
+		void Update( lua_State *L );
+		void Draw(Coordinate root);
+		void ReBallance();
+
+		xmlNodePtr ToNode();
+
+	private:
+		/// A Sprite stored in a leaf, along with a copy of the values that the searches need.
+		struct Entry {
+			float x, y;      ///< Cached world position.
+			float size;      ///< Cached radar size.
+			int drawOrder;   ///< Cached draw order.
+			Sprite* sprite;
+		};
+
+		/// One Leaf or Node of the tree.
+		struct Node {
+			float x, y;          ///< Center of this node.
+			float radius;        ///< Half of the width of this node.
+			int parent;          ///< Index of the parent node.
+			int children[4];     ///< Indices of the subtrees, FLATQUAD_NONE if missing.
+			unsigned int count;  ///< Number of Sprites in this node and below.
+			bool isLeaf;
+			bool isDirty;
+			vector<Entry> entries; ///< The Sprites in this Leaf. Nodes keep this empty.
+		};
+
+		int AllocateNode(float x, float y, float radius, int parent);
+		void FreeNode(int n);
+		int ChildThatContains(int n, float x, float y);
+		void DrawNode(int n, Coordinate root, float scale);
+		void InsertEntry(int n, const Entry& entry);
+		void RemoveEntry(int leaf, unsigned int slot);
+		void Split(int n);
+		void Merge(int n);
+		void ReBallanceNode(int n);
+		void CollectEntries(int n, vector<Entry> *out);
+		bool NodeContains(int n, float x, float y);
+		bool NodePossiblyNear(int n, float x, float y, float distance);
+		void RefreshEntry(Entry& entry);
+		bool IsHome(Sprite* obj);
+		void SetHome(int leaf, unsigned int slot);
+		xmlNodePtr NodeToXML(int n);
+
+		vector<Node> nodes;      ///< The node pool.  The root is always at index 0.
+		vector<int> freeNodes;   ///< Pool slots that can be reused.
+		vector<int> stack;       ///< Reusable traversal stack.
+		vector<Entry> scratch;   ///< Reusable entry buffer for splits and merges.
+		vector<Sprite*> moved;   ///< Sprites that have left their Leaf since the last FixOutOfBounds.
+};
+
+#endif // __h_flatquadtree__
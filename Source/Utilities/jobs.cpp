@@ -0,0 +1,282 @@
+/**\file			jobs.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A small work-stealing job system built on SDL threads.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/jobs.h"
+#include "Utilities/log.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/**\class Jobs
+ * \brief Runs Jobs across a fixed pool of threads.
+ * \details
+ * Every thread, including the main thread, owns a double ended queue of
+ * Jobs.  A thread pushes the Jobs that it submits onto the back of its own
+ * queue and works through them from the back.  When its queue is empty, it
+ * steals from the front of another thread's queue.  This keeps each thread
+ * working on its own recent Jobs and only touches the shared state when the
+ * work is unbalanced.
+ *
+ * The main thread is thread 0.  It does not sit idle while it Waits; it takes
+ * Jobs just like the worker threads do.
+ *
+ * If the Jobs were never Initialized there are no worker threads, and Wait
+ * simply runs every Job on the main thread.
+ *
+ * \code
+ *	MyJob a, b;
+ *	Jobs::Submit( &a );
+ *	Jobs::Submit( &b );
+ *	Jobs::Wait(); // a and b have both Run
+ * \endcode
+ */
+
+vector<Jobs::Worker*> Jobs::workers;
+SDL_mutex* Jobs::stateLock = NULL;
+SDL_cond* Jobs::stateChanged = NULL;
+int Jobs::queued = 0;
+int Jobs::pending = 0;
+bool Jobs::quitting = false;
+
+/**\brief Start the worker threads.
+ * \param numThreads The total number of threads, including the main thread.
+ *                   Zero or less uses one thread per processor.
+ */
+void Jobs::Initialize( int numThreads ) {
+	if( !workers.empty() ) {
+		LogMsg(WARN, "The Job system is already running." );
+		return;
+	}
+	if( numThreads <= 0 ) {
+		numThreads = CountProcessors();
+	}
+
+	stateLock = SDL_CreateMutex();
+	stateChanged = SDL_CreateCond();
+	queued = 0;
+	pending = 0;
+	quitting = false;
+
+	// The workers wait for this lock before they start, so that every
+	// queue and thread id is in place before any of them can steal.
+	SDL_LockMutex( stateLock );
+	for( int i = 0; i < numThreads; ++i ) {
+		Worker* worker = new Worker;
+		worker->thread = NULL;
+		worker->id = 0; // Only workers are matched by id; the main thread is always worker 0.
+		worker->lock = SDL_CreateMutex();
+
+		if( i > 0 ) {
+			worker->thread = SDL_CreateThread( WorkerMain, (void*)(long)workers.size() );
+			if( worker->thread == NULL ) {
+				LogMsg(ERR, "Could not create worker thread %d: %s", i, SDL_GetError() );
+				SDL_DestroyMutex( worker->lock );
+				delete worker;
+				continue;
+			}
+			worker->id = SDL_GetThreadID( worker->thread );
+		}
+		workers.push_back( worker );
+	}
+	SDL_UnlockMutex( stateLock );
+
+	LogMsg(INFO, "Started the Job system with %d threads.", static_cast<int>(workers.size()) );
+}
+
+/**\brief Stop and join the worker threads.
+ * \warn Every submitted Job should be finished before calling this.
+ */
+void Jobs::Shutdown() {
+	if( workers.empty() ) {
+		return;
+	}
+
+	SDL_LockMutex( stateLock );
+	quitting = true;
+	SDL_CondBroadcast( stateChanged );
+	SDL_UnlockMutex( stateLock );
+
+	for( unsigned int i = 0; i < workers.size(); ++i ) {
+		if( workers[i]->thread != NULL ) {
+			SDL_WaitThread( workers[i]->thread, NULL );
+		}
+		SDL_DestroyMutex( workers[i]->lock );
+		delete workers[i];
+	}
+	workers.clear();
+
+	SDL_DestroyCond( stateChanged );
+	SDL_DestroyMutex( stateLock );
+	stateChanged = NULL;
+	stateLock = NULL;
+}
+
+/**\brief Queue a Job to be Run.
+ * \details The Job may start immediately on another thread.
+ *          This may be called from inside of a running Job.
+ */
+void Jobs::Submit( Job* job ) {
+	if( workers.empty() ) {
+		job->Run();
+		return;
+	}
+
+	// Count the Job before it can be seen so that the counts never go negative.
+	SDL_LockMutex( stateLock );
+	queued++;
+	pending++;
+	SDL_UnlockMutex( stateLock );
+
+	Worker* self = workers[ GetThreadIndex() ];
+	SDL_LockMutex( self->lock );
+	self->jobs.push_back( job );
+	SDL_UnlockMutex( self->lock );
+
+	SDL_LockMutex( stateLock );
+	SDL_CondBroadcast( stateChanged );
+	SDL_UnlockMutex( stateLock );
+}
+
+/**\brief Help run Jobs until every submitted Job is finished.
+ * \details This should only be called from the main thread.
+ */
+void Jobs::Wait() {
+	if( workers.empty() ) {
+		return;
+	}
+	assert( GetThreadIndex() == 0 );
+
+	for(;;) {
+		Job* job = Take( 0 );
+		if( job != NULL ) {
+			job->Run();
+			Finish();
+			continue;
+		}
+
+		SDL_LockMutex( stateLock );
+		if( pending == 0 ) {
+			SDL_UnlockMutex( stateLock );
+			break;
+		}
+		if( queued == 0 ) {
+			SDL_CondWait( stateChanged, stateLock );
+		}
+		SDL_UnlockMutex( stateLock );
+	}
+}
+
+/**\brief The number of threads that run Jobs, including the main thread.
+ */
+int Jobs::GetNumThreads() {
+	return workers.empty() ? 1 : workers.size();
+}
+
+/**\brief The index of the calling thread.
+ * \returns 0 for the main thread (or any thread that isn't a worker) and 1 to GetNumThreads()-1 for workers.
+ */
+int Jobs::GetThreadIndex() {
+	Uint32 id = SDL_ThreadID();
+	for( unsigned int i = 1; i < workers.size(); ++i ) {
+		if( workers[i]->id == id ) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+/**\brief The loop that each worker thread runs.
+ */
+int Jobs::WorkerMain( void* data ) {
+	int self = (int)(long)data;
+
+	// Wait for Initialize to finish creating the other workers.
+	SDL_LockMutex( stateLock );
+	SDL_UnlockMutex( stateLock );
+
+	for(;;) {
+		Job* job = Take( self );
+		if( job != NULL ) {
+			job->Run();
+			Finish();
+			continue;
+		}
+
+		// Sleep until there is something to do.
+		SDL_LockMutex( stateLock );
+		while( !quitting && queued == 0 ) {
+			SDL_CondWait( stateChanged, stateLock );
+		}
+		bool quit = quitting;
+		SDL_UnlockMutex( stateLock );
+		if( quit ) {
+			break;
+		}
+	}
+	return 0;
+}
+
+/**\brief Take the newest Job from our own queue, or steal the oldest Job from another thread.
+ * \returns A Job or NULL if every queue is empty.
+ */
+Job* Jobs::Take( int self ) {
+	Job* job = NULL;
+	int numWorkers = workers.size();
+
+	Worker* own = workers[self];
+	SDL_LockMutex( own->lock );
+	if( !own->jobs.empty() ) {
+		job = own->jobs.back();
+		own->jobs.pop_back();
+	}
+	SDL_UnlockMutex( own->lock );
+
+	for( int i = 1; (job == NULL) && (i < numWorkers); ++i ) {
+		Worker* victim = workers[ (self + i) % numWorkers ];
+		SDL_LockMutex( victim->lock );
+		if( !victim->jobs.empty() ) {
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+		}
+		SDL_UnlockMutex( victim->lock );
+	}
+
+	if( job != NULL ) {
+		SDL_LockMutex( stateLock );
+		queued--;
+		SDL_UnlockMutex( stateLock );
+	}
+	return job;
+}
+
+/**\brief Record that a Job has finished running.
+ */
+void Jobs::Finish() {
+	SDL_LockMutex( stateLock );
+	pending--;
+	if( pending == 0 ) {
+		SDL_CondBroadcast( stateChanged );
+	}
+	SDL_UnlockMutex( stateLock );
+}
+
+/**\brief The number of processors on this machine.
+ */
+int Jobs::CountProcessors() {
+	int count = 1;
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	count = info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	count = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+	return (count > 0) ? count : 1;
+}
@@ -0,0 +1,59 @@
+/**\file			jobs.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A small work-stealing job system built on SDL threads.
+ * \details
+ */
+
+#ifndef __h_jobs__
+#define __h_jobs__
+
+#include "includes.h"
+#include <deque>
+
+/**\class Job
+ * \brief A piece of work that may be run on any thread.
+ * \details Jobs are owned by whoever submits them.  They must stay alive until
+ *          Jobs::Wait returns.
+ */
+class Job {
+	public:
+		virtual ~Job() {}
+		virtual void Run() = 0;
+};
+
+class Jobs {
+	public:
+		static void Initialize( int numThreads );
+		static void Shutdown();
+
+		static void Submit( Job* job );
+		static void Wait();
+
+		static int GetNumThreads();
+		static int GetThreadIndex();
+
+	private:
+		/// One thread and the jobs that it has queued.
+		struct Worker {
+			SDL_Thread* thread;
+			Uint32 id;
+			SDL_mutex* lock;       ///< Guards jobs.
+			deque<Job*> jobs;      ///< The owner works from the back, thieves steal from the front.
+		};
+
+		static int WorkerMain( void* data );
+		static Job* Take( int self );
+		static void Finish();
+		static int CountProcessors();
+
+		static vector<Worker*> workers;  ///< Worker 0 is the main thread.
+		static SDL_mutex* stateLock;     ///< Guards queued, pending and quitting.
+		static SDL_cond* stateChanged;   ///< Signaled when work is queued or all work is finished.
+		static int queued;               ///< Jobs that have been submitted but not yet taken.
+		static int pending;              ///< Jobs that have been submitted but not yet finished.
+		static bool quitting;
+};
+
+#endif // __h_jobs__
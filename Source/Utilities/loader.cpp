@@ -0,0 +1,225 @@
+/**\file			loader.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decodes Resources on background threads.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/loader.h"
+#include "Utilities/log.h"
+#include "Utilities/resource.h"
+
+#define LOADTASK_QUEUED   0
+#define LOADTASK_DECODING 1
+#define LOADTASK_DECODED  2
+
+/**\class Loader
+ * \brief Decodes Resources on background threads.
+ * \details
+ * Decoding a PNG or an OGG file can take long enough to drop a frame, so
+ * Resources that are not needed right away can be loaded in the background.
+ * The Resource is returned immediately in the RESOURCE_LOADING state, and a
+ * LoadTask is submitted for it.
+ *
+ * A loader thread Decodes the LoadTask, then the main thread Finishes it,
+ * since only the main thread may use OpenGL.  Each frame, Update Finishes the
+ * decoded LoadTasks until the upload budget is spent, so that many Images
+ * arriving at once are spread over several frames.
+ *
+ * A Resource that is needed right away can be Waited on.  If its LoadTask
+ * has not started yet, it is Decoded on the calling thread instead.
+ *
+ * If the Loader was never Initialized, every LoadTask is Decoded and
+ * Finished as soon as it is submitted.
+ *
+ * The threads are set by "options/loading/threads" and the budget, in
+ * kilobytes per frame, by "options/loading/upload-budget".
+ *
+ * \see Resource
+ */
+
+vector<SDL_Thread*> Loader::threads;
+SDL_mutex* Loader::lock = NULL;
+SDL_cond* Loader::stateChanged = NULL;
+deque<LoadTask*> Loader::queued;
+deque<LoadTask*> Loader::decoded;
+bool Loader::quitting = false;
+int Loader::budget = 0;
+
+/**\brief Create a LoadTask for a Resource.
+ */
+LoadTask::LoadTask( Resource* _resource ):
+	resource( _resource ),
+	state( LOADTASK_QUEUED )
+{
+}
+
+/**\brief Start the loader threads.
+ * \param numThreads The number of loader threads.  Zero loads everything immediately.
+ * \param uploadBudget Kilobytes to upload to OpenGL per frame.
+ */
+void Loader::Initialize( int numThreads, int uploadBudget ) {
+	if( lock != NULL ) {
+		LogMsg(WARN, "The Loader is already running." );
+		return;
+	}
+
+	lock = SDL_CreateMutex();
+	stateChanged = SDL_CreateCond();
+	quitting = false;
+	budget = uploadBudget * 1024;
+
+	for( int i = 0; i < numThreads; ++i ) {
+		SDL_Thread* thread = SDL_CreateThread( LoaderMain, NULL );
+		if( thread == NULL ) {
+			LogMsg(ERR, "Could not create loader thread %d: %s", i, SDL_GetError() );
+			continue;
+		}
+		threads.push_back( thread );
+	}
+
+	LogMsg(INFO, "Started the Loader with %d threads.", static_cast<int>(threads.size()) );
+}
+
+/**\brief Stop the loader threads and Finish everything that was submitted.
+ */
+void Loader::Shutdown() {
+	if( lock == NULL ) {
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	quitting = true;
+	SDL_CondBroadcast( stateChanged );
+	SDL_UnlockMutex( lock );
+
+	for( unsigned int i = 0; i < threads.size(); ++i ) {
+		SDL_WaitThread( threads[i], NULL );
+	}
+	threads.clear();
+
+	// No Resource may be left Loading.
+	while( !decoded.empty() ) {
+		Complete( decoded.front() );
+		decoded.pop_front();
+	}
+	while( !queued.empty() ) {
+		LoadTask* task = queued.front();
+		queued.pop_front();
+		task->Decode();
+		Complete( task );
+	}
+
+	SDL_DestroyCond( stateChanged );
+	SDL_DestroyMutex( lock );
+	stateChanged = NULL;
+	lock = NULL;
+}
+
+/**\brief Queue a LoadTask to be Decoded by a loader thread.
+ */
+void Loader::Submit( LoadTask* task ) {
+	if( threads.empty() ) {
+		task->Decode();
+		Complete( task );
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	task->state = LOADTASK_QUEUED;
+	queued.push_back( task );
+	SDL_CondBroadcast( stateChanged );
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief Finish a LoadTask now, Decoding it here if no loader thread has started it.
+ * \details This should only be called from the main thread.
+ *          The LoadTask is deleted before this returns.
+ */
+void Loader::Wait( LoadTask* task ) {
+	SDL_LockMutex( lock );
+	if( task->state == LOADTASK_QUEUED ) {
+		queued.erase( find( queued.begin(), queued.end(), task ) );
+		task->state = LOADTASK_DECODING;
+		SDL_UnlockMutex( lock );
+
+		task->Decode();
+
+		SDL_LockMutex( lock );
+	} else {
+		while( task->state != LOADTASK_DECODED ) {
+			SDL_CondWait( stateChanged, lock );
+		}
+		decoded.erase( find( decoded.begin(), decoded.end(), task ) );
+	}
+	SDL_UnlockMutex( lock );
+
+	Complete( task );
+}
+
+/**\brief Finish the LoadTasks that have been Decoded, until the upload budget is spent.
+ * \details Call this once per frame from the main thread.
+ *          At least one LoadTask is Finished, so that large Images are never stuck.
+ */
+void Loader::Update() {
+	if( lock == NULL ) {
+		return;
+	}
+
+	int uploaded = 0;
+	bool first = true;
+	while( first || (uploaded < budget) ) {
+		SDL_LockMutex( lock );
+		if( decoded.empty() ) {
+			SDL_UnlockMutex( lock );
+			break;
+		}
+		LoadTask* task = decoded.front();
+		decoded.pop_front();
+		SDL_UnlockMutex( lock );
+
+		uploaded += Complete( task );
+		first = false;
+	}
+}
+
+/**\brief The loop that each loader thread runs.
+ */
+int Loader::LoaderMain( void* data ) {
+	SDL_LockMutex( lock );
+	for(;;) {
+		while( !quitting && queued.empty() ) {
+			SDL_CondWait( stateChanged, lock );
+		}
+		if( quitting ) {
+			break;
+		}
+
+		LoadTask* task = queued.front();
+		queued.pop_front();
+		task->state = LOADTASK_DECODING;
+		SDL_UnlockMutex( lock );
+
+		task->Decode();
+
+		SDL_LockMutex( lock );
+		task->state = LOADTASK_DECODED;
+		decoded.push_back( task );
+		SDL_CondBroadcast( stateChanged );
+	}
+	SDL_UnlockMutex( lock );
+	return 0;
+}
+
+/**\brief Finish a Decoded LoadTask and tell its Resource.
+ * \returns The bytes that were uploaded.
+ */
+int Loader::Complete( LoadTask* task ) {
+	int uploadSize = task->GetUploadSize();
+	bool success = task->Finish();
+	task->resource->FinishLoading( success );
+	delete task;
+	return uploadSize;
+}
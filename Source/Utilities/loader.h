@@ -0,0 +1,63 @@
+/**\file			loader.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Decodes Resources on background threads.
+ * \details
+ */
+
+#ifndef __h_loader__
+#define __h_loader__
+
+#include "includes.h"
+#include <deque>
+
+class Resource;
+
+/**\class LoadTask
+ * \brief The work of loading one Resource.
+ * \details LoadTasks are owned by the Loader once they are submitted, and are
+ *          deleted once they are finished.
+ */
+class LoadTask {
+	public:
+		LoadTask( Resource* resource );
+		virtual ~LoadTask() {}
+
+		/// Read and decode the file.  This runs on a loader thread, so it must not use OpenGL or the Log.
+		virtual void Decode() = 0;
+		/// Hand the decoded data to the Resource.  This runs on the main thread.
+		virtual bool Finish() = 0;
+		/// The bytes that Finish will upload to OpenGL.
+		virtual int GetUploadSize() { return 0; }
+
+	private:
+		friend class Loader;
+
+		Resource* resource;
+		int state; ///< Queued, Decoding or Decoded.  Guarded by Loader::lock.
+};
+
+class Loader {
+	public:
+		static void Initialize( int numThreads, int uploadBudget );
+		static void Shutdown();
+
+		static void Submit( LoadTask* task );
+		static void Wait( LoadTask* task );
+		static void Update();
+
+	private:
+		static int LoaderMain( void* data );
+		static int Complete( LoadTask* task );
+
+		static vector<SDL_Thread*> threads;
+		static SDL_mutex* lock;          ///< Guards the queues, quitting and the state of every LoadTask.
+		static SDL_cond* stateChanged;   ///< Signaled when a LoadTask is queued or decoded.
+		static deque<LoadTask*> queued;  ///< LoadTasks waiting for a loader thread.
+		static deque<LoadTask*> decoded; ///< LoadTasks waiting for the main thread.
+		static bool quitting;
+		static int budget;               ///< Bytes to upload to OpenGL per frame.
+};
+
+#endif // __h_loader__
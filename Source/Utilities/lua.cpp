@@ -13,6 +13,8 @@
 #include "Utilities/file.h"
 #include "Utilities/lua.h"
 #include "Utilities/log.h"
+#include "Utilities/random.h"
+#include "Utilities/timer.h"
 
 
 /**\class Lua
@@ -20,6 +22,15 @@
 
 bool Lua::luaInitialized = false;
 lua_State *Lua::L = NULL;
+map<string,int> Lua::chunks;
+bool Lua::collectorPaced = false;
+bool Lua::collecting = false;
+int Lua::collectedMemory = 0;
+LuaCollectorStats Lua::collectorStats;
+bool Lua::profiling = false;
+vector<LuaProfileFrame> Lua::profileStack;
+map<string,LuaProfileStats> Lua::profileFunctions;
+map<string,Uint64> Lua::profileStacks;
 
 bool Lua::Load( const string& filename ) {
 	File pathTranslator; // use this to determine the physfs-resolved path, e.g. absolute/full path
@@ -95,6 +106,62 @@ int Lua::Run( string line, bool allowReturns ) {
 	}
 }
 
+/**\brief Compile a line of Lua code once, to be run many times.
+ * \details Compiling the same line again returns the same chunk without
+ *          parsing it, so callers that hold onto a line (control functions,
+ *          key bindings, ...) only pay for the compilation when it changes.
+ *          The chunks live until Lua is closed, so don't use this for lines
+ *          that are built on the fly.
+ * \param allowReturns When true the values of the line are returned when run.
+ * \returns A chunk for RunChunk, or LUA_NOREF if the line could not be compiled.
+ */
+int Lua::Compile( string line, bool allowReturns ) {
+	if( ! luaInitialized ) {
+		if( Init() == false ) {
+			LogMsg(WARN, "Could not compile Lua code. Unable to initialize Lua." );
+			return LUA_NOREF;
+		}
+	}
+
+	if( allowReturns ) {
+		line = "return " + line;
+	}
+
+	map<string,int>::iterator found = chunks.find( line );
+	if( found != chunks.end() ) {
+		return found->second;
+	}
+
+	if( luaL_loadbuffer(L, line.c_str(), line.size(), line.c_str()) ) {
+		LogMsg(ERR,"Error compiling '%s': %s", line.c_str(), lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return LUA_NOREF; // Not remembered, so that the error is logged each time.
+	}
+	int chunk = luaL_ref(L, LUA_REGISTRYINDEX);
+	chunks.insert( make_pair( line, chunk ) );
+	return chunk;
+}
+
+/**\brief Run a chunk from Compile.
+ * \param allowReturns Must match the value given to Compile.
+ * \returns The number of return values left on the stack.
+ */
+int Lua::RunChunk( int chunk, bool allowReturns ) {
+	if( chunk == LUA_NOREF ) {
+		return 0;
+	}
+
+	int stack_before = lua_gettop(L);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, chunk);
+	if( lua_pcall(L, 0, allowReturns ? LUA_MULTRET : 0, 0) ) {
+		LogMsg(ERR,"Error running chunk: %s", lua_tostring(L, -1));
+		lua_settop(L, stack_before);  /* pop error message from the stack */
+		Lua::stackDump( L );
+		return 0;
+	}
+	return lua_gettop(L) - stack_before;
+}
+
 // This function is from the Lua PIL
 // http://www.lua.org/pil/25.3.html
 // It was originally named "call_va"
@@ -105,6 +172,8 @@ bool Lua::Call(const char *func, const char *sig, ...) {
 	va_list vl;
 	int narg, nres,resultcount;  /* number of arguments and results */
 
+	LuaProfileScope profile( "Lua::Call", func );
+
 	va_start(vl, sig);
 	lua_getglobal(L, func);  /* get function */
 
@@ -201,6 +270,7 @@ bool Lua::Init() {
 
 bool Lua::Close() {
 	if( luaInitialized ) {
+		chunks.clear();
 		lua_close( L );
 	} else {
 		LogMsg(WARN, "Cannot deinitialize Lua. It is either not initialized or a script is still loaded." );
@@ -210,9 +280,346 @@ bool Lua::Close() {
 	return( true );
 }
 
+/**\brief Choose when Lua collects its garbage.
+ * \details Lua normally collects garbage whenever a script allocates memory,
+ *          which lands the work in the middle of AI decisions and callbacks.
+ *          While paced, automatic collection is stopped and StepCollector
+ *          does all of the work between frames instead.
+ *
+ *          The options/lua/gc-pause and options/lua/gc-stepmul options are
+ *          applied either way.
+ * \param paced True to stop automatic collection, false to restart it.
+ */
+void Lua::PaceCollector( bool paced ) {
+	lua_gc( L, LUA_GCSETPAUSE, OPTION(int, "options/lua/gc-pause") );
+	lua_gc( L, LUA_GCSETSTEPMUL, OPTION(int, "options/lua/gc-stepmul") );
+
+	memset( &collectorStats, 0, sizeof(collectorStats) );
+	collectorStats.memory = lua_gc( L, LUA_GCCOUNT, 0 );
+	collectedMemory = collectorStats.memory;
+	collectorPaced = paced;
+	collecting = true; // Finish whatever cycle is underway.
+
+	lua_gc( L, paced ? LUA_GCSTOP : LUA_GCRESTART, 0 );
+}
+
+/**\brief Collect garbage for as long as the frame can spare.
+ * \details Call this once per frame, after the screen has been updated.  While
+ *          a cycle is underway, the first step of every frame is sized by
+ *          the memory allocated since the last step, just as Lua's own
+ *          automatic steps would be, so collection keeps up with the scripts
+ *          even when there is no time to spare.  Any idle time left is spent
+ *          on further steps.  Once a cycle finishes, the next one waits until
+ *          memory has grown by options/lua/gc-pause percent.
+ * \param idle Nanoseconds left before the next frame is due.  No more than
+ *             options/lua/gc-budget microseconds are used.
+ */
+void Lua::StepCollector( Uint64 idle ) {
+	collectorStats.steps = 0;
+	collectorStats.time = 0;
+	collectorStats.memory = lua_gc( L, LUA_GCCOUNT, 0 );
+	if( !collectorPaced ) {
+		return;
+	}
+	if( !collecting ) {
+		if( collectorStats.memory < collectorStats.threshold ) {
+			return;
+		}
+		collecting = true;
+		collectedMemory = collectorStats.memory;
+	}
+
+	// Pay for what the scripts allocated, then use any time that is left over.
+	int debt = max( collectorStats.memory - collectedMemory, 0 );
+
+	const Uint64 budget = min( idle, static_cast<Uint64>( OPTION(int, "options/lua/gc-budget") ) * 1000 );
+	const Uint64 start = Timer::GetNanoseconds();
+	Uint64 now = start;
+	do {
+		int finished = lua_gc( L, LUA_GCSTEP, debt );
+		debt = 0;
+		lua_gc( L, LUA_GCSTOP, 0 ); // Each step turns automatic collection back on.
+
+		Uint64 after = Timer::GetNanoseconds();
+		collectorStats.longestPause = max( collectorStats.longestPause, after - now );
+		now = after;
+		++collectorStats.steps;
+
+		if( finished ) {
+			collecting = false;
+			++collectorStats.cycles;
+			collectorStats.threshold = lua_gc( L, LUA_GCCOUNT, 0 ) / 100 * OPTION(int, "options/lua/gc-pause");
+			break;
+		}
+	} while( now - start < budget );
+
+	collectorStats.time = now - start;
+	collectorStats.memory = lua_gc( L, LUA_GCCOUNT, 0 );
+	collectedMemory = collectorStats.memory;
+}
+
 void Lua::RegisterFunctions() {
 	lua_atpanic(L, &Lua::ErrorCatch);
 
+	// Lua's math.random uses rand(), so replace it with the Simulation's generator.
+	lua_getglobal(L, "math");
+	lua_pushcfunction(L, &Lua::MathRandom);
+	lua_setfield(L, -2, "random");
+	lua_pushcfunction(L, &Lua::MathRandomSeed);
+	lua_setfield(L, -2, "randomseed");
+	lua_pop(L, 1);
+
+	static const luaL_Reg profilerFunctions[] = {
+		{"start", &Lua::ProfilerStart},
+		{"stop", &Lua::ProfilerStop},
+		{"report", &Lua::ProfilerReport},
+		{"folded", &Lua::ProfilerFolded},
+		{NULL, NULL}
+	};
+	luaL_register(L, "Profiler", profilerFunctions);
+	lua_pop(L, 1);
+}
+
+/**\brief Replacement for math.random that draws from Random.
+ * \details This takes the same arguments as the original:
+ *  - No arguments returns a number from 0 up to 1.
+ *  - One argument u returns an integer from 1 to u.
+ *  - Two arguments l and u return an integer from l to u.
+ */
+int Lua::MathRandom(lua_State *L) {
+	double r = Random::Double();
+	switch( lua_gettop(L) ) {
+		case 0:
+			lua_pushnumber(L, r);
+			break;
+		case 1: {
+			int u = luaL_checkint(L, 1);
+			luaL_argcheck(L, 1<=u, 1, "interval is empty");
+			lua_pushnumber(L, floor(r*u)+1);
+			break;
+		}
+		case 2: {
+			int l = luaL_checkint(L, 1);
+			int u = luaL_checkint(L, 2);
+			luaL_argcheck(L, l<=u, 2, "interval is empty");
+			lua_pushnumber(L, floor(r*(u-l+1))+l);
+			break;
+		}
+		default:
+			return luaL_error(L, "wrong number of arguments");
+	}
+	return 1;
+}
+
+/**\brief Replacement for math.randomseed that seeds Random.
+ */
+int Lua::MathRandomSeed(lua_State *L) {
+	Random::Seed( static_cast<Uint32>( luaL_checkint(L, 1) ) );
+	return 0;
+}
+
+/**\brief Start timing every Lua function.
+ * \details A hook on every call and return records how long each function
+ *          took and who called it.  C++ code that calls into Lua declares a
+ *          LuaProfileScope so that the time is also charged to that entry
+ *          point, e.g. "AI::Decide Pirate.Hunting".
+ *
+ *          From the console:
+ *          - Profiler.start() clears the previous results and starts.
+ *          - Profiler.stop() stops.
+ *          - Profiler.report([filename]) returns the functions, sorted by the
+ *            time spent in each one, and optionally saves them.
+ *          - Profiler.folded(filename) saves every stack with its time in
+ *            microseconds, as read by flamegraph.pl.
+ *
+ *          Coroutines are not profiled.
+ */
+void Lua::StartProfiler() {
+	profileStack.clear();
+	profileFunctions.clear();
+	profileStacks.clear();
+	profiling = true;
+	lua_sethook( L, &Lua::ProfileHook, LUA_MASKCALL | LUA_MASKRET, 0 );
+	LogMsg(INFO, "Started the Lua Profiler" );
+}
+
+/**\brief Stop timing Lua functions, but keep the results.
+ */
+void Lua::StopProfiler() {
+	lua_sethook( L, NULL, 0, 0 );
+	profiling = false;
+	profileStack.clear();
+	LogMsg(INFO, "Stopped the Lua Profiler" );
+}
+
+/**\brief Charge the following Lua calls to a C++ entry point.
+ * \details Use a LuaProfileScope rather than calling this directly.
+ * \param detail,subdetail Appended to the entry name when not empty, to
+ *        tell apart e.g. the state machines and states.
+ */
+void Lua::ProfileEnter( const char* entry, const char* detail, const char* subdetail ) {
+	string name = entry;
+	if( detail[0] != '\0' ) {
+		name = name + " " + detail;
+	}
+	if( subdetail[0] != '\0' ) {
+		name = name + "." + subdetail;
+	}
+	ProfilePush( name, true );
+}
+
+/**\brief Leave the innermost C++ entry point.
+ * \details Any Lua functions that did not return (because of an error) are
+ *          closed along with it.
+ */
+void Lua::ProfileLeave() {
+	if( !profiling ) {
+		return;
+	}
+	while( !profileStack.empty() && !profileStack.back().entry ) {
+		ProfilePop();
+	}
+	if( !profileStack.empty() ) {
+		ProfilePop();
+	}
+}
+
+void Lua::ProfileHook( lua_State *L, lua_Debug *ar ) {
+	if( !profiling ) {
+		lua_sethook( L, NULL, 0, 0 ); // A coroutine that was created while profiling.
+		return;
+	}
+	if( L != Lua::L ) {
+		return; // Coroutines keep their own call stacks.
+	}
+
+	if( ar->event == LUA_HOOKCALL ) {
+		char name[256];
+		lua_getinfo( L, "nS", ar );
+		const char* function = (ar->name != NULL) ? ar->name : "?";
+		if( ar->what[0] == 'C' ) {
+			snprintf( name, sizeof(name), "%s [C]", function );
+		} else if( ar->what[0] == 'm' ) {
+			snprintf( name, sizeof(name), "main chunk (%s)", ar->short_src );
+		} else {
+			snprintf( name, sizeof(name), "%s (%s:%d)", function, ar->short_src, ar->linedefined );
+		}
+		// ';' separates the functions of a stack.
+		for( char* c = name; *c != '\0'; ++c ) {
+			if( *c == ';' ) *c = ',';
+		}
+		ProfilePush( name, false );
+	} else if( !profileStack.empty() && !profileStack.back().entry ) {
+		// A return, or the return of a function that made a tail call.
+		ProfilePop();
+	}
+}
+
+void Lua::ProfilePush( const string& name, bool entry ) {
+	LuaProfileFrame frame;
+	frame.name = name;
+	frame.path = profileStack.empty() ? name : (profileStack.back().path + ";" + name);
+	frame.children = 0;
+	frame.entry = entry;
+	profileStack.push_back( frame );
+	profileStack.back().start = Timer::GetNanoseconds(); // Don't count the bookkeeping.
+}
+
+void Lua::ProfilePop() {
+	LuaProfileFrame& frame = profileStack.back();
+	Uint64 elapsed = Timer::GetNanoseconds() - frame.start;
+	Uint64 self = elapsed - min( frame.children, elapsed );
+
+	LuaProfileStats& stats = profileFunctions[frame.name];
+	++stats.calls;
+	stats.total += elapsed;
+	stats.self += self;
+	profileStacks[frame.path] += self;
+
+	profileStack.pop_back();
+	if( !profileStack.empty() ) {
+		profileStack.back().children += elapsed;
+	}
+}
+
+/**\brief List every profiled function, from the most time spent to the least.
+ */
+string Lua::GetProfileReport() {
+	vector< pair<Uint64,string> > order;
+	map<string,LuaProfileStats>::iterator f;
+	for( f = profileFunctions.begin(); f != profileFunctions.end(); ++f ) {
+		order.push_back( make_pair( f->second.self, f->first ) );
+	}
+	sort( order.rbegin(), order.rend() );
+
+	char line[512];
+	string report = "     calls   total ms    self ms  function\n";
+	for( unsigned int i = 0; i < order.size(); ++i ) {
+		const LuaProfileStats& stats = profileFunctions[ order[i].second ];
+		snprintf( line, sizeof(line), "%10u %10.3f %10.3f  %s\n", stats.calls,
+			stats.total / 1000000.0, stats.self / 1000000.0, order[i].second.c_str() );
+		report += line;
+	}
+	return report;
+}
+
+/**\brief Save the time spent in every stack in the folded format of flamegraph.pl.
+ */
+bool Lua::SaveProfileStacks( const string& filename ) {
+	FILE *fp = fopen( filename.c_str(), "wb" );
+	if( fp == NULL ) {
+		LogMsg(ERR, "Could not save the Lua profile to '%s'", filename.c_str() );
+		return false;
+	}
+	map<string,Uint64>::iterator s;
+	for( s = profileStacks.begin(); s != profileStacks.end(); ++s ) {
+		unsigned long microseconds = static_cast<unsigned long>( s->second / 1000 );
+		if( microseconds > 0 ) {
+			fprintf( fp, "%s %lu\n", s->first.c_str(), microseconds );
+		}
+	}
+	fclose( fp );
+	return true;
+}
+
+int Lua::ProfilerStart(lua_State *L) {
+	StartProfiler();
+	return 0;
+}
+
+int Lua::ProfilerStop(lua_State *L) {
+	StopProfiler();
+	return 0;
+}
+
+/**\brief Profiler.report([filename]) returns the report as a string.
+ */
+int Lua::ProfilerReport(lua_State *L) {
+	int n = lua_gettop(L);
+	if( n > 1 )
+		return luaL_error(L, "Got %d arguments expected 0 or 1 (filename)", n);
+	string report = GetProfileReport();
+	if( n == 1 ) {
+		string filename = luaL_checkstring(L, 1);
+		FILE *fp = fopen( filename.c_str(), "wb" );
+		if( fp == NULL ) {
+			return luaL_error(L, "Could not save the Lua profile to '%s'", filename.c_str());
+		}
+		fputs( report.c_str(), fp );
+		fclose( fp );
+	}
+	lua_pushstring(L, report.c_str());
+	return 1;
+}
+
+/**\brief Profiler.folded(filename) returns true if the stacks were saved.
+ */
+int Lua::ProfilerFolded(lua_State *L) {
+	int n = lua_gettop(L);
+	if( n != 1 )
+		return luaL_error(L, "Got %d arguments expected 1 (filename)", n);
+	lua_pushboolean(L, SaveProfileStacks( luaL_checkstring(L, 1) ));
+	return 1;
 }
 
 int Lua::ErrorCatch(lua_State *L) {
@@ -22,6 +22,37 @@ extern "C" {
 }
 #endif
 
+/**\brief How much work the garbage collector has done.
+ * \see Lua::GetCollectorStats
+ */
+struct LuaCollectorStats {
+	int memory;          ///< Kilobytes in use by Lua.
+	int threshold;       ///< Kilobytes in use when the next cycle begins.
+	int steps;           ///< Steps taken during the last frame.
+	Uint64 time;         ///< Nanoseconds spent collecting during the last frame.
+	Uint64 longestPause; ///< Nanoseconds taken by the slowest single step.
+	int cycles;          ///< Cycles finished since the collector was paced.
+};
+
+/**\brief Where the profiler spent its time in one function.
+ * \see Lua::GetProfileReport
+ */
+struct LuaProfileStats {
+	Uint32 calls;
+	Uint64 total;       ///< Nanoseconds from call to return, including callees.
+	Uint64 self;        ///< Nanoseconds spent in the function itself.
+};
+
+/**\brief A function that the profiler is inside of.
+ */
+struct LuaProfileFrame {
+	string name;
+	string path;        ///< Every name down the stack, separated by ';'.
+	Uint64 start;       ///< When the function was called.
+	Uint64 children;    ///< Nanoseconds spent in callees.
+	bool entry;         ///< Pushed by a LuaProfileScope rather than by Lua.
+};
+
 class Lua {
 	public:
 		static bool Init();
@@ -29,6 +60,8 @@ class Lua {
 
 		static bool Load( const string& filename );
 		static int Run( string line, bool allowReturns=false );
+		static int Compile( string line, bool allowReturns=false );
+		static int RunChunk( int chunk, bool allowReturns=false );
 		static bool Call(const char *func, const char *sig="", ...);
 
 		static lua_State* CurrentState() { return L;}
@@ -56,12 +89,65 @@ class Lua {
 
 		static void stackDump(lua_State *L);
 
+		// Garbage Collection
+		static void PaceCollector( bool paced );
+		static void StepCollector( Uint64 idle );
+		static const LuaCollectorStats& GetCollectorStats() { return collectorStats; }
+
+		// Profiling
+		static void StartProfiler();
+		static void StopProfiler();
+		static bool IsProfiling() { return profiling; }
+		static void ProfileEnter( const char* entry, const char* detail, const char* subdetail );
+		static void ProfileLeave();
+		static string GetProfileReport();
+		static bool SaveProfileStacks( const string& filename );
+
 	private:
 		static int ErrorCatch(lua_State *L);
+		static int MathRandom(lua_State *L);
+		static int MathRandomSeed(lua_State *L);
+
+		static void ProfileHook( lua_State *L, lua_Debug *ar );
+		static void ProfilePush( const string& name, bool entry );
+		static void ProfilePop();
+		static int ProfilerStart(lua_State *L);
+		static int ProfilerStop(lua_State *L);
+		static int ProfilerReport(lua_State *L);
+		static int ProfilerFolded(lua_State *L);
 
 		// Internal variables
 		static lua_State *L;
 		static bool luaInitialized;
+		static map<string,int> chunks;         ///< Registry reference to the compiled function of each Compiled line.
+
+		static bool collectorPaced;            ///< Only StepCollector collects garbage.
+		static bool collecting;                ///< A cycle is in progress.
+		static int collectedMemory;            ///< Kilobytes in use after the last step, to measure what has been allocated since.
+		static LuaCollectorStats collectorStats;
+
+		static bool profiling;
+		static vector<LuaProfileFrame> profileStack;       ///< The functions currently being run.
+		static map<string,LuaProfileStats> profileFunctions; ///< Totals for each function.
+		static map<string,Uint64> profileStacks;           ///< Self time of each distinct stack.
+};
+
+/**\brief Attribute the Lua run by a C++ entry point to that entry point.
+ * \details Declare one of these just before calling into Lua.  When the
+ *          profiler is off this is a single test of a flag.
+ * \see Lua::StartProfiler
+ */
+class LuaProfileScope {
+	public:
+		LuaProfileScope( const char* entry, const char* detail = "", const char* subdetail = "" ) : active( Lua::IsProfiling() ) {
+			if( active ) Lua::ProfileEnter( entry, detail, subdetail );
+		}
+		~LuaProfileScope() {
+			if( active ) Lua::ProfileLeave();
+		}
+
+	private:
+		bool active;
 };
 
 #endif // __H_LUA__
@@ -0,0 +1,97 @@
+/**\file			quadrant.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Common interface for the spatial indexes that back a Quadrant.
+ * \details
+ */
+
+#ifndef __h_quadrant__
+#define __h_quadrant__
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/sprite.h"
+
+#define MIN_QUAD_SIZE 10.0f
+#define QUADRANTSIZE 4096.0f
+#define QUADMAXOBJECTS 3
+
+/**\class Quadrant
+ * \brief A square region of the universe that indexes the Sprites inside of it.
+ *
+ * The SpriteManager tiles the universe with Quadrants.  Each Quadrant is
+ * backed by a spatial index (the recursive QuadTree or the pooled
+ * FlatQuadTree).  The SpriteManager picks the backend at startup and then
+ * only talks to this interface.
+ *
+ * Query functions that take a vector append to it rather than allocating a
+ * new container, so callers can reuse the same buffer from tick to tick.
+ *
+ * A backend may also record where each Sprite lives in the Sprite's
+ * QuadrantHome.  The Sprite then calls Moved when it leaves that Leaf, and
+ * FixOutOfBounds only has to look at the Sprites that actually moved.
+ *
+ * \see QuadTree
+ * \see FlatQuadTree
+ */
+class Quadrant {
+	public:
+		Quadrant(Coordinate _center, float _radius) : center(_center), radius(_radius) {}
+		virtual ~Quadrant() {}
+
+		const Coordinate GetCenter() {return center;}
+		float GetRadius() {return radius;}
+
+		inline bool Contains(Coordinate point);
+		inline bool PossiblyNear(Coordinate point, float distance);
+
+		virtual unsigned int Count() = 0;
+
+		virtual void Insert(Sprite* obj) = 0;
+		virtual bool Delete(Sprite* obj) = 0;
+
+		virtual void GetSprites(vector<Sprite*> *sprites) = 0;
+		virtual void GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type = DRAW_ORDER_ALL, unsigned int limit = 0) = 0;
+		virtual Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL) = 0;
+		virtual unsigned int FixOutOfBounds(vector<Sprite*> *outofbounds) = 0;
+
+		/// Called by a Sprite when it moves outside of its QuadrantHome.
+		virtual void Moved(Sprite* obj) {}
+
+		/// Move every Sprite.  This may run on a Job thread, so it must only touch this Quadrant.
+		virtual void UpdatePhysics() = 0;
+		virtual void Update( lua_State *L ) = 0;
+		virtual void Draw(Coordinate root) = 0;
+		virtual void ReBallance() = 0;
+
+		virtual xmlNodePtr ToNode() = 0;
+
+	protected:
+		Coordinate center;
+		float radius;
+};
+
+/** \brief Check if a point is inside this Quadrant.
+ * \arg point The point that we want to check.
+ * \returns True if the point is inside the Quadrant.
+ */
+inline bool Quadrant::Contains(Coordinate point) {
+	bool insideLeftBorder = (center.GetX()-radius) <= point.GetX();
+	bool insideRightBorder = (center.GetX()+radius) >= point.GetX();
+	bool insideTopBorder = (center.GetY()+radius) >= point.GetY();
+	bool insideBottomBorder = (center.GetY()-radius) <= point.GetY();
+	return insideLeftBorder && insideRightBorder && insideTopBorder && insideBottomBorder;
+}
+
+inline bool Quadrant::PossiblyNear(Coordinate point, float distance) {
+	// The Maximum range is when the center and point are on a 45 degree angle.
+	//   Root-2 of the radius + the distance
+	// If the distance to the point is greater than the max range,
+	//   then no collisions are possible
+	// Math should be done in square-space to save time.
+	const float maxrange = static_cast<float>(V_SQRT2)*radius + distance;
+	return( (point-center).GetMagnitudeSquared() <= maxrange*maxrange );
+}
+
+#endif // __h_quadrant__
@@ -48,15 +48,15 @@ const char* PositionNames[4] = { "UPPER_LEFT", "UPPER_RIGHT", "LOWER_LEFT", "LOW
  * By default there are no instantiated subtrees.
  */
 
-QuadTree::QuadTree(Coordinate _center, float _radius){
+QuadTree::QuadTree(Coordinate _center, float _radius)
+	:Quadrant(_center, _radius)
+{
 	// cout<<"New QT at "<<_center<<" has R="<<_radius<<endl;
 	assert(_radius>MIN_QUAD_SIZE/2);
 	for(int t=0;t<4;t++){
 		subtrees[t] = NULL;
 	}
 	this->objects = new list<Sprite*>();
-	this->radius = _radius;
-	this->center = _center;
 	this->objectcount = 0;
 	this->isLeaf = true;
 	this->isDirty = false;
@@ -97,19 +97,6 @@ unsigned int QuadTree::Count(){
 	*/
 }
 
-/** \brief Check if a point is inside this QuadTree.
- * \arg point The point that we want to check.
- * \returns True if the point is inside the QuadTree.
- */
-
-bool QuadTree::Contains(Coordinate point){
-	bool insideLeftBorder = (center.GetX()-radius) <= point.GetX();
-	bool insideRightBorder = (center.GetX()+radius) >= point.GetX();
-	bool insideTopBorder = (center.GetY()+radius) >= point.GetY();
-	bool insideBottomBorder = (center.GetY()-radius) <= point.GetY();
-	return insideLeftBorder && insideRightBorder && insideTopBorder && insideBottomBorder;
-}
-
 /** \brief Add a Sprite to this Tree
  *
  * The Tree is marked as dirty if the Sprite is added to a Leaf.
@@ -191,34 +178,49 @@ list<Sprite *> *QuadTree::GetSprites() {
 	}
 }
 
+/** \brief Get all Sprites in this QuadTree
+ *
+ * \arg sprites [out] The vector that the Sprites are appended to.
+ */
+
+void QuadTree::GetSprites(vector<Sprite*> *sprites) {
+	if(!isLeaf){ // Node
+		for(int t=0;t<4;t++){
+			if(NULL != (subtrees[t])){
+				subtrees[t]->GetSprites( sprites );
+			}
+		}
+	} else { // Leaf
+		sprites->insert( sprites->end(), objects->begin(), objects->end() );
+	}
+}
+
 /** \brief Get all Sprites within a certain radius.
  *
  * \arg point The center of the search radius.
  * \arg distance The maximum search radius.
- * \arg nearby [out] The list of all Sprites found within the search radius.
+ * \arg nearby [out] Every Sprite found within the search radius is appended to this.
  * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \arg limit If not zero, the search stops once this many Sprites are found.
  *
- * The nearby list is passed down the recursive call-stack rather than returned at by each call.
+ * The nearby vector is passed down the recursive call-stack rather than returned by each call,
+ * and is owned by the caller so that the same buffer can be reused between searches.
  * This limits the malloc calls.
  *
  * \returns nothing.
  */
 
-void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *nearby, int type){
-	// The Maximum range is when the center and point are on a 45 degree angle.
-	//   Root-2 of the radius + the distance
-	const float maxrange = V_SQRT2*radius + distance;
-
-	// If the distance to the point is greater than the max range,
-	//   then no collisions are possible
-	if( (point-center).GetMagnitudeSquared() > maxrange*maxrange){
+void QuadTree::GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type, unsigned int limit){
+	if( !PossiblyNear(point, distance) ) {
 		return;
 	}
 
+	const unsigned int full = nearby->size() + limit;
 	if(!isLeaf){ // Node
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				subtrees[t]->GetSpritesNear(point,distance,nearby,type);
+				subtrees[t]->GetSpritesNear(point,distance,nearby,type,limit ? full - nearby->size() : 0);
+				if( limit && nearby->size() >= full ) return;
 			}
 		}
 	} else { // Leaf
@@ -227,6 +229,7 @@ void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *n
 			if( ((*i)->GetDrawOrder() & type) == 0) continue;
 			if( (point - (*i)->GetWorldPosition()).GetMagnitudeSquared() < distance*distance + (*i)->GetRadarSize()*(*i)->GetRadarSize() ) {
 				nearby->push_back( *i);
+				if( limit && nearby->size() >= full ) return;
 			}
 		}
 	}
@@ -297,10 +300,11 @@ Sprite* QuadTree::GetNearestSprite(Sprite* obj, float distance, int type){
  * Any Sprites that can be re-inserted into this QuadTree will be re-inserted.
  * Sprites that are outside of this this QuadTree are removed and forgotten.
  *
+ * \arg relocated [out] If given, this is increased by the number of Sprites that changed Leaves.
  * \returns List of all Sprites outside of this QuadTree.
  */
 
-list<Sprite*> *QuadTree::FixOutOfBounds(){
+list<Sprite*> *QuadTree::FixOutOfBounds(unsigned int *relocated){
 	list<Sprite*>::iterator i;
 	list<Sprite*> *other;
 	list<Sprite*> *stillinside = new list<Sprite*>();
@@ -309,7 +313,7 @@ list<Sprite*> *QuadTree::FixOutOfBounds(){
 		// Collect out of bound sprites from sub-trees
 		for(int t=0;t<4;t++){
 			if(NULL != (subtrees[t])){
-				other = subtrees[t]->FixOutOfBounds();
+				other = subtrees[t]->FixOutOfBounds(relocated);
 				outofbounds->splice(outofbounds->end(),*other);
 				delete other;
 			}
@@ -326,6 +330,7 @@ list<Sprite*> *QuadTree::FixOutOfBounds(){
 			this->Insert(*i);
 			outofbounds->remove(*i);
 		}
+		if( relocated ) *relocated += stillinside->size();
 	} else { // Leaf
 		// Collect and forget any out of bound sprites from object list
 		for( i = objects->begin(); i != objects->end(); ++i ) {
@@ -344,9 +349,41 @@ list<Sprite*> *QuadTree::FixOutOfBounds(){
 	return outofbounds;
 }
 
-/** \brief Update all Sprites in this QuadTree
+/** \brief  Check and remove any Sprites are not contained in this QuadTree.
+ *
+ * \arg outofbounds [out] Sprites that are outside of this QuadTree are appended here.
+ * \returns The number of Sprites that changed Leaves or left this QuadTree.
  */
 
+unsigned int QuadTree::FixOutOfBounds(vector<Sprite*> *outofbounds){
+	unsigned int relocated = 0;
+	list<Sprite*> *oob = FixOutOfBounds(&relocated);
+	relocated += oob->size();
+	outofbounds->insert( outofbounds->end(), oob->begin(), oob->end() );
+	delete oob;
+	return relocated;
+}
+
+/** \brief Move all Sprites in this QuadTree
+ */
+
+void QuadTree::UpdatePhysics(){
+	list<Sprite*>::iterator i;
+	if(!isLeaf){ // Node
+		for(int t=0;t<4;t++){
+			if(NULL != (subtrees[t])){
+				subtrees[t]->UpdatePhysics();
+			}
+		}
+	} else { // Leaf
+		for( i = objects->begin(); i != objects->end(); ++i ) {
+			(*i)->UpdatePhysics();
+		}
+	}
+}
+
+/** \brief Run the game logic for all Sprites in this QuadTree
+ */
 void QuadTree::Update( lua_State *L ){
 	list<Sprite*>::iterator i;
 	// Update all internal sprites
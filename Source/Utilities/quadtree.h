@@ -13,33 +13,29 @@
 #include "includes.h"
 #include "common.h"
 #include "Sprites/sprite.h"
-
-#define MIN_QUAD_SIZE 10.0f
-#define QUADRANTSIZE 4096.0f
-#define QUADMAXOBJECTS 3
+#include "Utilities/quadrant.h"
 
 enum QuadPosition{ UPPER_LEFT, UPPER_RIGHT,
                    LOWER_LEFT, LOWER_RIGHT };
 
-class QuadTree {
+class QuadTree : public Quadrant {
 	public:
 		QuadTree(Coordinate center, float radius);
 		~QuadTree();
 
 		unsigned int Count();
-		const Coordinate GetCenter() {return center;}
-
-		bool Contains(Coordinate point);
-		inline bool PossiblyNear(Coordinate, float distance);
 
 		void Insert(Sprite* obj);
 		bool Delete(Sprite* obj);
 
 		list<Sprite*> *GetSprites();
-		void GetSpritesNear(Coordinate point, float distance, list<Sprite*> *returnList, int type = DRAW_ORDER_ALL);
+		void GetSprites(vector<Sprite*> *sprites);
+		void GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *returnList, int type = DRAW_ORDER_ALL, unsigned int limit = 0);
 		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL);
-		list<Sprite*> *FixOutOfBounds();
+		list<Sprite*> *FixOutOfBounds(unsigned int *relocated = NULL);
+		unsigned int FixOutOfBounds(vector<Sprite*> *outofbounds);
 
+		void UpdatePhysics();
 		void Update( lua_State *L );
 		void Draw(Coordinate root);
 		void ReBallance();
@@ -53,8 +49,6 @@ class QuadTree {
 
 		QuadTree* subtrees[4];
 		list<Sprite*> *objects;
-		Coordinate center;
-		float radius;
 		unsigned int objectcount;
 		union{
 			// Unnamed struct so that these flags can be accessed directly
@@ -67,14 +61,4 @@ class QuadTree {
 		};
 };
 
-inline bool QuadTree::PossiblyNear(Coordinate point, float distance) {
-	// The Maximum range is when the center and point are on a 45 degree angle.
-	//   Root-2 of the radius + the distance
-	// If the distance to the point is greater than the max range,
-	//   then no collisions are possible
-	// Math should be done in square-space to save time.
-	const float maxrange = static_cast<float>(V_SQRT2)*radius + distance;
-	return( (point-center).GetMagnitudeSquared() <= maxrange*maxrange );
-}
-
 #endif // __h_quadtree__
@@ -0,0 +1,73 @@
+/**\file			random.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			The one random number generator used by the Simulation.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/random.h"
+
+/**\class Random
+ * \brief Seeded pseudo-random numbers.
+ * \details
+ * All of the randomness in the Simulation, including Lua's math.random, is
+ * drawn from this one generator.  Unlike rand(), the sequence is the same on
+ * every platform, so a Simulation started twice from the same seed makes the
+ * same choices both times.
+ *
+ * The generator is Marsaglia's xorshift128.
+ *
+ * \warn This is not thread safe.  Only use it from the main thread.
+ */
+
+Uint32 Random::seed = 0;
+Uint32 Random::state[4] = { 123456789, 362436069, 521288629, 88675123 };
+
+/**\brief Restart the sequence.
+ * \details Every seed, including zero, gives a different usable sequence.
+ */
+void Random::Seed( Uint32 _seed ) {
+	seed = _seed;
+
+	// Spread the seed across the whole state with splitmix32.
+	Uint32 z = _seed;
+	for( int i = 0; i < 4; ++i ) {
+		z += 0x9E3779B9;
+		Uint32 mix = z;
+		mix = (mix ^ (mix >> 16)) * 0x85EBCA6B;
+		mix = (mix ^ (mix >> 13)) * 0xC2B2AE35;
+		state[i] = mix ^ (mix >> 16);
+	}
+	if( (state[0] | state[1] | state[2] | state[3]) == 0 ) {
+		state[0] = 1;
+	}
+}
+
+/**\brief The next 32 random bits.
+ */
+Uint32 Random::Next( void ) {
+	Uint32 t = state[0] ^ (state[0] << 11);
+	state[0] = state[1];
+	state[1] = state[2];
+	state[2] = state[3];
+	state[3] = state[3] ^ (state[3] >> 19) ^ t ^ (t >> 8);
+	return state[3];
+}
+
+/**\brief A random integer from 0 up to (but not including) range.
+ * \returns 0 when range is not positive.
+ */
+int Random::Int( int range ) {
+	if( range <= 0 ) {
+		return 0;
+	}
+	return static_cast<int>( Double() * range );
+}
+
+/**\brief A random number from 0 up to (but not including) 1.
+ */
+double Random::Double( void ) {
+	return Next() * (1.0 / 4294967296.0);
+}
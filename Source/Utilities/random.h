@@ -0,0 +1,29 @@
+/**\file			random.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			The one random number generator used by the Simulation.
+ * \details
+ */
+
+#ifndef __h_random__
+#define __h_random__
+
+#include "includes.h"
+
+class Random {
+	public:
+		static void Seed( Uint32 seed );
+		static Uint32 GetSeed( void ) { return seed; }
+
+		static Uint32 Next( void );
+		static int Int( int range );
+		static double Double( void );
+		static float Float( void ) { return static_cast<float>( Double() ); }
+
+	private:
+		static Uint32 seed;     ///< The value passed to the last Seed.
+		static Uint32 state[4]; ///< The xorshift128 state.  Never all zero.
+};
+
+#endif // __h_random__
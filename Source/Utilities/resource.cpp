@@ -7,6 +7,7 @@
  */
 
 #include "includes.h"
+#include "Utilities/loader.h"
 #include "Utilities/resource.h"
 
 /** \class Resource
@@ -29,6 +30,11 @@
  *  can point to the same Resource.  For example, a model image might be stored
  *  as both the relative path and the model's name.
  *
+ *  Resources that are not needed right away may be loaded in the background
+ *  by the Loader.  They are stored immediately in the RESOURCE_LOADING state
+ *  and become RESOURCE_READY or RESOURCE_FAILED once the Loader is done.
+ *  Anything that needs the Resource before then should Wait on it.
+ *
  *  \note Currently, Resources are never freed.  The assumption here is that
  *  all Resouces will be used again in the lifetime of the game.  This may
  *  change in later versions of Epiar.
@@ -37,7 +43,7 @@
  *  Resource subclasses attempt to use the same key for different objects then
  *  errors will occur.
  *
- *  \see Image, Ani, Sound
+ *  \see Image, Ani, Sound, Loader
  */
 
 /** \brief The Master Resource Map.
@@ -47,7 +53,10 @@ map<string, Resource*> Resource::values;
 
 /** \brief Empty Resource constructor.
  */
-Resource::Resource() {
+Resource::Resource():
+	state( RESOURCE_READY ),
+	task( NULL )
+{
 }
 
 /** \brief Store a Resource given a Key and pointer.
@@ -71,3 +80,28 @@ Resource* Resource::Get(string path) {
 	} 
 	return NULL;
 }
+
+/** \brief Block until this Resource is done Loading.
+ *  \details Resources that are not Loading return immediately.
+ */
+void Resource::Wait() {
+	if( task != NULL ) {
+		Loader::Wait( task );
+	}
+}
+
+/** \brief Load this Resource in the background.
+ *  \details The Loader owns the LoadTask from now on.
+ */
+void Resource::StartLoading( LoadTask* _task ) {
+	state = RESOURCE_LOADING;
+	task = _task;
+	Loader::Submit( task ); // This may Finish before it returns
+}
+
+/** \brief Record whether this Resource was loaded.
+ */
+void Resource::FinishLoading( bool success ) {
+	state = success ? RESOURCE_READY : RESOURCE_FAILED;
+	task = NULL;
+}
@@ -12,12 +12,33 @@
 #ifndef __H_RESOURCE_CLASS
 #define __H_RESOURCE_CLASS
 
+class LoadTask;
+
+typedef enum {
+	RESOURCE_LOADING, // Being decoded in the background
+	RESOURCE_READY,
+	RESOURCE_FAILED
+} ResourceState;
+
 class Resource{
 	public:
 		Resource();
 		static void Store(string key, Resource* res);
 		static Resource* Get(string path);
+
+		ResourceState GetState() { return state; }
+		bool IsReady() { return state == RESOURCE_READY; }
+		void Wait();
+
+	protected:
+		void StartLoading( LoadTask* task );
+		void FinishLoading( bool success );
+
 	private:
+		friend class Loader;
+
+		ResourceState state;
+		LoadTask* task; // The LoadTask while this is Loading
 		static map<string,Resource*> values;
 };
 
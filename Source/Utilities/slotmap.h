@@ -0,0 +1,119 @@
+/**\file			slotmap.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			Values stored in reusable slots and referred to by generational handles.
+ * \details
+ */
+
+#ifndef __h_slotmap__
+#define __h_slotmap__
+
+#include "includes.h"
+#include <deque>
+
+/// A handle packs the index of a slot with the generation of that slot.
+/// The highest bit is never used so that handles are always positive ints,
+/// and generations skip 0 so that 0 is never a valid handle.
+#define SLOTMAP_INDEX_BITS      20
+#define SLOTMAP_INDEX_MASK      ((1u << SLOTMAP_INDEX_BITS) - 1)
+#define SLOTMAP_GENERATION_MASK ((1u << (31 - SLOTMAP_INDEX_BITS)) - 1)
+#define SLOTMAP_MAX_SLOTS       (SLOTMAP_INDEX_MASK + 1)
+
+typedef int SlotHandle;
+
+/**\class SlotMap
+ * \brief An array of values that are referred to by handles rather than pointers.
+ *
+ * Each handle is the index of the slot holding a value plus the generation of
+ * that slot.  Every time a slot is erased its generation is increased, so a
+ * handle to an erased value is stale and Get will return T() for it, even after
+ * the slot has been reused.  Lookups are a bounds check and a compare.
+ *
+ * Erased slots are kept on a free list and reused before the array grows.
+ * The slot that was erased longest ago is reused first, so that the reuses
+ * are spread over every free slot rather than hitting the same one.
+ *
+ * A slot whose generation would wrap around is retired instead of being
+ * freed, so a handle can never become valid again once its value is erased.
+ */
+template <class T>
+class SlotMap {
+	public:
+		SlotMap() : used(0) {}
+
+		/// Store a value and return its new handle.
+		SlotHandle Insert( T value ) {
+			unsigned int index;
+			if( freeSlots.empty() ) {
+				index = slots.size();
+				assert( index < SLOTMAP_MAX_SLOTS );
+				slots.push_back( Slot() );
+				slots[index].generation = 1;
+			} else {
+				index = freeSlots.front();
+				freeSlots.pop_front();
+			}
+			slots[index].value = value;
+			slots[index].used = true;
+			used++;
+			return MakeHandle( index, slots[index].generation );
+		}
+
+		/// Remove the value of a handle.  Stale handles are ignored.
+		void Erase( SlotHandle handle ) {
+			if( !Contains( handle ) ) return;
+			Slot& slot = slots[ GetIndex(handle) ];
+			slot.value = T();
+			slot.used = false;
+			used--;
+			if( slot.generation == SLOTMAP_GENERATION_MASK ) {
+				// Retired: the next generation would reuse old handles.
+				slot.generation = 0;
+				return;
+			}
+			slot.generation++;
+			freeSlots.push_back( GetIndex(handle) );
+		}
+
+		/// Get the value of a handle, or T() if the handle is stale.
+		T Get( SlotHandle handle ) const {
+			return Contains( handle ) ? slots[ GetIndex(handle) ].value : T();
+		}
+
+		/// Is the value of this handle still stored?
+		bool Contains( SlotHandle handle ) const {
+			unsigned int index = GetIndex( handle );
+			return handle > 0
+			    && index < slots.size()
+			    && slots[index].used
+			    && slots[index].generation == GetGeneration( handle );
+		}
+
+		unsigned int Size() const { return used; }
+
+		// Walk the slots directly.
+		unsigned int Capacity() const { return slots.size(); }
+		bool IsUsed( unsigned int index ) const { return slots[index].used; }
+		T At( unsigned int index ) const { return slots[index].value; }
+
+		static unsigned int GetIndex( SlotHandle handle ) { return static_cast<unsigned int>(handle) & SLOTMAP_INDEX_MASK; }
+		static unsigned int GetGeneration( SlotHandle handle ) { return (static_cast<unsigned int>(handle) >> SLOTMAP_INDEX_BITS) & SLOTMAP_GENERATION_MASK; }
+
+	private:
+		struct Slot {
+			T value;
+			unsigned int generation; ///< Increased every time this slot is erased.  0 once the slot is retired.
+			bool used;
+		};
+
+		static SlotHandle MakeHandle( unsigned int index, unsigned int generation ) {
+			return static_cast<SlotHandle>( (generation << SLOTMAP_INDEX_BITS) | index );
+		}
+
+		vector<Slot> slots;
+		deque<unsigned int> freeSlots; ///< Slots that can be reused, most recently erased last.
+		unsigned int used;
+};
+
+#endif // __h_slotmap__
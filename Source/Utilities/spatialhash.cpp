@@ -0,0 +1,230 @@
+/**\file			spatialhash.cpp
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A uniform grid of Sprites stored in an open-addressed hash table.
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/spatialhash.h"
+#include "Utilities/distancekernels.h"
+
+/**\class SpatialHash
+ * \brief A uniform grid of Sprites used as an alternative broadphase to the QuadTrees.
+ *
+ * The universe is cut into square cells of a fixed size.  Only the cells
+ * that hold Sprites are stored, in a CellTable keyed by the integer cell
+ * coordinates, so finding a cell is a single hash lookup no matter how
+ * crowded or how large the universe is.
+ *
+ * The grid is rebuilt once per tick with a counting sort, which leaves all
+ * of the Sprites of a cell next to each other in a set of packed arrays.  The
+ * searches then test each cell with the DistanceKernels.  Sprites that are
+ * created between Rebuilds are kept in a short list that every search also
+ * checks.
+ *
+ * \see SpriteManager
+ */
+
+/** \brief Constructor
+ * \arg cellSize The width of each cell in pixels.
+ */
+SpatialHash::SpatialHash(float cellSize)
+	:maxSize(0)
+{
+	SetCellSize( cellSize );
+}
+
+/** \brief Change the width of the cells
+ * \note This only takes effect after the next Rebuild.
+ */
+void SpatialHash::SetCellSize(float _cellSize){
+	assert( _cellSize > 0 );
+	cellSize = _cellSize;
+	inverseCellSize = 1.0f / cellSize;
+}
+
+/** \brief Re-sort all of the Sprites into their cells
+ * \arg all Every Sprite that should be in the grid.
+ */
+void SpatialHash::Rebuild(list<Sprite*> *all){
+	list<Sprite*>::iterator i;
+	unsigned int e;
+	Entry entry;
+
+	cells.Clear();
+	added.clear();
+	scratch.clear();
+	maxSize = 0;
+
+	// Count the Sprites in each cell.
+	for( i = all->begin(); i != all->end(); ++i ) {
+		MakeEntry( *i, &entry );
+		scratch.push_back( entry );
+		cells.Insert( CellOf(entry.x), CellOf(entry.y) ).count++;
+		if( entry.size > maxSize ) maxSize = entry.size;
+	}
+
+	// Give each cell its own range of entries.
+	unsigned int offset = 0;
+	for( unsigned int c = 0; c < cells.Capacity(); ++c ) {
+		if( cells.IsUsed(c) ) {
+			Cell& cell = cells.At(c);
+			cell.start = offset;
+			offset += cell.count;
+			cell.count = 0;
+		}
+	}
+
+	// Drop each Sprite into its range.
+	xs.resize( scratch.size() );
+	ys.resize( scratch.size() );
+	sizes.resize( scratch.size() );
+	drawOrders.resize( scratch.size() );
+	sprites.resize( scratch.size() );
+	hits.resize( scratch.size() );
+	for( e = 0; e < scratch.size(); ++e ) {
+		Cell* cell = cells.Find( CellOf(scratch[e].x), CellOf(scratch[e].y) );
+		const unsigned int slot = cell->start + cell->count++;
+		xs[slot] = scratch[e].x;
+		ys[slot] = scratch[e].y;
+		sizes[slot] = scratch[e].size;
+		drawOrders[slot] = scratch[e].drawOrder;
+		sprites[slot] = scratch[e].sprite;
+	}
+}
+
+/** \brief Add a Sprite until the next Rebuild
+ */
+void SpatialHash::Insert(Sprite* obj){
+	Entry entry;
+	MakeEntry( obj, &entry );
+	added.push_back( entry );
+	if( entry.size > maxSize ) maxSize = entry.size;
+}
+
+/** \brief Get all Sprites within a certain radius.
+ *
+ * \arg point The center of the search radius.
+ * \arg distance The maximum search radius.
+ * \arg nearby [out] All Sprites found within the search radius are appended here.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ * \arg limit If not zero, the search stops once this many Sprites are found.
+ */
+void SpatialHash::GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type, unsigned int limit){
+	const float px = static_cast<float>(point.GetX());
+	const float py = static_cast<float>(point.GetY());
+	const float distSquared = distance*distance;
+	const float reach = distance + maxSize;
+	const unsigned int full = nearby->size() + limit;
+	unsigned int found, h;
+
+	// Large searches are faster as a straight walk through the entries.
+	if( CellsAcross(reach) * CellsAcross(reach) > double(cells.Size()) ) {
+		if( !sprites.empty() ) {
+			found = DistanceKernels::WithinRadius( &xs[0], &ys[0], &sizes[0], &drawOrders[0], sprites.size(), px, py, distSquared, type, &hits[0] );
+			for( h = 0; h < found; ++h ) {
+				nearby->push_back( sprites[ hits[h] ] );
+				if( limit && nearby->size() >= full ) return;
+			}
+		}
+	} else {
+		const int x0 = CellOf(px - reach), x1 = CellOf(px + reach);
+		const int y0 = CellOf(py - reach), y1 = CellOf(py + reach);
+		for( int y = y0; y <= y1; ++y ) {
+			for( int x = x0; x <= x1; ++x ) {
+				Cell* cell = cells.Find( x, y );
+				if( cell == NULL ) continue;
+				const unsigned int start = cell->start;
+				found = DistanceKernels::WithinRadius( &xs[start], &ys[start], &sizes[start], &drawOrders[start], cell->count, px, py, distSquared, type, &hits[0] );
+				for( h = 0; h < found; ++h ) {
+					nearby->push_back( sprites[ start + hits[h] ] );
+					if( limit && nearby->size() >= full ) return;
+				}
+			}
+		}
+	}
+
+	for( unsigned int a = 0; a < added.size(); ++a ) {
+		if( (added[a].drawOrder & type) == 0 ) continue;
+		const float dx = px - added[a].x;
+		const float dy = py - added[a].y;
+		if( dx*dx + dy*dy < distSquared + added[a].size*added[a].size ) {
+			nearby->push_back( added[a].sprite );
+			if( limit && nearby->size() >= full ) return;
+		}
+	}
+}
+
+/**\brief Find the Sprite that is closest to a known point.
+ *
+ * \arg obj The Sprite at the center of the search radius.  This Sprite is ignored while searching.
+ * \arg distance A Max radius to use while searching.
+ * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
+ *
+ * \returns A pointer to the Sprite nearest the obj Sprite, within a certain distance, and of the correct type.
+ */
+Sprite* SpatialHash::GetNearestSprite(Sprite* obj, float distance, int type){
+	Coordinate point = obj->GetWorldPosition();
+	const float px = static_cast<float>(point.GetX());
+	const float py = static_cast<float>(point.GetY());
+	float mindistSquared = distance*distance;
+	Sprite* closest = NULL;
+
+	if( CellsAcross(distance) * CellsAcross(distance) > double(cells.Size()) ) {
+		if( !sprites.empty() ) {
+			closest = NearestInRange( obj, 0, sprites.size(), px, py, type, &mindistSquared );
+		}
+	} else {
+		const int x0 = CellOf(px - distance), x1 = CellOf(px + distance);
+		const int y0 = CellOf(py - distance), y1 = CellOf(py + distance);
+		for( int y = y0; y <= y1; ++y ) {
+			for( int x = x0; x <= x1; ++x ) {
+				Cell* cell = cells.Find( x, y );
+				if( cell == NULL ) continue;
+				Sprite* found = NearestInRange( obj, cell->start, cell->count, px, py, type, &mindistSquared );
+				if( found != NULL ) {
+					closest = found;
+				}
+			}
+		}
+	}
+
+	for( unsigned int a = 0; a < added.size(); ++a ) {
+		if( (added[a].sprite == obj) || ((added[a].drawOrder & type) == 0) ) continue;
+		const float dx = px - added[a].x;
+		const float dy = py - added[a].y;
+		if( dx*dx + dy*dy < mindistSquared ) {
+			mindistSquared = dx*dx + dy*dy;
+			closest = added[a].sprite;
+		}
+	}
+	return closest;
+}
+
+/** \brief Find the closest Sprite in a range of the packed arrays, other than obj.
+ * \arg mindistSquared [in,out] Only Sprites closer than this are considered.
+ * \returns The closest Sprite or NULL.
+ */
+Sprite* SpatialHash::NearestInRange(Sprite* obj, unsigned int start, unsigned int count, float px, float py, int type, float *mindistSquared){
+	const float before = *mindistSquared;
+	int best = DistanceKernels::Nearest( &xs[start], &ys[start], &drawOrders[start], count, px, py, type, -1, mindistSquared );
+	if( best >= 0 && sprites[start + best] == obj ) {
+		// The searching Sprite doesn't count, so look again without it.
+		*mindistSquared = before;
+		best = DistanceKernels::Nearest( &xs[start], &ys[start], &drawOrders[start], count, px, py, type, best, mindistSquared );
+	}
+	return (best >= 0) ? sprites[start + best] : NULL;
+}
+
+/** \brief Copy the current Sprite values into an Entry
+ */
+void SpatialHash::MakeEntry(Sprite* obj, Entry* entry){
+	Coordinate pos = obj->GetWorldPosition();
+	entry->x = static_cast<float>(pos.GetX());
+	entry->y = static_cast<float>(pos.GetY());
+	entry->size = static_cast<float>(obj->GetRadarSize());
+	entry->drawOrder = obj->GetDrawOrder();
+	entry->sprite = obj;
+}
@@ -0,0 +1,174 @@
+/**\file			spatialhash.h
+ * \author			and others.
+ * \date			Created: Saturday, October 17, 2026
+ * \date			Modified: Saturday, October 17, 2026
+ * \brief			A uniform grid of Sprites stored in an open-addressed hash table.
+ * \details
+ */
+
+#ifndef __h_spatialhash__
+#define __h_spatialhash__
+
+#include "includes.h"
+#include "common.h"
+#include "Sprites/sprite.h"
+
+/**\class CellTable
+ * \brief An open-addressed hash table keyed by integer grid coordinates.
+ *
+ * Collisions are resolved by linear probing.  Erasing shifts the following
+ * entries back, so there are no tombstones and lookups stay short.
+ * The table doubles whenever it becomes more than half full.
+ *
+ * The slots can be walked directly with Capacity, IsUsed and At.
+ */
+template <class T>
+class CellTable {
+	public:
+		CellTable() : used(0) { Allocate(64); }
+
+		/// Find the value stored at x,y or NULL if there isn't one.
+		T* Find(int x, int y) {
+			for( unsigned int i = Hash(x,y); slots[i].used; i = (i+1) & mask ) {
+				if( slots[i].x == x && slots[i].y == y ) return &slots[i].value;
+			}
+			return NULL;
+		}
+
+		/// Get the value stored at x,y, creating it as T() if it doesn't exist.
+		T& Insert(int x, int y) {
+			if( 2*(used+1) > slots.size() ) {
+				Allocate( 2*slots.size() );
+			}
+			unsigned int i;
+			for( i = Hash(x,y); slots[i].used; i = (i+1) & mask ) {
+				if( slots[i].x == x && slots[i].y == y ) return slots[i].value;
+			}
+			slots[i].used = true;
+			slots[i].x = x;
+			slots[i].y = y;
+			slots[i].value = T();
+			used++;
+			return slots[i].value;
+		}
+
+		/// Remove the value stored at x,y if there is one.
+		void Erase(int x, int y) {
+			unsigned int i;
+			for( i = Hash(x,y); slots[i].used; i = (i+1) & mask ) {
+				if( slots[i].x == x && slots[i].y == y ) break;
+			}
+			if( !slots[i].used ) return;
+			slots[i].used = false;
+			used--;
+			// Shift back any entries that probed past the hole.
+			for( unsigned int j = (i+1) & mask; slots[j].used; j = (j+1) & mask ) {
+				unsigned int home = Hash( slots[j].x, slots[j].y );
+				// Move j into the hole unless its home lies cyclically in (i, j].
+				bool stays = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+				if( !stays ) {
+					slots[i] = slots[j];
+					slots[j].used = false;
+					i = j;
+				}
+			}
+		}
+
+		/// Remove everything but keep the allocated slots.
+		void Clear() {
+			for( unsigned int i = 0; i < slots.size(); ++i ) {
+				slots[i].used = false;
+			}
+			used = 0;
+		}
+
+		unsigned int Size() { return used; }
+		unsigned int Capacity() { return slots.size(); }
+		bool IsUsed(unsigned int i) { return slots[i].used; }
+		T& At(unsigned int i) { return slots[i].value; }
+
+	private:
+		struct Slot {
+			int x, y;
+			bool used;
+			T value;
+		};
+
+		unsigned int Hash(int x, int y) {
+			return ( (static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(y) * 19349663u) ) & mask;
+		}
+
+		void Allocate(unsigned int capacity) {
+			vector<Slot> old;
+			old.swap( slots );
+			slots.resize( capacity );
+			for( unsigned int i = 0; i < slots.size(); ++i ) {
+				slots[i].used = false;
+			}
+			mask = capacity - 1;
+			used = 0;
+			for( unsigned int i = 0; i < old.size(); ++i ) {
+				if( old[i].used ) {
+					Insert( old[i].x, old[i].y ) = old[i].value;
+				}
+			}
+		}
+
+		vector<Slot> slots;
+		unsigned int used;
+		unsigned int mask;
+};
+
+class SpatialHash {
+	public:
+		SpatialHash(float cellSize);
+
+		float GetCellSize() { return cellSize; }
+		void SetCellSize(float cellSize);
+		unsigned int Count() { return sprites.size() + added.size(); }
+
+		void Rebuild(list<Sprite*> *all);
+		void Insert(Sprite* obj);
+
+		void GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type = DRAW_ORDER_ALL, unsigned int limit = 0);
+		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL);
+
+	private:
+		/// A Sprite along with a copy of the values that the searches need.
+		struct Entry {
+			float x, y;      ///< Cached world position.
+			float size;      ///< Cached radar size.
+			int drawOrder;   ///< Cached draw order.
+			Sprite* sprite;
+		};
+
+		/// The range of packed Sprites that fall into one cell.
+		struct Cell {
+			Cell() : start(0), count(0) {}
+			unsigned int start;
+			unsigned int count;
+		};
+
+		int CellOf(float v) { return static_cast<int>( floorf( v * inverseCellSize ) ); }
+		/// The most cells that a search of this radius can touch in one direction.
+		double CellsAcross(float reach) { return 2.0 * reach * inverseCellSize + 2.0; }
+		void MakeEntry(Sprite* obj, Entry* entry);
+		Sprite* NearestInRange(Sprite* obj, unsigned int start, unsigned int count, float px, float py, int type, float *mindistSquared);
+
+		float cellSize;
+		float inverseCellSize;
+		float maxSize;             ///< The largest radar size in the grid, used to widen searches.
+		CellTable<Cell> cells;     ///< Where each cell's Sprites are in the packed arrays.
+
+		// Every Sprite, grouped by cell and packed for the DistanceKernels.
+		vector<float> xs, ys;      ///< Cached world positions.
+		vector<float> sizes;       ///< Cached radar sizes.
+		vector<int> drawOrders;    ///< Cached draw orders.
+		vector<Sprite*> sprites;
+
+		vector<Entry> added;       ///< Sprites inserted since the last Rebuild.
+		vector<Entry> scratch;     ///< Reusable buffer for Rebuild.
+		vector<unsigned int> hits; ///< Reusable buffer for the DistanceKernels.
+};
+
+#endif // __h_spatialhash__
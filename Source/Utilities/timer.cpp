@@ -10,6 +10,10 @@
 #include "common.h"
 #include "Utilities/timer.h"
 
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#endif
+
 /**\class Timer
  * \brief Timer class. */
 
@@ -19,17 +23,19 @@ Uint32 Timer::ticksPerFrame = 0;
 float Timer::logicFPS = LOGIC_FPS;
 double Timer::virtualTime = 0;
 Uint32 Timer::logicalFrameCount = 0;
+bool Timer::virtualClock = false;
+Uint32 Timer::virtualTicks = 0;
 
 void Timer::Initialize( void ) {
 	lastLoopLength = 0;
-	lastLoopTick = SDL_GetTicks();
+	lastLoopTick = Now();
 	Uint32 fps = OPTION( Uint32, "options/video/fps" );
 	if( fps == 0 ) fps = 30;
 	ticksPerFrame = 1000 / OPTION( Uint32, "options/video/fps" );
 }
 
 int Timer::Update( void ) {
-	Uint32 tick = SDL_GetTicks();
+	Uint32 tick = Now();
 
 	lastLoopLength = tick - lastLoopTick;
 	lastLoopTick = tick;
@@ -55,10 +61,41 @@ Uint32 Timer::GetTicks( void )
  */
 Uint32 Timer::GetRealTicks( void )
 {
-	return SDL_GetTicks();
+	return Now();
+}
+
+/** \brief A high resolution timestamp for profiling.
+ *  \details This always follows the wall clock, even when the virtual clock
+ *  is in use.  Only the difference between two timestamps is meaningful.
+ */
+Uint64 Timer::GetNanoseconds( void )
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = { 0 };
+	LARGE_INTEGER now;
+	if( frequency.QuadPart == 0 ) {
+		QueryPerformanceFrequency( &frequency );
+	}
+	QueryPerformanceCounter( &now );
+	return static_cast<Uint64>( now.QuadPart / frequency.QuadPart ) * 1000000000
+	     + static_cast<Uint64>( now.QuadPart % frequency.QuadPart ) * 1000000000 / frequency.QuadPart;
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t timebase = { 0, 0 };
+	if( timebase.denom == 0 ) {
+		mach_timebase_info( &timebase );
+	}
+	return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return static_cast<Uint64>( now.tv_sec ) * 1000000000 + now.tv_nsec;
+#endif
 }
 
 void Timer::Delay( int waitMS ) {
+	if( virtualClock ) {
+		return; // Nothing is waiting on the wall clock.
+	}
 //#ifdef EPIAR_CAP_FRAME
 //	Uint32 ticksElapsed = SDL_GetTicks() - lastLoopTick;
 // Require a definition to activate frame cap (so we can check performance)
@@ -88,3 +125,28 @@ void Timer::IncrementFrameCount ( void )
 	++ logicalFrameCount;
 }
 
+/** \brief Stop following the wall clock.
+ *  \details From now on the time only moves forward by AdvanceVirtualClock,
+ *  so that a headless Simulation runs the same way no matter how fast the
+ *  machine is.  The virtual clock starts at zero.
+ */
+void Timer::UseVirtualClock( void )
+{
+	virtualClock = true;
+	virtualTicks = 0;
+	lastLoopTick = 0;
+}
+
+/** \brief Move the virtual clock forward.
+ */
+void Timer::AdvanceVirtualClock( Uint32 ms )
+{
+	virtualTicks += ms;
+}
+
+/** \brief The current time from either the wall clock or the virtual clock.
+ */
+Uint32 Timer::Now( void )
+{
+	return virtualClock ? virtualTicks : SDL_GetTicks();
+}
@@ -20,13 +20,23 @@ class Timer {
 		static void Delay( int waitMS );
 		static Uint32 GetTicks( void );
 		static Uint32 GetRealTicks( void );
+		static Uint64 GetNanoseconds( void );
 		
 		static float GetDelta( void );
 
 		static Uint32 GetLogicalFrameCount( void );
 		static void IncrementFrameCount ( void );
+
+		static void UseVirtualClock( void );
+		static void AdvanceVirtualClock( Uint32 ms );
+		static bool IsVirtualClock( void ) { return virtualClock; }
 	
   	private:
+		static Uint32 Now( void );
+
+		static bool virtualClock;     ///< Time only passes when AdvanceVirtualClock is called.
+		static Uint32 virtualTicks;   ///< The current time of the virtual clock.
+
   		static Uint32 lastLoopLength;
   		static Uint32 lastLoopTick;
 		static Uint32 ticksPerFrame;
@@ -11,7 +11,11 @@
 #include "Utilities/trig.h"
 
 /**\class Trig
- * \brief Trigonometry handling. */
+ * \brief Trigonometry handling.
+ * \details The sines and cosines of every tenth of a degree are kept in a
+ *          table.  They are shared by the whole degree lookups and by
+ *          GetSinCos, which the renderer uses to rotate Images.
+ */
 
 Trig *Trig::pInstance = 0;
 
@@ -21,9 +25,11 @@ Trig::Trig( void ) {
 	convdr = M_PI / 180.;
 	convrd = 180. / M_PI;
 
+	for( i = 0; i < TRIG_TABLE_SIZE; i++ ) {
+		cosTable[i] = cos( (double)i * 360. / TRIG_TABLE_SIZE * convdr );
+		sinTable[i] = sin( (double)i * 360. / TRIG_TABLE_SIZE * convdr );
+	}
 	for( i = -360; i < 360; i++ ) {
-		cosTable[i+360] = cos( (double)i * convdr );
-		sinTable[i+360] = sin( (double)i * convdr );
 		tanTable[i+360] = tan( (double)i * convdr );
 	}
 }
@@ -50,7 +56,7 @@ int Trig::RadToDeg( double i ) {
 }
 
 double Trig::GetCos( int ang ) {
-	return( cosTable[ang+360] );
+	return( cosTable[ ((ang % 360 + 360) % 360) * (TRIG_TABLE_SIZE / 360) ] );
 }
 
 double Trig::GetCos( double ang ) {
@@ -58,20 +64,33 @@ double Trig::GetCos( double ang ) {
 }
 
 double Trig::GetSin( int ang ) {
-	return( sinTable[ang+360] );
+	return( sinTable[ ((ang % 360 + 360) % 360) * (TRIG_TABLE_SIZE / 360) ] );
 }
 
 double Trig::GetSin( double ang ) {
 	return( sin(ang) );
 }
 
+// looks up the sine and cosine of ang (in radians) to the nearest tenth of a degree
+void Trig::GetSinCos( float ang, float *s, float *c ) {
+	int i = (int)floor( ang * (TRIG_TABLE_SIZE / (2. * M_PI)) + .5 ) % TRIG_TABLE_SIZE;
+	if( i < 0 ) {
+		i += TRIG_TABLE_SIZE;
+	}
+	*s = static_cast<float>( sinTable[i] );
+	*c = static_cast<float>( cosTable[i] );
+}
+
 // rotates point (x, y) about point (ax, ay) and sets nx, ny to new point
+// (y is mirrored, so this matches the screen, where y points down)
 void Trig::RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang ) {
-	float theta = atan2( y - ay, x - ax );
-	float dist = sqrt( ((x - ax)*(x-ax)) + ((y - ay)*(y-ay)) );
-	float ntheta = theta + ang;
+	float s, c;
+	float dx = x - ax;
+	float dy = y - ay;
+
+	GetSinCos( ang, &s, &c );
 
-	*nx = ax + (dist * cos( ntheta ) );
-	*ny = ay - (dist * sin( ntheta ) );
+	*nx = ax + (dx * c - dy * s);
+	*ny = ay - (dx * s + dy * c);
 }
 
@@ -9,6 +9,9 @@
 #ifndef __h_trig__
 #define __h_trig__
 
+/// The number of angles in the sine and cosine tables, a tenth of a degree apart.
+#define TRIG_TABLE_SIZE 3600
+
 class Trig {
 	public:
 		static Trig *Instance();
@@ -21,6 +24,7 @@ class Trig {
 		double GetCos( double ang );
 		double GetSin( int ang );
 		double GetSin( double ang );
+		void GetSinCos( float ang, float *s, float *c );
 
 		void RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang );
 
@@ -35,8 +39,8 @@ class Trig {
 		double convdr; // conversion factor from degrees to radians
 		double convrd; // conversion factor from radians to degrees
 
-		double sinTable[720];
-		double cosTable[720];
+		double sinTable[TRIG_TABLE_SIZE];
+		double cosTable[TRIG_TABLE_SIZE];
 		double tanTable[720];
 };
 
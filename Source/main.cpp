@@ -15,12 +15,16 @@
 #include "Tests/graphics.h"
 #include "Graphics/font.h"
 #include "Graphics/video.h"
+#include "Engine/simulation.h"
 #include "menu.h"
 #include "UI/ui.h"
 #include "Utilities/argparser.h"
 #include "Utilities/filesystem.h"
+#include "Utilities/jobs.h"
+#include "Utilities/loader.h"
 #include "Utilities/log.h"
 #include "Utilities/lua.h"
+#include "Utilities/random.h"
 #include "Utilities/xml.h"
 #include "Utilities/timer.h"
 
@@ -34,12 +38,18 @@ XMLFile *skinfile = NULL;
 Font *SansSerif = NULL, *BitType = NULL, *Serif = NULL, *Mono = NULL;
 ArgParser *argparser = NULL;
 
+// Headless Simulations (see Main_Headless)
+bool headless = false;
+Uint32 headlessTicks = 3000; // One minute of game time
+Uint32 headlessSeed = 0;
+
 void Main_OS                ( int argc, char **argv ); ///< Run OS Specific setup code
 void Main_Load_Settings     (); ///< Load the settings files
 void Main_Init_Singletons   (); ///< Initialize global Singletons
 void Main_Parse_Args        ( int argc, char **argv ); ///< Parse Command Line Arguments
 void Main_Log_Environment   ( void ); ///< Record Environment variables
 void Main_Close_Singletons  ( void ); ///< Close global Singletons
+int  Main_Headless          ( void ); ///< Run a Simulation without any Video, Audio or UI
 
 /**Main
  * \return 0 always
@@ -59,6 +69,10 @@ int main( int argc, char **argv ) {
 	Main_Parse_Args( argc, argv );
 	Main_Log_Environment();
 
+	if( headless ) {
+		return Main_Headless();
+	}
+
 	// THE GAME
 	Main_Init_Singletons();
 	Menu::Main_Menu();
@@ -132,6 +146,9 @@ void Main_Load_Settings() {
 	Options::AddDefault( "options/video/bpp", 32 );
 	Options::AddDefault( "options/video/fullscreen", 0 );
 	Options::AddDefault( "options/video/fps", 60 );
+	Options::AddDefault( "options/video/sprite-batch", 1 ); // Draw Images together rather than one at a time
+	Options::AddDefault( "options/video/texture-atlas", 2048 ); // Size of the textures small Images are packed into, 0 is disabled
+	Options::AddDefault( "options/video/rotate-shader", 1 ); // Rotate Images in a vertex shader when OpenGL 2.0 is available
 
 	// Sound
 	Options::AddDefault( "options/sound/musicvolume", 0.5f );
@@ -144,9 +161,23 @@ void Main_Load_Settings() {
 
 	// Simultaion
 	Options::AddDefault( "options/simulation/starfield-density", 750 );
+	Options::AddDefault( "options/simulation/starfield-layers", 8 ); // Stars in a layer scroll together
 	Options::AddDefault( "options/simulation/automatic-load", 0 );
 	Options::AddDefault( "options/simulation/random-universe", 0 );
 	Options::AddDefault( "options/simulation/random-seed", 0 );
+	Options::AddDefault( "options/simulation/flat-quadtree", 1 );
+	Options::AddDefault( "options/simulation/broadphase", "quadtree" ); // "quadtree" or "hash"
+	Options::AddDefault( "options/simulation/hash-cell-size", 512 );
+	Options::AddDefault( "options/simulation/threads", 0 ); // 0 uses one thread per processor
+	Options::AddDefault( "options/simulation/ai-active-distance", 2500 );
+	Options::AddDefault( "options/simulation/ai-near-distance", 10000 );
+	Options::AddDefault( "options/simulation/ai-near-interval", 4 );
+	Options::AddDefault( "options/simulation/ai-far-interval", 16 );
+	Options::AddDefault( "options/simulation/ai-budget", 5000 ); // Microseconds of AI decisions per tick, 0 is unlimited
+
+	// Loading
+	Options::AddDefault( "options/loading/threads", 1 ); // Threads that decode Images and Sounds, 0 loads them immediately
+	Options::AddDefault( "options/loading/upload-budget", 2048 ); // Kilobytes of textures to upload per frame
 
 	// Timing
 	Options::AddDefault( "options/timing/screen-swap", 0 ); // FIXME, 0=disabled until the transition is better
@@ -155,6 +186,12 @@ void Main_Load_Settings() {
 	Options::AddDefault( "options/timing/alert-drop", 3500 );
 	Options::AddDefault( "options/timing/alert-fade", 2500 );
 
+	// Lua
+	Options::AddDefault( "options/lua/gc-paced", 1 ); // Collect garbage between frames rather than during scripts
+	Options::AddDefault( "options/lua/gc-pause", 200 ); // Percent of memory growth before a new cycle begins
+	Options::AddDefault( "options/lua/gc-stepmul", 200 ); // Speed of collection relative to allocation, in percent
+	Options::AddDefault( "options/lua/gc-budget", 2000 ); // Most microseconds of collection per frame
+
 	// Development
 	Options::AddDefault( "options/development/ships-worldmap", 0 );
 	Options::AddDefault( "options/development/debug-ai", 0 );
@@ -217,7 +254,9 @@ void Main_Init_Singletons() {
 	Audio::Instance().SetSoundVol ( OPTION(float,"options/sound/soundvolume") );
 
 	Timer::Initialize();
+	Jobs::Initialize( OPTION(int, "options/simulation/threads") );
 	Video::Initialize();
+	Loader::Initialize( OPTION(int, "options/loading/threads"), OPTION(int, "options/loading/upload-budget") );
 
 	SansSerif       = new Font( "Resources/Fonts/FreeSans.ttf" );
 	BitType         = new Font( "Resources/Fonts/visitor2.ttf" );
@@ -227,6 +266,7 @@ void Main_Init_Singletons() {
 	UI::Initialize("Main Screen");
 
 	srand ( time(NULL) );
+	Random::Seed( static_cast<Uint32>( time(NULL) ) );
 }
 
 /** \details
@@ -243,6 +283,8 @@ void Main_Close_Singletons( void ) {
 	delete Serif;
 	delete Mono;
 
+	Loader::Shutdown();
+	Jobs::Shutdown();
 	Video::Shutdown();
 	Audio::Instance().Shutdown();
 
@@ -285,6 +327,10 @@ void Main_Parse_Args( int argc, char **argv ) {
 
 	argparser->SetOpt(LONGOPT, "restore-defaults", "Restore options to default values.");
 
+	argparser->SetOpt(LONGOPT, "headless",       "Run the default Simulation without a window, then print a hash of its state.");
+	argparser->SetOpt(VALUEOPT, "ticks",         "Number of logical frames for a headless run.");
+	argparser->SetOpt(VALUEOPT, "seed",          "Random seed for a headless run.");
+
 #ifdef EPIAR_COMPILE_TESTS
 	argparser->SetOpt(VALUEOPT, "run-test",      "Run specified test");
 #endif // EPIAR_COMPILE_TESTS
@@ -348,6 +394,13 @@ void Main_Parse_Args( int argc, char **argv ) {
 	if("" != msgfilt) Log::Instance().SetMsgFilter(msgfilt);
 	if("" != loglvl)  Log::Instance().SetLevel( loglvl );
 
+	headless = argparser->HaveOpt("headless");
+	headlessSeed = OPTION(Uint32, "options/simulation/random-seed");
+	string ticks = argparser->HaveValue("ticks");
+	string seed = argparser->HaveValue("seed");
+	if("" != ticks) headlessTicks = convertTo<Uint32>( ticks );
+	if("" != seed)  headlessSeed = convertTo<Uint32>( seed );
+
 	// Print unused options.
 	list<string> unused = argparser->GetUnused();
 	list<string>::iterator it;
@@ -377,3 +430,41 @@ void Main_Log_Environment( void ) {
 	LogMsg(INFO,"Executable Path: %s", argparser->GetPath().c_str() );
 }
 
+/** \details
+ *  This runs the default Simulation without a window, Audio, UI or Player,
+ *  for load and regression testing on machines without a display:
+ *   - Time comes from a virtual clock that moves one logical frame per tick.
+ *   - All randomness comes from Random, seeded with --seed.
+ *   - The Simulation stops after --ticks logical frames.
+ *
+ *  A hash of every Sprite is printed at the end.  Two runs with the same seed
+ *  and the same number of ticks must print the same hash.
+ *
+ *  \return 0 if the Simulation ran.
+ */
+int Main_Headless( void ) {
+	int retval = 0;
+
+	Timer::Initialize();
+	Timer::UseVirtualClock();
+	Jobs::Initialize( OPTION(int, "options/simulation/threads") );
+	Random::Seed( headlessSeed );
+
+	LogMsg(INFO, "Running headless with seed %u for %u ticks.", headlessSeed, headlessTicks );
+
+	Simulation simulation;
+	simulation.SetHeadless( true );
+	if( !simulation.Load( "default" ) || !simulation.SetupToRun() ) {
+		LogMsg(ERR, "Failed to setup the headless Simulation." );
+		retval = 1;
+	} else {
+		Uint32 stateHash = simulation.RunHeadless( headlessTicks );
+		printf("Seed %u, %u ticks, state hash %08X\n", headlessSeed, headlessTicks, stateHash );
+	}
+
+	Jobs::Shutdown();
+	Filesystem::Close();
+	Log::Instance().Close();
+
+	return retval;
+}